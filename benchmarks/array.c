@@ -0,0 +1,89 @@
+/**
+ * @brief Benchmark of bulk array reading and writing.
+ * @file array.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#include <string.h>
+
+#include "cosc.h"
+#include "benchmark.h"
+
+#define ITERATIONS 20000
+#define VALUES_N 256
+
+int main(int argc, char *argv[])
+{
+    static unsigned char buffer[VALUES_N * 8];
+    static cosc_float32 floats[VALUES_N];
+    static cosc_float64 doubles[VALUES_N];
+    static union cosc_value values[VALUES_N];
+    volatile cosc_int32 sink = 0;
+    clock_t start;
+
+    for (cosc_int32 i = 0; i < (cosc_int32)sizeof(buffer); i++)
+        buffer[i] = (i * 7 + 1) & 0x3f;
+    memcpy(floats, buffer, sizeof(floats));
+    memcpy(doubles, buffer, sizeof(doubles));
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            sink += cosc_write_float32(buffer + i * 4, 4, floats[i]);
+    benchmark_report("float32_write_scalar", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_float32_array(buffer, sizeof(buffer), floats, VALUES_N);
+    benchmark_report("float32_write_array", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            sink += cosc_read_float32(buffer + i * 4, 4, floats + i);
+    benchmark_report("float32_read_scalar", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_float32_array(buffer, sizeof(buffer), floats, VALUES_N);
+    benchmark_report("float32_read_array", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_float64_array(buffer, sizeof(buffer), doubles, VALUES_N);
+    benchmark_report("float64_write_array", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_float64_array(buffer, sizeof(buffer), doubles, VALUES_N);
+    benchmark_report("float64_read_array", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_values(buffer, VALUES_N * 4, ",[ffffffff]", 12, values, VALUES_N, 0, 1);
+    benchmark_report("float32_read_values", (long)ITERATIONS * VALUES_N, start);
+
+    return sink == 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @brief Shared timing and reporting for the benchmarks.
+ * @file benchmark.h
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#ifndef COSC_BENCHMARK_H
+#define COSC_BENCHMARK_H
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * The name of the benchmark executable, set by benchmarks.cmake so that
+ * results from different build variants can be told apart.
+ */
+#ifndef BENCHMARK_NAME
+#define BENCHMARK_NAME "benchmark"
+#endif
+
+/**
+ * Print a result line.
+ * @param name The name of the case.
+ * @param operations The number of operations timed.
+ * @param start The clock() value when timing started.
+ *
+ * The line is CSV formatted as
+ * `benchmark,case,operations,ns_per_op,ops_per_sec`. Anything else is
+ * printed to stderr to keep stdout valid CSV.
+ */
+static void benchmark_report(const char *name, long operations, clock_t start)
+{
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC;
+    double ns_per_op = operations > 0 ? ns / operations : 0.0;
+    printf("%s,%s,%ld,%.2f,%.0f\n", BENCHMARK_NAME, name, operations, ns_per_op, ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0);
+}
+
+#endif /* !COSC_BENCHMARK_H */
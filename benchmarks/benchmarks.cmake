@@ -0,0 +1,70 @@
+# cosc - benchmarks
+# Copyright 2025 Peter Gebauer
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files
+# (the "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+add_custom_target(benchmarks ALL)
+if(NOT COSC_BUILD_BENCHMARKS)
+    set_target_properties(benchmarks PROPERTIES EXCLUDE_FROM_ALL TRUE)
+endif()
+
+function(add_benchmark benchmark_name suffix flags)
+    set(executable_name benchmark_${benchmark_name}${suffix})
+    add_executable(${executable_name} ${CMAKE_CURRENT_SOURCE_DIR}/benchmarks/${benchmark_name}.c ${CMAKE_CURRENT_SOURCE_DIR}/cosc.c)
+    set_target_properties(
+        ${executable_name} PROPERTIES
+        EXCLUDE_FROM_ALL TRUE
+        )
+    target_compile_options(${executable_name} PUBLIC ${flags})
+    target_compile_definitions(${executable_name} PRIVATE BENCHMARK_NAME="${executable_name}")
+    add_dependencies(benchmarks ${executable_name})
+    set_property(GLOBAL APPEND PROPERTY COSC_BENCHMARK_EXECUTABLES $<TARGET_FILE:${executable_name}>)
+endfunction()
+
+add_benchmark(string "" "")
+add_benchmark(string "_noswar" "-DCOSC_NOSWAR")
+add_benchmark(array "" "")
+add_benchmark(array "_nosimd" "-DCOSC_NOSIMD")
+add_benchmark(values "" "")
+add_benchmark(codec "" "")
+add_benchmark(codec "_noswap" "-DCOSC_NOSWAP")
+add_benchmark(codec "_nobuiltin" "-DCOSC_NOBUILTIN")
+add_benchmark(codec "_noswar" "-DCOSC_NOSWAR")
+add_benchmark(codec "_nosimd" "-DCOSC_NOSIMD")
+add_benchmark(codec "_noint64" "-DCOSC_NOINT64")
+add_benchmark(codec "_nofloat" "-DCOSC_NOFLOAT32;-DCOSC_NOFLOAT64")
+add_benchmark(codec "_noarray" "-DCOSC_NOARRAY")
+add_benchmark(int64 "" "-DCOSC_NOINT64")
+add_benchmark(int64 "_nobuiltin" "-DCOSC_NOINT64;-DCOSC_NOBUILTIN")
+add_benchmark(inline "" "")
+add_benchmark(inline "_noswap" "-DCOSC_NOSWAP")
+add_benchmark(inline "_nobuiltin" "-DCOSC_NOBUILTIN")
+
+# Run every benchmark and collect the results in benchmarks.csv.
+get_property(benchmark_executables GLOBAL PROPERTY COSC_BENCHMARK_EXECUTABLES)
+add_custom_target(
+    run_benchmarks
+    COMMAND ${CMAKE_COMMAND}
+        "-DBENCHMARK_EXECUTABLES=${benchmark_executables}"
+        -DBENCHMARK_OUTPUT=${CMAKE_CURRENT_BINARY_DIR}/benchmarks.csv
+        -P ${CMAKE_CURRENT_SOURCE_DIR}/benchmarks/run_benchmarks.cmake
+    DEPENDS benchmarks
+    VERBATIM
+    )
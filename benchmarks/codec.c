@@ -0,0 +1,467 @@
+/**
+ * @brief Benchmark of the message, pattern and serial codec hot paths.
+ * @file codec.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cosc.h"
+#include "benchmark.h"
+
+#define ITERATIONS 200000
+#define FLOATS_N 256
+#define BLOB_SIZE 4096
+#define DEPTH 8
+#define BATCH_N 64
+
+static unsigned char buffer[BLOB_SIZE + 1024];
+static unsigned char blob[BLOB_SIZE];
+static char float_typetag[FLOATS_N + 2];
+static union cosc_value values[FLOATS_N];
+static volatile cosc_int32 sink = 0;
+
+/*
+ * One write and one read case for each message shape. A single operation
+ * is one complete message, so ops_per_sec is messages per second.
+ */
+static void bench_message(const char *name, const char *address, const char *typetag, cosc_int32 values_n)
+{
+    char label[64];
+    struct cosc_message message;
+    cosc_int32 size;
+    clock_t start;
+
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetag;
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = values_n;
+    size = cosc_write_message(buffer, sizeof(buffer), &message, 0, 0);
+    if (size < 0)
+    {
+        fprintf(stderr, "%s: %s failed with %d\n", BENCHMARK_NAME, name, (int)size);
+        return;
+    }
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_message(buffer, sizeof(buffer), &message, 0, 0);
+    snprintf(label, sizeof(label), "message_write_%s", name);
+    benchmark_report(label, ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        message.values.read = values;
+        sink += cosc_read_message(buffer, size, &message, 0, 0, 0);
+    }
+    snprintf(label, sizeof(label), "message_read_%s", name);
+    benchmark_report(label, ITERATIONS, start);
+}
+
+struct note
+{
+    cosc_int32 key;
+    cosc_float32 velocity;
+};
+
+/*
+ * The control message again, encoded from and decoded into a struct
+ * without the union cosc_value array.
+ */
+static void bench_bindings(void)
+{
+    static const struct cosc_binding bindings[2] = {
+        {'i', offsetof(struct note, key), -1},
+        {'f', offsetof(struct note, velocity), -1},
+    };
+    struct note note;
+    cosc_int32 size;
+    clock_t start;
+
+    note.key = 60;
+    note.velocity = (cosc_float32)0.5f;
+    size = cosc_write_message_from(buffer, sizeof(buffer), "/synth/1/note", COSC_SIZE_MAX, bindings, 2, &note, 0);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_message_from(buffer, sizeof(buffer), "/synth/1/note", COSC_SIZE_MAX, bindings, 2, &note, 0);
+    benchmark_report("message_write_control_bindings", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_message_into(buffer, size, 0, 0, bindings, 2, &note, 0);
+    benchmark_report("message_read_control_bindings", ITERATIONS, start);
+}
+
+/*
+ * Peek at the first and the last value of a message the way a router
+ * would, with a view instead of decoding every value.
+ */
+static void bench_view(const char *name, const char *address, const char *typetag, cosc_int32 values_n)
+{
+    char label[64];
+    struct cosc_message message;
+    struct cosc_message_view view;
+    struct cosc_message_arg args[4];
+    union cosc_value value;
+    cosc_int32 size;
+    clock_t start;
+
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetag;
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = values_n;
+    size = cosc_write_message(buffer, sizeof(buffer), &message, 0, 0);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        sink += cosc_message_view_setup(&view, buffer, size, args, 4, 0);
+        sink += cosc_message_view_get(&view, 0, 0, &value);
+    }
+    snprintf(label, sizeof(label), "message_view_first_%s", name);
+    benchmark_report(label, ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        sink += cosc_message_view_setup(&view, buffer, size, args, 4, 0);
+        sink += cosc_message_view_get(&view, values_n - 1, 0, &value);
+    }
+    snprintf(label, sizeof(label), "message_view_last_%s", name);
+    benchmark_report(label, ITERATIONS, start);
+}
+
+/*
+ * Forward a message under a new address prefix with one more value, the
+ * way a proxy would, without decoding the values.
+ */
+static void bench_edit(const char *name, const char *address, const char *typetag, cosc_int32 values_n)
+{
+    static unsigned char forward[sizeof(buffer) + 64];
+    char label[64];
+    struct cosc_message message;
+    struct cosc_message_edit edit;
+    union cosc_value id;
+    cosc_int32 size;
+    clock_t start;
+
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetag;
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = values_n;
+    size = cosc_write_message(buffer, sizeof(buffer), &message, 0, 0);
+
+    id.i = 1;
+    memset(&edit, 0, sizeof(edit));
+    edit.address_strip = 1;
+    edit.address_prefix = "/proxy/";
+    edit.address_prefix_n = COSC_SIZE_MAX;
+    edit.types = "i";
+    edit.types_n = 1;
+    edit.values = &id;
+    edit.values_n = 1;
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_edit_message(forward, sizeof(forward), buffer, size, &edit, -1);
+    snprintf(label, sizeof(label), "message_edit_%s", name);
+    benchmark_report(label, ITERATIONS, start);
+}
+
+#ifndef COSC_NOPATTERN
+
+static void bench_pattern(void)
+{
+    static const char *addresses[] = {
+        "/synth/12/freq",
+        "/mixer/channel/3/gain",
+        "/synth/7/cutoff",
+        "/transport/play",
+    };
+    static const char *patterns[] = {
+        "/synth/*/freq",
+        "/mixer/channel/[0-9]/{gain,pan}",
+        "/synth/?/cut*",
+        "/transport/stop",
+    };
+    clock_t start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < 4; i++)
+            sink += cosc_pattern_match(addresses[i], COSC_SIZE_MAX, patterns[i], COSC_SIZE_MAX);
+    benchmark_report("pattern_match", (long)ITERATIONS * 4, start);
+}
+
+#endif /* !COSC_NOPATTERN */
+
+#ifndef COSC_NOTIMETAG
+
+/*
+ * Timetag arithmetic, a single operation is one add, one diff and
+ * one compare.
+ */
+static void bench_timetag(void)
+{
+#ifdef COSC_NOINT64
+    cosc_uint64 timetag = COSC_64BITS_INIT(0xfffffff0, 0);
+    cosc_int64 step = COSC_64BITS_INIT(0, 1000003);
+#else
+    cosc_uint64 timetag = (cosc_uint64)0xfffffff0 << 32;
+    cosc_int64 step = 1000003;
+#endif
+    clock_t start;
+
+    start = clock();
+    for (cosc_int32 i = 0; i < ITERATIONS; i++)
+    {
+        cosc_uint64 next = cosc_timetag_add(timetag, step);
+        cosc_int64 nanos = cosc_timetag_diff(next, timetag);
+        sink += cosc_timetag_compare(next, timetag);
+#ifdef COSC_NOINT64
+        sink += (cosc_int32)COSC_64BITS_LO(&nanos);
+#else
+        sink += (cosc_int32)nanos;
+#endif
+        timetag = next;
+    }
+    benchmark_report("timetag_arithmetic", ITERATIONS, start);
+}
+
+#endif /* !COSC_NOTIMETAG */
+
+#ifndef COSC_NOSCHEDULER
+
+/*
+ * BATCH_N bundles with shuffled timetags added to a scheduler and popped
+ * in timetag order, a single operation is one add and one pop.
+ */
+static void bench_scheduler(void)
+{
+    static struct cosc_scheduled entries[BATCH_N];
+    struct cosc_scheduler scheduler;
+    struct cosc_scheduled entry;
+#ifdef COSC_NOINT64
+    cosc_uint64 now = COSC_64BITS_INIT(BATCH_N + 2, 0);
+#else
+    cosc_uint64 now = (cosc_uint64)(BATCH_N + 2) << 32;
+#endif
+    clock_t start;
+
+    cosc_scheduler_setup(&scheduler, entries, BATCH_N);
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS / BATCH_N; n++)
+    {
+        for (cosc_int32 i = 0; i < BATCH_N; i++)
+        {
+#ifdef COSC_NOINT64
+            cosc_uint64 timetag = COSC_64BITS_INIT((cosc_uint32)(i * 37) % BATCH_N + 2, 0);
+#else
+            cosc_uint64 timetag = ((cosc_uint64)((i * 37) % BATCH_N + 2)) << 32;
+#endif
+            cosc_scheduler_add(&scheduler, timetag, buffer, 16);
+        }
+        while (cosc_scheduler_pop(&scheduler, now, &entry))
+            sink += entry.size;
+    }
+    benchmark_report("scheduler_add_pop", ITERATIONS / BATCH_N * BATCH_N, start);
+}
+
+#endif /* !COSC_NOSCHEDULER */
+
+#if !defined(COSC_NOWRITER) && !defined(COSC_NOREADER)
+
+static cosc_int32 walk_count(const struct cosc_stream_event *event, void *context)
+{
+    (*(cosc_int32 *)context)++;
+    return 0;
+}
+
+/*
+ * A control message nested DEPTH bundles deep, written and read with the
+ * serial API.
+ */
+static void bench_serial(void)
+{
+    struct cosc_serial serial;
+    struct cosc_level levels[DEPTH + 2];
+    const char *address, *typetag;
+    cosc_int32 address_n, typetag_n, ivalue, size = 0;
+    cosc_float32 fvalue;
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    clock_t start;
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        cosc_writer_setup(&serial, buffer, sizeof(buffer), levels, DEPTH + 2, 0);
+        for (cosc_int32 i = 0; i < DEPTH; i++)
+            cosc_writer_start_bundle(&serial, timetag);
+        cosc_writer_start_message(&serial, "/synth/1/note", COSC_SIZE_MAX, ",if", COSC_SIZE_MAX);
+        cosc_writer_int32(&serial, 60);
+        cosc_writer_float32(&serial, 0.5f);
+        cosc_writer_end_message(&serial);
+        for (cosc_int32 i = 0; i < DEPTH; i++)
+            cosc_writer_end_bundle(&serial);
+        size = cosc_serial_get_size(&serial);
+        sink += size;
+    }
+    benchmark_report("serial_write_deep_bundle", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        cosc_reader_setup(&serial, buffer, size, levels, DEPTH + 2, 0);
+        for (cosc_int32 i = 0; i < DEPTH; i++)
+            cosc_reader_start_bundle(&serial, &timetag);
+        cosc_reader_start_message(&serial, &address, &address_n, &typetag, &typetag_n);
+        cosc_reader_int32(&serial, &ivalue);
+        cosc_reader_float32(&serial, &fvalue);
+        cosc_reader_end_message(&serial, 0);
+        for (cosc_int32 i = 0; i < DEPTH; i++)
+            cosc_reader_end_bundle(&serial);
+        sink += ivalue;
+    }
+    benchmark_report("serial_read_deep_bundle", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        cosc_int32 events = 0;
+        sink += cosc_walk(buffer, size, levels, DEPTH + 2, 0, walk_count, &events);
+        sink += events;
+    }
+    benchmark_report("walk_deep_bundle", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_packet_validate(buffer, size, 0, 0);
+    benchmark_report("packet_validate_deep_bundle", ITERATIONS, start);
+}
+
+/*
+ * A bundle of BATCH_N control messages written one at a time and as a
+ * batch, ops_per_sec is messages per second.
+ */
+static void bench_batch(void)
+{
+    static struct cosc_message messages[BATCH_N];
+    static union cosc_value batch_values[BATCH_N][2];
+    struct cosc_serial serial;
+    struct cosc_level levels[2];
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    clock_t start;
+
+    for (cosc_int32 i = 0; i < BATCH_N; i++)
+    {
+        batch_values[i][0].i = 60 + i;
+        batch_values[i][1].f = 0.5f;
+        messages[i].address = "/synth/1/note";
+        messages[i].address_n = COSC_SIZE_MAX;
+        messages[i].typetag = ",if";
+        messages[i].typetag_n = COSC_SIZE_MAX;
+        messages[i].values.write = batch_values[i];
+        messages[i].values_n = 2;
+    }
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS / BATCH_N; n++)
+    {
+        cosc_writer_setup(&serial, buffer, sizeof(buffer), levels, 2, 0);
+        cosc_writer_start_bundle(&serial, timetag);
+        for (cosc_int32 i = 0; i < BATCH_N; i++)
+            cosc_writer_message(&serial, messages + i, 0);
+        cosc_writer_end_bundle(&serial);
+        sink += cosc_serial_get_size(&serial);
+    }
+    benchmark_report("bundle_write_messages", ITERATIONS / BATCH_N * BATCH_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS / BATCH_N; n++)
+    {
+        cosc_writer_setup(&serial, buffer, sizeof(buffer), levels, 2, 0);
+        cosc_writer_start_bundle(&serial, timetag);
+        cosc_writer_messages(&serial, messages, BATCH_N, 0);
+        cosc_writer_end_bundle(&serial);
+        sink += cosc_serial_get_size(&serial);
+    }
+    benchmark_report("bundle_write_batch", ITERATIONS / BATCH_N * BATCH_N, start);
+}
+
+#endif /* !COSC_NOWRITER && !COSC_NOREADER */
+
+int main(int argc, char *argv[])
+{
+    float_typetag[0] = ',';
+    memset(float_typetag + 1, 'f', FLOATS_N);
+    for (cosc_int32 i = 0; i < FLOATS_N; i++)
+        values[i].f = (cosc_float32)i * 0.25f;
+    for (cosc_int32 i = 0; i < BLOB_SIZE; i++)
+        blob[i] = (unsigned char)i;
+
+    values[0].i = 60;
+    values[1].f = 0.5f;
+    bench_message("control", "/synth/1/note", ",if", 2);
+    bench_bindings();
+
+    for (cosc_int32 i = 0; i < FLOATS_N; i++)
+        values[i].f = (cosc_float32)i * 0.25f;
+    bench_message("floats", "/scope/samples", float_typetag, FLOATS_N);
+    bench_view("floats", "/scope/samples", float_typetag, FLOATS_N);
+
+    values[0].b.b = blob;
+    values[0].b.size = BLOB_SIZE;
+    bench_message("blob", "/file/chunk", ",b", 1);
+    bench_edit("blob", "/file/chunk", ",b", 1);
+
+#ifndef COSC_NOPATTERN
+    bench_pattern();
+#endif
+
+#ifndef COSC_NOTIMETAG
+    bench_timetag();
+#endif
+
+#ifndef COSC_NOSCHEDULER
+    bench_scheduler();
+#endif
+
+#if !defined(COSC_NOWRITER) && !defined(COSC_NOREADER)
+    bench_serial();
+    bench_batch();
+#endif
+
+    return sink == 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @brief Benchmark of exported versus inline scalar codecs.
+ * @file inline.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+
+#include "cosc_inline.h"
+#include "benchmark.h"
+
+#define ITERATIONS 20000
+#define VALUES_N 256
+
+int main(int argc, char *argv[])
+{
+    static unsigned char buffer[VALUES_N * 8];
+    static cosc_float32 floats[VALUES_N];
+    static cosc_int32 ints[VALUES_N];
+    volatile cosc_int32 sink = 0;
+    cosc_int32 offset;
+    clock_t start;
+
+    for (cosc_int32 i = 0; i < VALUES_N; i++)
+    {
+        floats[i] = (cosc_float32)i * 0.5f;
+        ints[i] = i * 3;
+    }
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_write_float32(buffer + offset, sizeof(buffer) - offset, floats[i]);
+        sink += offset;
+    }
+    benchmark_report("float32_write_exported", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_inline_write_float32(buffer + offset, sizeof(buffer) - offset, floats[i]);
+        sink += offset;
+    }
+    benchmark_report("float32_write_inline", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_read_float32(buffer + offset, sizeof(buffer) - offset, floats + i);
+        sink += offset;
+    }
+    benchmark_report("float32_read_exported", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_inline_read_float32(buffer + offset, sizeof(buffer) - offset, floats + i);
+        sink += offset;
+    }
+    benchmark_report("float32_read_inline", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_write_int32(buffer + offset, sizeof(buffer) - offset, ints[i]);
+        sink += offset;
+    }
+    benchmark_report("int32_write_exported", (long)ITERATIONS * VALUES_N, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+    {
+        offset = 0;
+        for (cosc_int32 i = 0; i < VALUES_N; i++)
+            offset += cosc_inline_write_int32(buffer + offset, sizeof(buffer) - offset, ints[i]);
+        sink += offset;
+    }
+    benchmark_report("int32_write_inline", (long)ITERATIONS * VALUES_N, start);
+
+    return sink == 0;
+}
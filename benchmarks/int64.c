@@ -0,0 +1,169 @@
+/**
+ * @brief Benchmark of the COSC_NOINT64 64-bit emulation used by timetags.
+ * @file int64.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#include "cosc.h"
+
+#if defined(COSC_NOINT64) && !defined(COSC_NOTIMETAG)
+
+#include "benchmark.h"
+
+#define ITERATIONS 1000000
+
+/*
+ * The previous implementation, 16-bit partial products and a bit-serial
+ * division, kept here as the baseline.
+ */
+static struct cosc_64bits reference_mul64(cosc_uint32 a, cosc_uint32 b)
+{
+    cosc_uint32 product[4];
+    cosc_uint32 factor_a[2] = {a & 0xffff, (a & 0xffff0000) >> 16};
+    cosc_uint32 factor_b[2] = {b & 0xffff, (b & 0xffff0000) >> 16};
+    product[0] = factor_a[0] * factor_b[0];
+    product[1] = (product[0] & 0xffff0000) >> 16;
+    product[0] &= 0xffff;
+    product[1] += factor_a[1] * factor_b[0];
+    product[2] = (product[1] & 0xffff0000) >> 16;
+    product[1] &= 0xffff;
+    product[1] += factor_a[0] * factor_b[1];
+    product[2] += (product[1] & 0xffff0000) >> 16;
+    product[1] &= 0xffff;
+    product[3] = (product[2] & 0xffff0000) >> 16;
+    product[2] &= 0xffff;
+    product[2] += factor_a[1] * factor_b[1];
+    product[3] += (product[2] & 0xffff0000) >> 16;
+    product[2] &= 0xffff;
+    product[3] &= 0xffff;
+    struct cosc_64bits res = COSC_64BITS_INIT((product[3] << 16) | product[2], (product[1] << 16) | product[0]);
+    return res;
+}
+
+static void reference_div64(struct cosc_64bits *dividend, cosc_uint32 divisor)
+{
+    struct cosc_64bits q = COSC_64BITS_INIT(0, 0);
+    struct cosc_64bits r = COSC_64BITS_INIT(0, 0);
+    for (cosc_int32 i = 63; i >= 0; i--)
+    {
+        COSC_64BITS_HI(&r) <<= 1;
+        COSC_64BITS_HI(&r) |= (COSC_64BITS_LO(&r) & 0x80000000) >> 31;
+        COSC_64BITS_LO(&r) <<= 1;
+        if (i < 32)
+            COSC_64BITS_LO(&r) |= (COSC_64BITS_LO(dividend) & (1U << i)) >> i;
+        else
+            COSC_64BITS_LO(&r) |= (COSC_64BITS_HI(dividend) & (1U << (i - 32))) >> (i - 32);
+        if (COSC_64BITS_LO(&r) >= divisor || COSC_64BITS_HI(&r) > 0)
+        {
+            if (COSC_64BITS_LO(&r) < divisor)
+                COSC_64BITS_HI(&r)--;
+            COSC_64BITS_LO(&r) -= divisor;
+            if (i < 32)
+                COSC_64BITS_LO(&q) |= 1U << i;
+            else
+                COSC_64BITS_HI(&q) |= 1U << (i - 32);
+        }
+    }
+    *dividend = q;
+}
+
+static void reference_add64(struct cosc_64bits *augend, cosc_uint32 addend)
+{
+    if (addend > 0xffffffff - COSC_64BITS_LO(augend))
+        COSC_64BITS_HI(augend)++;
+    COSC_64BITS_LO(augend) += addend;
+}
+
+static cosc_uint32 reference_timetag_to_time(cosc_uint64 timetag, cosc_uint32 *nanos)
+{
+    struct cosc_64bits tmp = reference_mul64(COSC_64BITS_LO(&timetag), 1000000000);
+    reference_add64(&tmp, 500000000);
+    *nanos = COSC_64BITS_HI(&tmp);
+    return COSC_64BITS_HI(&timetag);
+}
+
+static cosc_uint64 reference_time_to_timetag(cosc_uint32 seconds, cosc_uint32 nanos)
+{
+    seconds += nanos / 1000000000;
+    nanos %= 1000000000;
+    struct cosc_64bits res = COSC_64BITS_INIT(nanos, 0);
+    reference_add64(&res, 0x20000000);
+    reference_div64(&res, 1000000000);
+    COSC_64BITS_HI(&res) = seconds;
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    volatile cosc_uint32 sink = 0;
+    cosc_uint32 nanos;
+    clock_t start;
+
+    start = clock();
+    for (cosc_int32 i = 0; i < ITERATIONS; i++)
+    {
+        cosc_uint64 timetag = reference_time_to_timetag(i, (cosc_uint32)i * 997);
+        sink += COSC_64BITS_LO(&timetag);
+    }
+    benchmark_report("time_to_timetag_reference", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 i = 0; i < ITERATIONS; i++)
+    {
+        cosc_uint64 timetag = cosc_time_to_timetag(i, (cosc_uint32)i * 997);
+        sink += COSC_64BITS_LO(&timetag);
+    }
+    benchmark_report("time_to_timetag", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 i = 0; i < ITERATIONS; i++)
+    {
+        cosc_uint64 timetag = COSC_64BITS_INIT(i, (cosc_uint32)i * 2654435761U);
+        sink += reference_timetag_to_time(timetag, &nanos) + nanos;
+    }
+    benchmark_report("timetag_to_time_reference", ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 i = 0; i < ITERATIONS; i++)
+    {
+        cosc_uint64 timetag = COSC_64BITS_INIT(i, (cosc_uint32)i * 2654435761U);
+        sink += cosc_timetag_to_time(timetag, &nanos) + nanos;
+    }
+    benchmark_report("timetag_to_time", ITERATIONS, start);
+
+    return sink == 0;
+}
+
+#else /* COSC_NOINT64 && !COSC_NOTIMETAG */
+
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+    fprintf(stderr, "Built without COSC_NOINT64 or with COSC_NOTIMETAG, skipping benchmark.\n");
+    return 0;
+}
+
+#endif /* COSC_NOINT64 && !COSC_NOTIMETAG */
@@ -0,0 +1,40 @@
+# cosc - benchmarks
+# Copyright 2025 Peter Gebauer
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files
+# (the "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+# Runs each executable in BENCHMARK_EXECUTABLES and writes the combined
+# CSV output, with a header line, to BENCHMARK_OUTPUT.
+
+file(WRITE ${BENCHMARK_OUTPUT} "benchmark,case,operations,ns_per_op,ops_per_sec\n")
+foreach(executable ${BENCHMARK_EXECUTABLES})
+    execute_process(
+        COMMAND ${executable}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result
+        )
+    if(NOT result EQUAL 0)
+        message(WARNING "${executable} exited with ${result}")
+    endif()
+    file(APPEND ${BENCHMARK_OUTPUT} "${output}")
+    message(STATUS "${executable}")
+endforeach()
+message(STATUS "Results written to ${BENCHMARK_OUTPUT}")
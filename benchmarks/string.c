@@ -0,0 +1,79 @@
+/**
+ * @brief Benchmark of string reading and writing.
+ * @file string.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#include <string.h>
+
+#include "cosc.h"
+#include "benchmark.h"
+
+#define ITERATIONS 200000
+
+static const char *addresses[] = {
+    "/synth/1/freq",
+    "/mixer/channel/12/eq/band/3/gain",
+    "/transport/play",
+    "/sequencer/pattern/42/step/15/velocity",
+};
+
+int main(int argc, char *argv[])
+{
+    static unsigned char buffer[4096];
+    char value[256];
+    cosc_int32 offsets[16], count = 0, size = 0, ret;
+    volatile cosc_int32 sink = 0;
+    clock_t start;
+
+    for (cosc_int32 i = 0; i < 16; i++)
+    {
+        offsets[count++] = size;
+        ret = cosc_write_string(buffer + size, sizeof(buffer) - size, addresses[i % 4], 1024, 0);
+        if (ret < 0)
+            return 1;
+        size += ret;
+    }
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < count; i++)
+            sink += cosc_read_string(buffer + offsets[i], size - offsets[i], 0, 0, 0);
+    benchmark_report("string_scan", (long)ITERATIONS * count, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < count; i++)
+            sink += cosc_read_string(buffer + offsets[i], size - offsets[i], value, sizeof(value), 0);
+    benchmark_report("string_read", (long)ITERATIONS * count, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        for (cosc_int32 i = 0; i < count; i++)
+            sink += cosc_write_string(buffer + offsets[i], size - offsets[i], addresses[i % 4], 1024, 0);
+    benchmark_report("string_write", (long)ITERATIONS * count, start);
+
+    return sink == 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @brief Benchmark of values written and read with and without a typetag plan.
+ * @file values.c
+ *
+ * ```
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+
+#include <string.h>
+
+#include "cosc.h"
+#include "benchmark.h"
+
+#define ITERATIONS 1000000
+
+int main(int argc, char *argv[])
+{
+    static const char typetag[] = ",iiffffhs";
+    static unsigned char buffer[256];
+    struct cosc_plan_field fields[16];
+    struct cosc_typetag_plan plan;
+    union cosc_value values[8];
+    volatile cosc_int32 sink = 0;
+    clock_t start;
+
+    memset(values, 0, sizeof(values));
+    values[0].i = 1;
+    values[1].i = 2;
+    values[7].s.s = "note";
+    values[7].s.length = 4;
+    if (cosc_typetag_plan_compile(&plan, fields, 16, typetag, sizeof(typetag)) < 0)
+        return 1;
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_values(buffer, sizeof(buffer), typetag, sizeof(typetag), values, 8, 0);
+    benchmark_report("values_write", (long)ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_write_values_plan(buffer, sizeof(buffer), &plan, values, 8, 0);
+    benchmark_report("values_write_plan", (long)ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_values(buffer, sizeof(buffer), typetag, sizeof(typetag), values, 8, 0, 1);
+    benchmark_report("values_read", (long)ITERATIONS, start);
+
+    start = clock();
+    for (cosc_int32 n = 0; n < ITERATIONS; n++)
+        sink += cosc_read_values_plan(buffer, sizeof(buffer), &plan, values, 8, 0, 1);
+    benchmark_report("values_read_plan", (long)ITERATIONS, start);
+
+    return sink == 0;
+}
@@ -31,6 +31,20 @@ static void *cosc_memcpy(void *dest, const void *src, cosc_int32 n)
         ((unsigned char *)dest)[i] = ((const unsigned char *)src)[i];
     return dest;
 }
+static void *cosc_memmove(void *dest, const void *src, cosc_int32 n)
+{
+    if ((unsigned char *)dest < (const unsigned char *)src)
+    {
+        for (cosc_int32 i = 0; i < n; i++)
+            ((unsigned char *)dest)[i] = ((const unsigned char *)src)[i];
+    }
+    else if ((unsigned char *)dest > (const unsigned char *)src)
+    {
+        for (cosc_int32 i = n - 1; i >= 0; i--)
+            ((unsigned char *)dest)[i] = ((const unsigned char *)src)[i];
+    }
+    return dest;
+}
 static void *cosc_memset(void *s, int c, cosc_int32 n)
 {
     for (cosc_int32 i = 0; i < n; i++)
@@ -51,343 +65,718 @@ static cosc_int32 cosc_memcmp(const void *a, const void *b, cosc_int32 n)
 #elif defined(__cplusplus)
 #include <cstring>
 #define cosc_memcpy std::memcpy
+#define cosc_memmove std::memmove
 #define cosc_memset std::memset
 #define cosc_memcmp std::memcmp
 #else
 #include <string.h>
 #define cosc_memcpy memcpy
+#define cosc_memmove memmove
 #define cosc_memset memset
 #define cosc_memcmp memcmp
 #endif
 
-#define COSC_COPY32(dst, src) \
-    do { \
-        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[0]; \
-        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[1]; \
-        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[2]; \
-        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[3]; \
-    } while (0)
-#define COSC_COPY64(dst, src) \
-    do { \
-        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[0]; \
-        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[1]; \
-        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[2]; \
-        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[3]; \
-        ((unsigned char *)(dst))[4] = ((const unsigned char *)(src))[4]; \
-        ((unsigned char *)(dst))[5] = ((const unsigned char *)(src))[5]; \
-        ((unsigned char *)(dst))[6] = ((const unsigned char *)(src))[6]; \
-        ((unsigned char *)(dst))[7] = ((const unsigned char *)(src))[7]; \
-    } while (0)
-#define COSC_COPY64SWAP(dst, src) \
-    do { \
-        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[7]; \
-        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[6]; \
-        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[5]; \
-        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[4]; \
-        ((unsigned char *)(dst))[4] = ((const unsigned char *)(src))[3]; \
-        ((unsigned char *)(dst))[5] = ((const unsigned char *)(src))[2]; \
-        ((unsigned char *)(dst))[6] = ((const unsigned char *)(src))[1]; \
-        ((unsigned char *)(dst))[7] = ((const unsigned char *)(src))[0]; \
-    } while (0)
+#if !defined(COSC_NOSTDLIB) && !defined(COSC_NOSWAP) && !defined(COSC_NOSIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COSC_SIMD_AVX2
+#define COSC_SIMD_SSSE3
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define COSC_SIMD_SSSE3
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COSC_SIMD_SSE2
+#elif (defined(__ARM_NEON) || defined(_M_ARM64)) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define COSC_SIMD_NEON
+#endif
+#endif
 
-#if __cplusplus >= 202002L && !defined(COSC_NOSTDLIB)
-#include <bit>
-#define COSC_PUN(type_in_, type_out_, value_) (std::bit_cast<type_out_>((type_in_)(value_)))
-#elif defined(__cplusplus)
-template <typename IN, typename OUT>
-inline OUT cosc_pun(IN in) { OUT out; cosc_memcpy(&out, &in, sizeof(out)); return out; }
-#define COSC_PUN(type_in_, type_out_, value_) cosc_pun<type_in_, type_out_>((type_in_)(value_))
+#ifndef COSC_NORING
+#if defined(__GNUC__) || defined(__clang__)
+#define COSC_ATOMIC_LOAD(ptr_) __atomic_load_n((ptr_), __ATOMIC_ACQUIRE)
+#define COSC_ATOMIC_STORE(ptr_, value_) __atomic_store_n((ptr_), (value_), __ATOMIC_RELEASE)
+#define COSC_ATOMIC_CAS(ptr_, expected_, desired_) __atomic_compare_exchange_n((ptr_), &(expected_), (desired_), 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#elif __cplusplus >= 202002L && !defined(COSC_NOSTDLIB)
+#include <atomic>
+#define COSC_ATOMIC_LOAD(ptr_) std::atomic_ref<cosc_uint32>(*(ptr_)).load(std::memory_order_acquire)
+#define COSC_ATOMIC_STORE(ptr_, value_) std::atomic_ref<cosc_uint32>(*(ptr_)).store((value_), std::memory_order_release)
+#define COSC_ATOMIC_CAS(ptr_, expected_, desired_) std::atomic_ref<cosc_uint32>(*(ptr_)).compare_exchange_weak((expected_), (desired_), std::memory_order_acq_rel, std::memory_order_acquire)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define COSC_ATOMIC_LOAD(ptr_) ((cosc_uint32)_InterlockedOr((volatile long *)(ptr_), 0))
+#define COSC_ATOMIC_STORE(ptr_, value_) ((void)_InterlockedExchange((volatile long *)(ptr_), (long)(value_)))
+#define COSC_ATOMIC_CAS(ptr_, expected_, desired_) (_InterlockedCompareExchange((volatile long *)(ptr_), (long)(desired_), (long)(expected_)) == (long)(expected_))
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define COSC_ATOMIC_LOAD(ptr_) atomic_load_explicit((_Atomic cosc_uint32 *)(ptr_), memory_order_acquire)
+#define COSC_ATOMIC_STORE(ptr_, value_) atomic_store_explicit((_Atomic cosc_uint32 *)(ptr_), (value_), memory_order_release)
+#define COSC_ATOMIC_CAS(ptr_, expected_, desired_) atomic_compare_exchange_weak_explicit((_Atomic cosc_uint32 *)(ptr_), &(expected_), (desired_), memory_order_acq_rel, memory_order_acquire)
 #else
-#define COSC_PUN(type_in_, type_out_, value_) (((union { type_in_ in; type_out_ out; }){.in=(value_)}).out)
+#define COSC_NORING
+#endif
 #endif
 
-inline static void cosc_store_uint32(
-    void *buffer,
-    cosc_uint32 value
-)
-{
-#ifdef COSC_NOSWAP
-    COSC_COPY32(buffer, &value);
+/*
+ * An unsigned integer wide enough for a pointer, used to check the
+ * alignment of the ring storage.
+ */
+#ifndef COSC_NORING
+#if !defined(COSC_NOSTDINT) && defined(UINTPTR_MAX)
+#define COSC_UINTPTR uintptr_t
+#elif defined(__UINTPTR_TYPE__)
+#define COSC_UINTPTR __UINTPTR_TYPE__
+#elif !defined(COSC_NOSTDLIB)
+#define COSC_UINTPTR size_t
 #else
-    ((unsigned char *)(buffer))[0] = ((value) & 0xff000000) >> 24;
-    ((unsigned char *)(buffer))[1] = ((value) & 0xff0000) >> 16;
-    ((unsigned char *)(buffer))[2] = ((value) & 0xff00) >> 8;
-    ((unsigned char *)(buffer))[3] = (value) & 0xff;
+#define COSC_UINTPTR unsigned long
 #endif
-}
+#endif
+
+#include "cosc_inline.h"
 
-inline static cosc_uint32 cosc_load_uint32(
-    const void *buffer
+/*
+ * Swap the byte order of n 32-bit words from src to dst, which is the
+ * same as storing native words as big endian or loading big endian
+ * words as native. The vector paths are only compiled for little
+ * endian targets.
+ */
+static void cosc_swap32_n(
+    void *dst,
+    const void *src,
+    cosc_int32 n
 )
 {
-#ifdef COSC_NOSWAP
-    cosc_uint32 tmp;
-    COSC_COPY32(&tmp, buffer);
-    return tmp;
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+#ifdef COSC_NATIVE_ORDER
+    if (d != s)
+        cosc_memcpy(d, s, n * 4);
 #else
-    return (
-        ((cosc_uint32)((const unsigned char *)(buffer))[0] << 24)
-        | ((cosc_uint32)((const unsigned char *)(buffer))[1] << 16)
-        | ((cosc_uint32)((const unsigned char *)(buffer))[2] << 8)
-        | ((cosc_uint32)((const unsigned char *)(buffer))[3])
+    cosc_int32 i = 0;
+#ifdef COSC_SIMD_AVX2
+    const __m256i mask256 = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
     );
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i *)(d + i * 4), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(s + i * 4)), mask256));
+#endif
+#if defined(COSC_SIMD_SSSE3)
+    const __m128i mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i *)(d + i * 4), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s + i * 4)), mask));
+#elif defined(COSC_SIMD_SSE2)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i * 4));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i *)(d + i * 4), v);
+    }
+#elif defined(COSC_SIMD_NEON)
+    for (; i + 4 <= n; i += 4)
+        vst1q_u8(d + i * 4, vrev32q_u8(vld1q_u8(s + i * 4)));
+#endif
+    for (; i < n; i++)
+    {
+        cosc_uint32 tmp;
+        COSC_COPY32(&tmp, s + i * 4);
+        cosc_store_uint32(d + i * 4, tmp);
+    }
 #endif
 }
 
-inline static void cosc_store_int32(
-    void *buffer,
-    cosc_int32 value
-)
-{
-    cosc_store_uint32(buffer, COSC_PUN(cosc_int32, cosc_uint32, value));
-}
-
-inline static cosc_int32 cosc_load_int32(
-    const void *buffer
-)
-{
-    return COSC_PUN(cosc_uint32, cosc_int32, cosc_load_uint32(buffer));
-}
+#if !defined(COSC_NOINT64) || !defined(COSC_NOFLOAT64)
 
-inline static void cosc_store_uint64(
-    void *buffer,
-    cosc_uint64 value
+/*
+ * Swap the byte order of n 64-bit words from src to dst.
+ */
+static void cosc_swap64_n(
+    void *dst,
+    const void *src,
+    cosc_int32 n
 )
 {
-#ifdef COSC_NOSWAP
-    COSC_COPY64(buffer, &value);
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+#ifdef COSC_NATIVE_ORDER
+    if (d != s)
+        cosc_memcpy(d, s, n * 8);
 #else
+    cosc_int32 i = 0;
+#ifdef COSC_SIMD_AVX2
+    const __m256i mask256 = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+    );
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_si256((__m256i *)(d + i * 8), _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(s + i * 8)), mask256));
+#endif
+#if defined(COSC_SIMD_SSSE3)
+    const __m128i mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_si128((__m128i *)(d + i * 8), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s + i * 8)), mask));
+#elif defined(COSC_SIMD_SSE2)
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i * 8));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128((__m128i *)(d + i * 8), v);
+    }
+#elif defined(COSC_SIMD_NEON)
+    for (; i + 2 <= n; i += 2)
+        vst1q_u8(d + i * 8, vrev64q_u8(vld1q_u8(s + i * 8)));
+#endif
 #ifdef COSC_NOINT64
-    cosc_store_uint32(buffer, COSC_64BITS_HI(&value));
-    cosc_store_uint32((char *)buffer + 4, COSC_64BITS_LO(&value));
+    if (COSC_HOST_BIG_ENDIAN())
+    {
+        if (d != s)
+            cosc_memcpy(d + i * 8, s + i * 8, (n - i) * 8);
+        return;
+    }
+    for (; i < n; i++)
+    {
+        unsigned char tmp[8];
+        COSC_COPY64SWAP(tmp, s + i * 8);
+        COSC_COPY64(d + i * 8, tmp);
+    }
 #else
-    ((unsigned char *)buffer)[0] = (value & 0xff00000000000000ULL) >> 56;
-    ((unsigned char *)buffer)[1] = (value & 0xff000000000000ULL) >> 48;
-    ((unsigned char *)buffer)[2] = (value & 0xff0000000000ULL) >> 40;
-    ((unsigned char *)buffer)[3] = (value & 0xff00000000ULL) >> 32;
-    ((unsigned char *)buffer)[4] = (value & 0xff000000) >> 24;
-    ((unsigned char *)buffer)[5] = (value & 0xff0000) >> 16;
-    ((unsigned char *)buffer)[6] = (value & 0xff00) >> 8;
-    ((unsigned char *)buffer)[7] = value & 0xff;
+    for (; i < n; i++)
+    {
+        cosc_uint64 tmp;
+        COSC_COPY64(&tmp, s + i * 8);
+        cosc_store_uint64(d + i * 8, tmp);
+    }
 #endif
 #endif
 }
 
-inline static cosc_uint64 cosc_load_uint64(
-    const void *buffer
+#endif /* !COSC_NOINT64 || !COSC_NOFLOAT64 */
+
+/*
+ * Swap the byte order of n values of a fixed size numeric type,
+ * types that are emulated by struct cosc_64bits are swapped as
+ * pairs of 32-bit words.
+ */
+static void cosc_swap_n(
+    void *dst,
+    const void *src,
+    cosc_int32 type,
+    cosc_int32 n
 )
 {
-#ifdef COSC_NOSWAP
-    cosc_uint64 tmp;
-    COSC_COPY64(&tmp, buffer);
-    return tmp;
-#else
+    switch (type)
+    {
+    case 'i':
+    case 'r':
+    case 'f':
+        cosc_swap32_n(dst, src, n);
+        break;
+    case 'h':
+    case 't':
 #ifdef COSC_NOINT64
-    struct cosc_64bits tmp = COSC_64BITS_INIT(cosc_load_uint32(buffer), cosc_load_uint32((char *)buffer + 4));
-    return tmp;
+        cosc_swap32_n(dst, src, n * 2);
 #else
-    return (
-        ((cosc_uint64)((const unsigned char *)buffer)[0] << 56)
-        | ((cosc_uint64)((const unsigned char *)buffer)[1] << 48)
-        | ((cosc_uint64)((const unsigned char *)buffer)[2] << 40)
-        | ((cosc_uint64)((const unsigned char *)buffer)[3] << 32)
-        | ((cosc_uint64)((const unsigned char *)buffer)[4] << 24)
-        | ((cosc_uint64)((const unsigned char *)buffer)[5] << 16)
-        | ((cosc_uint64)((const unsigned char *)buffer)[6] << 8)
-        | ((cosc_uint64)((const unsigned char *)buffer)[7])
-    );
+        cosc_swap64_n(dst, src, n);
 #endif
+        break;
+    case 'd':
+#ifdef COSC_NOFLOAT64
+        cosc_swap32_n(dst, src, n * 2);
+#else
+        cosc_swap64_n(dst, src, n);
 #endif
+        break;
+    }
 }
 
-#if defined(COSC_NOINT64) || defined(COSC_NOTIMETAG)
+#if defined(COSC_NOINT64) && !defined(COSC_NOTIMETAG)
+
+#if !defined(COSC_NOBUILTIN) && (defined(__GNUC__) || defined(__clang__))
+#define COSC_MUL32X64(a_, b_, hi_, lo_) do { \
+        __extension__ unsigned long long product_ = (unsigned long long)(a_) * (b_); \
+        (hi_) = (cosc_uint32)(product_ >> 32); \
+        (lo_) = (cosc_uint32)product_; \
+    } while (0)
+#elif !defined(COSC_NOBUILTIN) && defined(_MSC_VER)
+#include <intrin.h>
+#define COSC_MUL32X64(a_, b_, hi_, lo_) do { \
+        unsigned __int64 product_ = __emulu((a_), (b_)); \
+        (hi_) = (cosc_uint32)(product_ >> 32); \
+        (lo_) = (cosc_uint32)product_; \
+    } while (0)
+#endif
 
+/*
+ * 32x32 to 64-bit multiplication, a single instruction on most 32-bit
+ * targets when the compiler can widen, otherwise four 16-bit partial
+ * products.
+ */
 static struct cosc_64bits cosc_mul64(
     cosc_uint32 a,
     cosc_uint32 b
 )
 {
-    cosc_uint32 product[4];
-    cosc_uint32 factor_a[2] = {
-        a & 0xffff,
-        (a & 0xffff0000) >> 16
-    };
-    cosc_uint32 factor_b[2] = {
-        b & 0xffff,
-        (b & 0xffff0000) >> 16
-    };
-    product[0] = factor_a[0] * factor_b[0];
-    product[1] = (product[0] & 0xffff0000) >> 16;
-    product[0] &= 0xffff;
-
-    product[1] += factor_a[1] * factor_b[0];
-    product[2] = (product[1] & 0xffff0000) >> 16;
-    product[1] &= 0xffff;
-
-    product[1] += factor_a[0] * factor_b[1];
-    product[2] += (product[1] & 0xffff0000) >> 16;
-    product[1] &= 0xffff;
-    product[3] = (product[2] & 0xffff0000) >> 16;
-    product[2] &= 0xffff;
-
-    product[2] += factor_a[1] * factor_b[1];
-    product[3] += (product[2] & 0xffff0000) >> 16;
-    product[2] &= 0xffff;
-    product[3] &= 0xffff;
-
-    struct cosc_64bits res = COSC_64BITS_INIT(
-        (product[3] << 16) | product[2],
-        (product[1] << 16) | product[0]
-    );
+    struct cosc_64bits res;
+#ifdef COSC_MUL32X64
+    COSC_MUL32X64(a, b, COSC_64BITS_HI(&res), COSC_64BITS_LO(&res));
+#else
+    cosc_uint32 a_lo = a & 0xffff, a_hi = a >> 16;
+    cosc_uint32 b_lo = b & 0xffff, b_hi = b >> 16;
+    cosc_uint32 lo = a_lo * b_lo;
+    cosc_uint32 mid_a = a_hi * b_lo;
+    cosc_uint32 mid_b = a_lo * b_hi;
+    cosc_uint32 hi = a_hi * b_hi;
+    // The middle sum can carry out of 32 bits, into bit 16 of hi.
+    cosc_uint32 mid = mid_a + (lo >> 16);
+    mid += mid_b;
+    if (mid < mid_b)
+        hi += 0x10000;
+    COSC_64BITS_HI(&res) = hi + (mid >> 16);
+    COSC_64BITS_LO(&res) = (mid << 16) | (lo & 0xffff);
+#endif
     return res;
 }
 
-static void cosc_div64(struct cosc_64bits *dividend, cosc_uint32 divisor)
+static void cosc_add64(struct cosc_64bits *augend, cosc_uint32 addend)
 {
-    struct cosc_64bits q = COSC_64BITS_INIT(0, 0);
-    struct cosc_64bits r = COSC_64BITS_INIT(0, 0);
-    if (divisor > 0)
+    COSC_64BITS_LO(augend) += addend;
+    if (COSC_64BITS_LO(augend) < addend)
+        COSC_64BITS_HI(augend)++;
+}
+
+/*
+ * Divide by 10^9 with the reciprocal floor(2^64 / 10^9) = 4 * 2^32 + K1.
+ * The estimate is at most one short of the quotient, the remainder fits
+ * 32 bits so a single 32-bit multiply decides the correction.
+ */
+static void cosc_div64_1e9(struct cosc_64bits *dividend)
+{
+    cosc_uint32 xh = COSC_64BITS_HI(dividend), xl = COSC_64BITS_LO(dividend);
+    struct cosc_64bits sum = cosc_mul64(xh, 1266874889U);
+    struct cosc_64bits tmp = cosc_mul64(xl, 1266874889U);
+    cosc_uint32 qh, ql;
+    // sum = xh * K1 + 4 * xl + (xl * K1) / 2^32, q = 4 * xh + sum / 2^32.
+    cosc_add64(&sum, COSC_64BITS_HI(&tmp));
+    cosc_add64(&sum, xl << 2);
+    COSC_64BITS_HI(&sum) += xl >> 30;
+    qh = xh >> 30;
+    ql = (xh << 2) + COSC_64BITS_HI(&sum);
+    if (ql < COSC_64BITS_HI(&sum))
+        qh++;
+    if (xl - ql * 1000000000U >= 1000000000U)
     {
-        for (cosc_int32 i = 63; i >= 0; i--)
-        {
-            COSC_64BITS_HI(&r) <<= 1;
-            COSC_64BITS_HI(&r) |= (COSC_64BITS_LO(&r) & 0x80000000) >> 31;
-            COSC_64BITS_LO(&r) <<= 1;
-            if (i < 32)
-                COSC_64BITS_LO(&r) |= (COSC_64BITS_LO(dividend) & (1U << i)) >> i;
-            else
-                COSC_64BITS_LO(&r) |= (COSC_64BITS_HI(dividend) & (1U << (i - 32))) >> (i - 32);
-            if (COSC_64BITS_LO(&r) >= divisor || COSC_64BITS_HI(&r) > 0)
-            {
-                if (COSC_64BITS_LO(&r) < divisor)
-                    COSC_64BITS_HI(&r)--;
-                COSC_64BITS_LO(&r) -= divisor;
-                if (i < 32)
-                    COSC_64BITS_LO(&q) |= 1U << i;
-                else
-                    COSC_64BITS_HI(&q) |= 1U << (i - 32);
-            }
-        }
+        ql++;
+        if (ql == 0)
+            qh++;
     }
-    *dividend = q;
+    COSC_64BITS_SET(dividend, qh, ql);
 }
 
-static void cosc_add64(struct cosc_64bits *augend, cosc_uint32 addend)
+static void cosc_addto64(struct cosc_64bits *augend, const struct cosc_64bits *addend)
 {
-    if (addend > 0xffffffff - COSC_64BITS_LO(augend))
-        COSC_64BITS_HI(augend)++;
-    COSC_64BITS_LO(augend) += addend;
+    COSC_64BITS_LO(augend) += COSC_64BITS_LO(addend);
+    COSC_64BITS_HI(augend) += COSC_64BITS_HI(addend) + (COSC_64BITS_LO(augend) < COSC_64BITS_LO(addend));
+}
+
+static void cosc_subfrom64(struct cosc_64bits *minuend, const struct cosc_64bits *subtrahend)
+{
+    COSC_64BITS_HI(minuend) -= COSC_64BITS_HI(subtrahend) + (COSC_64BITS_LO(minuend) < COSC_64BITS_LO(subtrahend));
+    COSC_64BITS_LO(minuend) -= COSC_64BITS_LO(subtrahend);
 }
 
-#endif /* COSC_NOINT64 || COSC_NOTIMETAG */
+static void cosc_neg64(struct cosc_64bits *value)
+{
+    COSC_64BITS_HI(value) = ~COSC_64BITS_HI(value) + (COSC_64BITS_LO(value) == 0);
+    COSC_64BITS_LO(value) = 0 - COSC_64BITS_LO(value);
+}
+
+#endif /* COSC_NOINT64 && !COSC_NOTIMETAG */
 
 #ifndef COSC_NOPATTERN
 
-static cosc_int32 cosc_strncmp(const char *a, cosc_int32 a_n, const char *b, cosc_int32 b_n)
+static cosc_int32 cosc_pattern_skip(
+    const char *s,
+    cosc_int32 s_n,
+    cosc_int32 offset,
+    cosc_int32 is_typetag
+)
 {
-    if (a_n <= 0 && b_n <= 0)
-        return 0;
-    if (a_n <= 0 && b_n > 0 && *b != 0)
+#ifndef COSC_NOARRAY
+    if (is_typetag)
+    {
+        while (offset < s_n && (s[offset] == '[' || s[offset] == ']'))
+            offset++;
+    }
+#endif
+    return offset;
+}
+
+static cosc_int32 cosc_pattern_chars(
+    const char *chars,
+    cosc_int32 chars_n,
+    const char *s,
+    cosc_int32 s_n,
+    cosc_int32 offset,
+    cosc_int32 is_typetag
+)
+{
+    for (cosc_int32 i = 0; i < chars_n; i++)
+    {
+        offset = cosc_pattern_skip(s, s_n, offset, is_typetag);
+        if (offset >= s_n || s[offset] != chars[i])
+            return -1;
+        offset++;
+    }
+    return offset;
+}
+
+static cosc_int32 cosc_pattern_step(
+    const struct cosc_pattern_op *op,
+    const char *s,
+    cosc_int32 s_n,
+    cosc_int32 offset,
+    cosc_int32 is_typetag
+)
+{
+    char c;
+    if (op->type == COSC_PATTERN_OP_LITERAL)
+        return cosc_pattern_chars(op->s, op->n, s, s_n, offset, is_typetag);
+    if (op->type == COSC_PATTERN_OP_STRINGSET && op->s)
+    {
+        cosc_int32 start = 0, end;
+        for (;;)
+        {
+            end = start;
+            while (end < op->n && op->s[end] != ',')
+                end++;
+            cosc_int32 ret = cosc_pattern_chars(op->s + start, end - start, s, s_n, offset, is_typetag);
+            if (ret >= 0)
+                return ret;
+            if (end >= op->n)
+                return -1;
+            start = end + 1;
+        }
+    }
+    if (op->type == COSC_PATTERN_OP_STRINGSET)
+    {
+        for (cosc_int32 i = 1; i <= op->n; i++)
+        {
+            cosc_int32 ret = cosc_pattern_chars(op[i].s, op[i].n, s, s_n, offset, is_typetag);
+            if (ret >= 0)
+                return ret;
+        }
         return -1;
-    if (b_n <= 0 && a_n > 0 && *a != 0)
+    }
+    if (op->type == COSC_PATTERN_OP_COMMA && is_typetag)
+        return offset;
+    c = offset < s_n ? s[offset] : 0;
+    if (!c)
         return -1;
-    for (cosc_int32 i = 0; i < a_n && i < b_n; i++)
+    switch (op->type)
     {
-        if (a[i] < b[i])
+    case COSC_PATTERN_OP_COMMA:
+        return c == ',' ? offset + 1 : -1;
+    case COSC_PATTERN_OP_ANY:
+        return offset + 1;
+    case COSC_PATTERN_OP_NUMERIC:
+        if (is_typetag)
+        {
+            switch (c)
+            {
+            case 'i':
+            case 'r':
+            case 'f':
+            case 'h':
+            case 't':
+            case 'd':
+                return offset + 1;
+            }
             return -1;
-        else if (a[i] > b[i])
-            return 1;
-        if (a[i] == 0)
-            break;
+        }
+        return c >= '0' && c <= '9' ? offset + 1 : -1;
+    case COSC_PATTERN_OP_BOOL:
+        if (is_typetag)
+            return c == 'T' || c == 'F' ? offset + 1 : -1;
+        return c == 'B' ? offset + 1 : -1;
+    case COSC_PATTERN_OP_CHARSET:
+        if (op->s)
+        {
+            for (cosc_int32 i = 0; i < op->n; i++)
+            {
+                if (op->s[i] == c)
+                    return offset + 1;
+            }
+            return op->n == 0 ? offset + 1 : -1;
+        }
+        if (op->set[(unsigned char)c >> 5] & ((cosc_uint32)1 << ((unsigned char)c & 31)))
+            return offset + 1;
+        return -1;
     }
-    return 0;
+    return -1;
 }
 
-static cosc_int32 cosc_charset_match(
-    char character,
-    const char *charset,
-    cosc_int32 charset_n,
-    cosc_int32 *forward
+/*
+ * Decode the operation at p_offset of a pattern, character and string
+ * sets are decoded with s and n set to the text between the brackets.
+ * Returns the offset of the next operation or a negative error code.
+ */
+static cosc_int32 cosc_pattern_decode(
+    const char *pattern,
+    cosc_int32 pattern_n,
+    cosc_int32 p_offset,
+    struct cosc_pattern_op *op
 )
 {
-    cosc_int32 len = 0;
-    if (charset_n < 2 || charset[len] != '[' || !character)
+    char c = pattern[p_offset];
+    cosc_int32 end = p_offset;
+    if (c == '[' || c == '{')
     {
-        if (forward)
-            *forward = len;
-        return 0;
+        end++;
+        while (end < pattern_n && pattern[end] != 0 && pattern[end] != (c == '[' ? ']' : '}'))
+            end++;
+        if (end >= pattern_n || pattern[end] == 0)
+            return COSC_EINVAL;
     }
-    len++;
-    cosc_int32 found = -1;
-    while (len < charset_n && charset[len] != 0 && charset[len] != ']')
+    if (c == '[' || c == '{')
     {
-        if (charset[len] == character)
-            found = len;
-        len++;
+        op->type = c == '[' ? COSC_PATTERN_OP_CHARSET : COSC_PATTERN_OP_STRINGSET;
+        op->n = end - p_offset - 1;
+        op->s = pattern + p_offset + 1;
+        return end + 1;
     }
-    if (len < charset_n && charset[len] == ']'
-        && (found >= 0 || charset[len - 1] == '['))
+    if (c == '*' || c == '?' || c == '#' || c == 'B' || (c == ',' && p_offset == 0))
     {
-        len++;
-        if (forward)
-            *forward = len;
-        return 1;
+        op->type = c;
+        op->n = 0;
+        op->s = 0;
+        p_offset++;
+        if (c == '*')
+        {
+            while (p_offset < pattern_n && pattern[p_offset] == '*')
+                p_offset++;
+        }
+        return p_offset;
     }
-    if (forward)
-        *forward = len;
-    return 0;
+    while (end < pattern_n && pattern[end] != 0 && pattern[end] != '*'
+           && pattern[end] != '?' && pattern[end] != '#' && pattern[end] != 'B'
+           && pattern[end] != '[' && pattern[end] != '{')
+        end++;
+    if (end == p_offset)
+        end++;
+    op->type = COSC_PATTERN_OP_LITERAL;
+    op->n = end - p_offset;
+    op->s = pattern + p_offset;
+    return end;
+}
+
+/*
+ * Match with compiled operations, or if ops is NULL with operations
+ * decoded from the pattern as they are reached. The index is an
+ * operation index or a pattern offset.
+ */
+static cosc_int32 cosc_pattern_run(
+    const struct cosc_pattern_op *ops,
+    cosc_int32 ops_n,
+    const char *pattern,
+    cosc_int32 pattern_n,
+    const char *s,
+    cosc_int32 s_n
+)
+{
+    struct cosc_pattern_op decoded;
+    const struct cosc_pattern_op *op = 0;
+    cosc_int32 i = 0, offset = 0, star = -1, star_offset = 0, is_typetag = 0, next, i_next = 0, done;
+    if (s_n > 0 && *s == ',')
+    {
+        is_typetag = 1;
+        offset++;
+    }
+    for (;;)
+    {
+        offset = cosc_pattern_skip(s, s_n, offset, is_typetag);
+        done = ops ? i >= ops_n : i >= pattern_n || pattern[i] == 0;
+        if (!done)
+        {
+            if (ops)
+            {
+                op = ops + i;
+                i_next = i + (op->type == COSC_PATTERN_OP_STRINGSET ? op->n + 1 : 1);
+            }
+            else
+            {
+                i_next = cosc_pattern_decode(pattern, pattern_n, i, &decoded);
+                if (i_next < 0)
+                    return 0;
+                op = &decoded;
+            }
+            if (op->type == COSC_PATTERN_OP_STAR)
+            {
+                star = i = i_next;
+                star_offset = offset;
+                if (ops ? star >= ops_n : star >= pattern_n || pattern[star] == 0)
+                    return 1;
+                continue;
+            }
+        }
+        if (done)
+        {
+            if (offset >= s_n || s[offset] == 0)
+                return 1;
+            next = -1;
+        }
+        else
+        {
+            // A literal after a star can only start at its first character.
+            if (i == star && op->type == COSC_PATTERN_OP_LITERAL && !is_typetag)
+            {
+                while (offset < s_n && s[offset] != 0 && s[offset] != op->s[0])
+                    offset++;
+                star_offset = offset;
+            }
+            next = cosc_pattern_step(op, s, s_n, offset, is_typetag);
+        }
+        if (next >= 0)
+        {
+            offset = next;
+            i = i_next;
+            continue;
+        }
+        if (star < 0 || star_offset >= s_n || s[star_offset] == 0)
+            return 0;
+        star_offset = cosc_pattern_skip(s, s_n, star_offset + 1, is_typetag);
+        offset = star_offset;
+        i = star;
+    }
+}
+
+static cosc_uint32 cosc_dispatch_hash(
+    cosc_int32 parent,
+    const char *s,
+    cosc_int32 s_n
+)
+{
+    cosc_uint32 hash = ((cosc_uint32)2166136261 ^ (cosc_uint32)parent) * 16777619;
+    for (cosc_int32 i = 0; i < s_n; i++)
+        hash = (hash ^ (unsigned char)s[i]) * 16777619;
+    return hash;
 }
 
-static cosc_int32 cosc_stringset_match(
+static cosc_int32 cosc_dispatch_lookup(
+    const struct cosc_dispatch *dispatch,
+    cosc_int32 parent,
     const char *s,
     cosc_int32 s_n,
-    const char *stringset,
-    cosc_int32 stringset_n,
-    cosc_int32 *forward,
-    cosc_int32 *s_forward
+    cosc_uint32 hash,
+    cosc_int32 *slot
 )
 {
-    cosc_int32 len = 0, slen = 0;
-    if (stringset_n < 2 || stringset[len] != '{')
+    cosc_int32 mask = dispatch->table_size - 1, index;
+    for (cosc_int32 i = 0; i < dispatch->table_size; i++)
     {
-        if (forward)
-            *forward = 0;
-        if (s_forward)
-            *s_forward = 0;
-        return 0;
+        *slot = (cosc_int32)((hash + (cosc_uint32)i) & (cosc_uint32)mask);
+        index = dispatch->table[*slot];
+        if (index < 0)
+            return -1;
+        if (dispatch->nodes[index].hash == hash
+            && dispatch->nodes[index].parent == parent
+            && dispatch->nodes[index].n == s_n
+            && cosc_memcmp(dispatch->nodes[index].s, s, s_n) == 0)
+            return index;
     }
-    len++;
-    while (len < stringset_n && stringset[len] != 0 && stringset[len] != '}')
+    *slot = -1;
+    return -1;
+}
+
+static cosc_int32 cosc_dispatch_add_node(
+    struct cosc_dispatch *dispatch,
+    cosc_int32 type,
+    cosc_int32 parent,
+    const char *s,
+    cosc_int32 s_n
+)
+{
+    struct cosc_dispatch_node *node;
+    if (dispatch->node_count >= dispatch->node_max)
+        return COSC_EOVERRUN;
+    node = dispatch->nodes + dispatch->node_count;
+    node->type = type;
+    node->s = s;
+    node->n = s_n;
+    node->parent = parent;
+    node->hash = 0;
+    node->ops = -1;
+    node->ops_n = 0;
+    node->patterns = -1;
+    node->handlers = -1;
+    node->next = -1;
+    node->id = 0;
+    return dispatch->node_count++;
+}
+
+static cosc_int32 cosc_dispatch_add_ops(
+    struct cosc_dispatch *dispatch,
+    cosc_int32 node,
+    const char *pattern,
+    cosc_int32 pattern_n
+)
+{
+    cosc_int32 ops_n;
+    if (!dispatch->ops)
+        return COSC_EOVERRUN;
+    ops_n = cosc_pattern_compile(
+        dispatch->ops + dispatch->op_count,
+        dispatch->op_max - dispatch->op_count,
+        pattern, pattern_n
+    );
+    if (ops_n < 0)
+        return ops_n;
+    dispatch->nodes[node].ops = dispatch->op_count;
+    dispatch->nodes[node].ops_n = ops_n;
+    dispatch->op_count += ops_n;
+    return 0;
+}
+
+static cosc_int32 cosc_dispatch_next(
+    const struct cosc_dispatch *dispatch,
+    cosc_int32 parent,
+    cosc_int32 child,
+    const char *s,
+    cosc_int32 s_n
+)
+{
+    const struct cosc_dispatch_node *node;
+    if (child < 0)
     {
-        cosc_int32 end = len;
-        while (end < stringset_n && stringset[end] != 0 && stringset[end] != '}' && stringset[end] != ',')
-            end++;
-        slen = end - len;
-        if (cosc_strncmp(stringset + len, slen, s, s_n) == 0)
+        cosc_int32 slot;
+        if (dispatch->table_size > 0)
         {
-            len = end;
-            while (len < stringset_n && stringset[len] != 0 && stringset[len] != '}')
-                len++;
-            break;
+            child = cosc_dispatch_lookup(
+                dispatch, parent, s, s_n,
+                cosc_dispatch_hash(parent, s, s_n), &slot
+            );
+            if (child >= 0)
+                return child;
         }
-        else
-            slen = 0;
-        len = end + 1;
+        child = dispatch->nodes[parent].patterns;
     }
-    if (len < stringset_n && stringset[len] == '}')
+    else if (dispatch->nodes[child].type == COSC_DISPATCH_NODE_LITERAL)
+        child = dispatch->nodes[parent].patterns;
+    else
+        child = dispatch->nodes[child].next;
+    while (child >= 0)
     {
-        len++;
-        if (forward)
-            *forward = len;
-        if (s_forward)
-            *s_forward = slen;
-        return 1;
+        node = dispatch->nodes + child;
+        if (cosc_pattern_exec(dispatch->ops + node->ops, node->ops_n, s, s_n))
+            return child;
+        child = node->next;
     }
-    if (forward)
-        *forward = len;
-    if (s_forward)
-        *s_forward = 0;
-    return 0;
+    return -1;
 }
 
 #endif /* !COSC_NOPATTERN */
@@ -431,6 +820,46 @@ static cosc_int32 cosc_type_is_valid(
     return 0;
 }
 
+static cosc_int32 cosc_string_length(
+    const unsigned char *s,
+    cosc_int32 s_n
+)
+{
+    cosc_int32 len = 0;
+#ifndef COSC_NOSWAR
+#ifndef COSC_NOINT64
+    cosc_uint64 word;
+    while (len <= s_n - 8)
+    {
+#ifdef COSC_NOSTDLIB
+        COSC_COPY64(&word, s + len);
+#else
+        cosc_memcpy(&word, s + len, 8);
+#endif
+        if ((word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL)
+            break;
+        len += 8;
+    }
+#else
+    cosc_uint32 word;
+    while (len <= s_n - 4)
+    {
+#ifdef COSC_NOSTDLIB
+        COSC_COPY32(&word, s + len);
+#else
+        cosc_memcpy(&word, s + len, 4);
+#endif
+        if ((word - 0x01010101) & ~word & 0x80808080)
+            break;
+        len += 4;
+    }
+#endif
+#endif /* !COSC_NOSWAR */
+    while (len < s_n && s[len] != 0)
+        len++;
+    return len;
+}
+
 static cosc_int32 cosc_type_is_payload(char type)
 {
     switch (type)
@@ -451,7 +880,299 @@ static cosc_int32 cosc_type_is_payload(char type)
     return 0;
 }
 
-//
+#ifndef COSC_NOARRAY
+
+/*
+ * If the array body starting at types[start] is a run of one fixed
+ * size numeric type terminated by ']' return the length of the run
+ * and store the size of the type in width, otherwise return 0.
+ */
+static cosc_int32 cosc_array_run(
+    const char *types,
+    cosc_int32 types_n,
+    cosc_int32 start,
+    cosc_int32 *width
+)
+{
+    if (start >= types_n)
+        return 0;
+    switch (types[start])
+    {
+    case 'i':
+    case 'r':
+    case 'f':
+        *width = 4;
+        break;
+    case 'h':
+    case 't':
+    case 'd':
+        *width = 8;
+        break;
+    default:
+        return 0;
+    }
+    cosc_int32 end = start;
+    while (end < types_n && types[end] == types[start])
+        end++;
+    if (end >= types_n || types[end] != ']')
+        return 0;
+    return end - start;
+}
+
+/*
+ * Write n values of a fixed size numeric type, values past values_n
+ * are written as zero. The union stride rules out vector loads so
+ * this is a plain loop without the per value type switch.
+ */
+static void cosc_write_values_run(
+    unsigned char *buffer,
+    char type,
+    const union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 n
+)
+{
+    cosc_int32 i = 0, width = 4;
+    if (!values || values_n < 0)
+        values_n = 0;
+    if (values_n > n)
+        values_n = n;
+    switch (type)
+    {
+    case 'i':
+        for (; i < values_n; i++)
+            cosc_store_int32(buffer + i * 4, values[i].i);
+        break;
+    case 'r':
+        for (; i < values_n; i++)
+            cosc_store_uint32(buffer + i * 4, values[i].r);
+        break;
+    case 'f':
+        for (; i < values_n; i++)
+            cosc_store_uint32(buffer + i * 4, COSC_PUN(cosc_float32, cosc_uint32, values[i].f));
+        break;
+    case 'h':
+        for (width = 8; i < values_n; i++)
+            cosc_store_uint64(buffer + i * 8, COSC_PUN(cosc_int64, cosc_uint64, values[i].h));
+        break;
+    case 't':
+        for (width = 8; i < values_n; i++)
+            cosc_store_uint64(buffer + i * 8, values[i].t);
+        break;
+    case 'd':
+        for (width = 8; i < values_n; i++)
+            cosc_write_float64(buffer + i * 8, 8, values[i].d);
+        break;
+    }
+    cosc_memset(buffer + i * width, 0, (n - i) * width);
+}
+
+/*
+ * Read n values of a fixed size numeric type.
+ */
+static void cosc_read_values_run(
+    const unsigned char *buffer,
+    char type,
+    union cosc_value *values,
+    cosc_int32 n
+)
+{
+    cosc_int32 i = 0;
+    switch (type)
+    {
+    case 'i':
+        for (; i < n; i++)
+            values[i].i = cosc_load_int32(buffer + i * 4);
+        break;
+    case 'r':
+        for (; i < n; i++)
+            values[i].r = cosc_load_uint32(buffer + i * 4);
+        break;
+    case 'f':
+        for (; i < n; i++)
+            values[i].f = COSC_PUN(cosc_uint32, cosc_float32, cosc_load_uint32(buffer + i * 4));
+        break;
+    case 'h':
+        for (; i < n; i++)
+            values[i].h = COSC_PUN(cosc_uint64, cosc_int64, cosc_load_uint64(buffer + i * 8));
+        break;
+    case 't':
+        for (; i < n; i++)
+            values[i].t = cosc_load_uint64(buffer + i * 8);
+        break;
+    case 'd':
+        for (; i < n; i++)
+            cosc_read_float64(buffer + i * 8, 8, &values[i].d);
+        break;
+    }
+}
+
+#endif /* !COSC_NOARRAY */
+
+/*
+ * Store a fixed size plan field, a NULL value is stored as zero.
+ */
+static void cosc_plan_store(
+    unsigned char *buffer,
+    const struct cosc_plan_field *field,
+    const union cosc_value *value
+)
+{
+    if (!value)
+    {
+        cosc_memset(buffer, 0, field->size);
+        return;
+    }
+    switch (field->type)
+    {
+    case 'i': cosc_store_int32(buffer, value->i); break;
+    case 'r': cosc_store_uint32(buffer, value->r); break;
+    case 'f': cosc_store_uint32(buffer, COSC_PUN(cosc_float32, cosc_uint32, value->f)); break;
+    case 'c': cosc_write_char(buffer, 4, value->c); break;
+    case 'm': cosc_write_midi(buffer, 4, value->m); break;
+    case 'h': cosc_store_uint64(buffer, COSC_PUN(cosc_int64, cosc_uint64, value->h)); break;
+    case 't': cosc_store_uint64(buffer, value->t); break;
+    case 'd': cosc_write_float64(buffer, 8, value->d); break;
+    }
+}
+
+/*
+ * Load a fixed size plan field.
+ */
+static void cosc_plan_load(
+    const unsigned char *buffer,
+    const struct cosc_plan_field *field,
+    union cosc_value *value
+)
+{
+    switch (field->type)
+    {
+    case 'i': value->i = cosc_load_int32(buffer); break;
+    case 'r': value->r = cosc_load_uint32(buffer); break;
+    case 'f': value->f = COSC_PUN(cosc_uint32, cosc_float32, cosc_load_uint32(buffer)); break;
+    case 'c': cosc_read_char(buffer, 4, &value->c); break;
+    case 'm': cosc_read_midi(buffer, 4, value->m); break;
+    case 'h': value->h = COSC_PUN(cosc_uint64, cosc_int64, cosc_load_uint64(buffer)); break;
+    case 't': value->t = cosc_load_uint64(buffer); break;
+    case 'd': cosc_read_float64(buffer, 8, &value->d); break;
+    default: cosc_memset(value, 0, sizeof(*value)); break;
+    }
+}
+
+/*
+ * The number of array repetitions cosc_write_values() makes once vlen
+ * values are written, the first repetition is always made.
+ */
+static cosc_int32 cosc_plan_reps(
+    const struct cosc_typetag_plan *plan,
+    cosc_int32 vlen,
+    cosc_int32 values_n
+)
+{
+    if (vlen >= values_n || plan->array_value_count <= 0)
+        return 1;
+    return (values_n - vlen - 1) / plan->array_value_count + 1;
+}
+
+/*
+ * Write the plan fields from start to end. Each run of fixed size
+ * fields is bounds checked once, if the run does not fit it is
+ * written value by value to fail at the same value as
+ * cosc_write_values().
+ */
+static cosc_int32 cosc_plan_write_fields(
+    unsigned char *buffer,
+    cosc_int32 size,
+    const struct cosc_plan_field *fields,
+    cosc_int32 start,
+    cosc_int32 end,
+    const union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *vlen
+)
+{
+    cosc_int32 req = 0, i = start, sz;
+    while (i < end)
+    {
+        if (fields[i].size < 0 || (buffer && fields[i].run > size - req))
+        {
+            do
+            {
+                sz = cosc_write_value(buffer ? buffer + req : 0, size - req, (char)fields[i].type, values && *vlen < values_n ? values + *vlen : 0);
+                if (sz < 0)
+                    return sz;
+                if (sz > COSC_SIZE_MAX - req)
+                    return COSC_EOVERRUN;
+                req += sz;
+                if (sz > 0)
+                    (*vlen)++;
+                i++;
+            } while (i < end && fields[i - 1].size >= 0 && fields[i].size >= 0);
+            continue;
+        }
+        if (fields[i].run > COSC_SIZE_MAX - req)
+            return COSC_EOVERRUN;
+        sz = fields[i].run;
+        for (; i < end && fields[i].size >= 0; i++)
+        {
+            if (fields[i].size == 0)
+                continue;
+            if (buffer)
+                cosc_plan_store(buffer + req + fields[i].offset, fields + i, values && *vlen < values_n ? values + *vlen : 0);
+            (*vlen)++;
+        }
+        req += sz;
+    }
+    return req;
+}
+
+/*
+ * Read the plan fields from start to end, see cosc_plan_write_fields().
+ */
+static cosc_int32 cosc_plan_read_fields(
+    const unsigned char *buffer,
+    cosc_int32 size,
+    const struct cosc_plan_field *fields,
+    cosc_int32 start,
+    cosc_int32 end,
+    union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *vlen
+)
+{
+    cosc_int32 req = 0, i = start, sz;
+    while (i < end)
+    {
+        if (fields[i].size < 0 || fields[i].run > size - req)
+        {
+            do
+            {
+                sz = cosc_read_value(buffer + req, size - req, (char)fields[i].type, values && *vlen < values_n ? values + *vlen : 0);
+                if (sz < 0)
+                    return sz;
+                if (sz > COSC_SIZE_MAX - req)
+                    return COSC_EOVERRUN;
+                req += sz;
+                if (sz > 0)
+                    (*vlen)++;
+                i++;
+            } while (i < end && fields[i - 1].size >= 0 && fields[i].size >= 0);
+            continue;
+        }
+        sz = fields[i].run;
+        for (; i < end && fields[i].size >= 0; i++)
+        {
+            if (values && *vlen < values_n)
+                cosc_plan_load(buffer + req + fields[i].offset, fields + i, values + *vlen);
+            if (fields[i].size > 0)
+                (*vlen)++;
+        }
+        req += sz;
+    }
+    return req;
+}
+
+//
 // Public below.
 //
 
@@ -484,7 +1205,7 @@ cosc_int32 cosc_feature_float64(void)
 
 cosc_int32 cosc_feature_swap(void)
 {
-#ifdef COSC_NOSWAP
+#ifdef COSC_NATIVE_ORDER
     return 0;
 #else
     return 1;
@@ -545,10 +1266,32 @@ cosc_int32 cosc_feature_reader(void)
 #endif
 }
 
+cosc_int32 cosc_feature_ring(void)
+{
+#ifdef COSC_NORING
+    return 0;
+#else
+    return 1;
+#endif
+}
+
+cosc_int32 cosc_feature_scheduler(void)
+{
+#ifdef COSC_NOSCHEDULER
+    return 0;
+#else
+    return 1;
+#endif
+}
+
 cosc_int32 cosc_big_endian(void)
 {
+#ifdef COSC_BIG_ENDIAN
+    return COSC_BIG_ENDIAN;
+#else
     const cosc_uint32 u = 1;
     return ((const unsigned char *)&u)[3];
+#endif
 }
 
 cosc_int32 cosc_address_char_validate(
@@ -805,131 +1548,7 @@ cosc_int32 cosc_pattern_match(
     cosc_int32 pattern_n
 )
 {
-    cosc_int32 s_offset = 0, p_offset = 0, slen, plen;
-    char is_typetag;
-    if ((s_n <= 0 || *s == 0) && (pattern_n <= 0 || *pattern == 0))
-        return 1;
-    if (s_n > 0 && *s == ',')
-    {
-        is_typetag = 1;
-        s_offset++;
-    }
-    else
-        is_typetag = 0;
-    if (pattern_n > 0 && *pattern == ',' && is_typetag)
-        p_offset++;
-    while (
-        s_offset < s_n && s[s_offset] != 0
-        && p_offset < pattern_n && pattern[p_offset] != 0)
-    {
-#ifndef COSC_NOARRAY
-        if (is_typetag && (s[s_offset] == '[' || s[s_offset] == ']'))
-        {
-            s_offset++;
-            continue;
-        }
-#endif
-        if (pattern[p_offset] == '?')
-        {
-            p_offset++;
-            s_offset++;
-        }
-        else if (pattern[p_offset] == '#')
-        {
-            if (is_typetag)
-            {
-                switch (s[s_offset])
-                {
-                case 'i':
-                case 'r':
-                case 'f':
-                case 'h':
-                case 't':
-                case 'd':
-                    break;
-                default:
-                    return 0;
-                }
-            }
-            else if (s[s_offset] < '0' || s[s_offset] > '9')
-                return 0;
-            p_offset++;
-            s_offset++;
-        }
-        else if (pattern[p_offset] == 'B')
-        {
-            if (!is_typetag || (s[s_offset] != 'T' && s[s_offset] != 'F'))
-                return 0;
-            p_offset++;
-            s_offset++;
-        }
-        else if (pattern[p_offset] == '*')
-        {
-            while (p_offset < pattern_n && pattern[p_offset] == '*')
-                p_offset++;
-            if (p_offset >= pattern_n || pattern[p_offset] == 0)
-                return 1;
-            while (s_offset < s_n && s[s_offset] != 0 && s[s_offset] != pattern[p_offset])
-                s_offset++;
-            if (s_offset >= s_n || s[s_offset] != pattern[p_offset])
-                return 0;
-            p_offset++;
-            s_offset++;
-        }
-        else if (pattern[p_offset] == '[')
-        {
-            if (!cosc_charset_match(s[s_offset], pattern + p_offset, pattern_n - p_offset, &plen))
-                return 0;
-            s_offset++;
-            p_offset += plen;
-        }
-        else if (pattern[p_offset] == '{')
-        {
-            if (!cosc_stringset_match(s + s_offset, s_n - s_offset,  pattern + p_offset, pattern_n - p_offset, &plen, &slen))
-                return 0;
-            s_offset += slen;
-            p_offset += plen;
-        }
-        else if (s[s_offset] == pattern[p_offset])
-        {
-            p_offset++;
-            s_offset++;
-        }
-        else
-            return 0;
-    }
-#ifndef COSC_NOARRAY
-    if (s_offset < s_n && s[s_offset] == ']')
-        s_offset++;
-#endif
-
-    while (p_offset < pattern_n)
-    {
-        if (pattern[p_offset] == '*')
-            p_offset++;
-        else if (pattern[p_offset] == '[')
-        {
-            if (!cosc_charset_match(0, pattern + p_offset, pattern_n - p_offset, &plen))
-                return 0;
-            p_offset += plen;
-        }
-        else if (pattern[p_offset] == '{')
-        {
-            if (!cosc_stringset_match("", 0,  pattern + p_offset, pattern_n - p_offset, &plen, &slen))
-                return 0;
-            s_offset += slen;
-            p_offset += plen;
-        }
-        else if (pattern[p_offset] == 0)
-            break;
-        else
-            return 0;
-    }
-
-    if ((s_offset >= s_n || s[s_offset] == 0)
-        && (p_offset >= pattern_n || pattern[p_offset] == 0))
-        return 1;
-    return 0;
+    return cosc_pattern_run(0, 0, pattern, pattern_n, s, s_n);
 }
 
 cosc_int32 cosc_signature_match(
@@ -963,1067 +1582,2637 @@ cosc_int32 cosc_signature_match(
     return 0;
 }
 
-#endif /* COSC_NOPATTERN */
-
-#ifndef COSC_NOTIMETAG
-
-cosc_uint32 cosc_timetag_to_time(
-    cosc_uint64 timetag,
-    cosc_uint32 *nanos
+cosc_int32 cosc_pattern_compile(
+    struct cosc_pattern_op *ops,
+    cosc_int32 ops_max,
+    const char *pattern,
+    cosc_int32 pattern_n
 )
 {
-#ifdef COSC_NOINT64
-    if (nanos)
-    {
-        struct cosc_64bits tmp = cosc_mul64(COSC_64BITS_LO(&timetag), 1000000000);
-        cosc_add64(&tmp, 500000000);
-        *nanos = COSC_64BITS_HI(&tmp); // Same as >> 32.
-    }
-    return COSC_64BITS_HI(&timetag);
-#else
-    if (nanos)
+    cosc_int32 p_offset = 0, count = 0, next;
+    struct cosc_pattern_op counted, *op;
+    while (p_offset < pattern_n && pattern[p_offset] != 0)
     {
-        cosc_uint64 tmp = timetag & 0xffffffff;
-        tmp *= 1000000000;
-        tmp += 500000000;
-        tmp >>= 32;
-        *nanos = tmp;
+        if (ops && count >= ops_max)
+            return COSC_EOVERRUN;
+        op = ops ? ops + count : &counted;
+        next = cosc_pattern_decode(pattern, pattern_n, p_offset, op);
+        if (next < 0)
+            return next;
+        count++;
+        if (op->type == COSC_PATTERN_OP_CHARSET)
+        {
+            for (cosc_int32 i = 0; i < 8; i++)
+                op->set[i] = op->n == 0 ? 0xffffffff : 0;
+            op->set[0] &= ~(cosc_uint32)1;
+            for (cosc_int32 i = 0; i < op->n; i++)
+                op->set[(unsigned char)op->s[i] >> 5] |= (cosc_uint32)1 << ((unsigned char)op->s[i] & 31);
+            op->n = 0;
+            op->s = 0;
+        }
+        else if (op->type == COSC_PATTERN_OP_STRINGSET)
+        {
+            const char *alt = op->s;
+            cosc_int32 alt_n = op->n, start = 0, end, alternatives = 0;
+            for (;;)
+            {
+                end = start;
+                while (end < alt_n && alt[end] != ',')
+                    end++;
+                if (ops && count + alternatives >= ops_max)
+                    return COSC_EOVERRUN;
+                if (ops)
+                {
+                    ops[count + alternatives].type = COSC_PATTERN_OP_ALTERNATIVE;
+                    ops[count + alternatives].n = end - start;
+                    ops[count + alternatives].s = alt + start;
+                }
+                alternatives++;
+                start = end + 1;
+                if (end >= alt_n)
+                    break;
+            }
+            op->n = alternatives;
+            op->s = 0;
+            count += alternatives;
+        }
+        p_offset = next;
     }
-    return (timetag & 0xffffffff00000000ULL) >> 32;
-#endif
+    return count;
 }
 
-cosc_uint64 cosc_time_to_timetag(
-    cosc_uint32 seconds,
-    cosc_uint32 nanos
+cosc_int32 cosc_pattern_exec(
+    const struct cosc_pattern_op *ops,
+    cosc_int32 ops_n,
+    const char *s,
+    cosc_int32 s_n
 )
 {
-    seconds += nanos / 1000000000;
-    nanos %= 1000000000;
-#ifdef COSC_NOINT64
-    struct cosc_64bits res = COSC_64BITS_INIT(nanos, 0);
-    cosc_add64(&res, 0x20000000);
-    cosc_div64(&res, 1000000000);
-    COSC_64BITS_HI(&res) = seconds;
-    return res;
-#else
-    cosc_uint64 tmp = nanos;
-    tmp <<= 32;
-    tmp += 0x20000000;
-    tmp /= 1000000000;
-    tmp |= (cosc_uint64)seconds << 32;
-    return tmp;
-#endif
+    return cosc_pattern_run(ops, ops_n, 0, 0, s, s_n);
 }
 
-#endif /* !COSC_NOTIMETAG */
-
-#ifndef COSC_NOFLTCONV
+cosc_int32 cosc_dispatch_setup(
+    struct cosc_dispatch *dispatch,
+    struct cosc_dispatch_node *nodes,
+    cosc_int32 node_max,
+    cosc_int32 *table,
+    cosc_int32 table_size,
+    struct cosc_pattern_op *ops,
+    cosc_int32 op_max
+)
+{
+    if (node_max < 1 || table_size < 0 || (table_size & (table_size - 1)))
+        return COSC_EINVAL;
+    dispatch->nodes = nodes;
+    dispatch->node_max = node_max;
+    dispatch->node_count = 0;
+    dispatch->table = table;
+    dispatch->table_size = table_size;
+    dispatch->ops = ops;
+    dispatch->op_max = ops ? op_max : 0;
+    dispatch->op_count = 0;
+    for (cosc_int32 i = 0; i < table_size; i++)
+        table[i] = -1;
+    cosc_dispatch_add_node(dispatch, COSC_DISPATCH_NODE_LITERAL, -1, 0, 0);
+    return 0;
+}
 
-cosc_float32 cosc_float64_to_float32(
-    cosc_float64 value
+/*
+ * Remove the nodes and operations added after node_count and op_count,
+ * unlinking them from the hash table and from older parents.
+ */
+static void cosc_dispatch_rollback(
+    struct cosc_dispatch *dispatch,
+    cosc_int32 node_count,
+    cosc_int32 op_count
 )
 {
-#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
-    return value;
-#else
-#ifndef COSC_NOFLOAT64
-    struct cosc_64bits bits = COSC_PUN(cosc_float64, struct cosc_64bits, value);
-    if (!cosc_big_endian())
-    {
-        cosc_uint32 tmp = COSC_64BITS_HI(&bits);
-        COSC_64BITS_HI(&bits) = COSC_64BITS_LO(&bits);
-        COSC_64BITS_LO(&bits) = tmp;
-    }
-#else
-    struct cosc_64bits bits = value;
-#endif
-    // FIXME: sub normal numbers.
-    cosc_uint32 sign = COSC_64BITS_HI(&bits) & 0x80000000;
-    cosc_int32 exponent = (COSC_64BITS_HI(&bits) >> 20) & 0x7ff;
-    cosc_uint32 fraction = (COSC_64BITS_HI(&bits) & 0xfffff) << 3;
-    fraction |= COSC_64BITS_LO(&bits) >> 29;
-    if (exponent >= 0x7ff)
-    {
-        exponent = 0xff;
-        fraction = 0;
-    }
-    else if (exponent > 0)
+    for (cosc_int32 i = dispatch->node_count - 1; i >= node_count; i--)
     {
-        exponent -= 1023;
-        exponent += 127;
-        int round = (COSC_64BITS_LO(&bits) << 3) >= 0x80000000;
-        if (round)
+        const struct cosc_dispatch_node *node = dispatch->nodes + i;
+        if (node->type == COSC_DISPATCH_NODE_LITERAL)
         {
-            fraction++;
-            if (fraction > 0x7fffff)
+            for (cosc_int32 slot = 0; slot < dispatch->table_size; slot++)
             {
-                exponent++;
-                fraction &= fraction;
-                if (exponent >= 0xff)
+                if (dispatch->table[slot] == i)
                 {
-                    exponent = 0xff;
-                    fraction = 0;
+                    dispatch->table[slot] = -1;
+                    break;
                 }
             }
         }
+        else if (node->parent >= 0 && node->parent < node_count)
+        {
+            // New nodes are always appended, so they end the sibling list.
+            cosc_int32 *link = node->type == COSC_DISPATCH_NODE_PATTERN
+                ? &dispatch->nodes[node->parent].patterns
+                : &dispatch->nodes[node->parent].handlers;
+            while (*link >= 0 && *link != i)
+                link = &dispatch->nodes[*link].next;
+            if (*link == i)
+                *link = -1;
+        }
     }
-    uint32_t ret = sign | ((cosc_uint32)exponent << 23) | fraction;
-#ifndef COSC_NOFLOAT32
-    return COSC_PUN(cosc_uint32, cosc_float32, ret);
-#else
-    return ret;
-#endif
-#endif
+    dispatch->node_count = node_count;
+    dispatch->op_count = op_count;
 }
 
-cosc_float64 cosc_float32_to_float64(
-    cosc_float32 value
+/*
+ * Add the nodes for a handler, on failure nodes already added are left
+ * for cosc_dispatch_rollback().
+ */
+static cosc_int32 cosc_dispatch_insert(
+    struct cosc_dispatch *dispatch,
+    const char *apattern,
+    cosc_int32 apattern_n,
+    const char *tpattern,
+    cosc_int32 tpattern_n,
+    cosc_int32 id
 )
 {
-#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
-    return value;
-#else
-    cosc_uint32 bits = COSC_PUN(cosc_float32, cosc_uint32, value);
-    cosc_uint32 sign = (bits & 0x80000000);
-    cosc_int32 exponent = (bits >> 23) & 0xff;
-    cosc_uint32 fraction = bits & 0x7fffff;
-    if (exponent == 0xff)
+    cosc_int32 parent = 0, start = 0, end, child, slot, ret;
+    cosc_int32 is_pattern;
+    for (;;)
     {
-        exponent = 0x7ff;
-        fraction = 0;
+        is_pattern = 0;
+        end = start;
+        while (end < apattern_n && apattern[end] != 0 && apattern[end] != '/')
+        {
+            if (apattern[end] == '[' || apattern[end] == '{')
+            {
+                char close = apattern[end] == '[' ? ']' : '}';
+                while (end < apattern_n && apattern[end] != 0 && apattern[end] != close)
+                {
+                    if (apattern[end] == '/')
+                        return COSC_EINVAL;
+                    end++;
+                }
+                if (end >= apattern_n || apattern[end] == 0)
+                    return COSC_EINVAL;
+                is_pattern = 1;
+            }
+            else if (apattern[end] == '*' || apattern[end] == '?' || apattern[end] == '#')
+                is_pattern = 1;
+            end++;
+        }
+        if (is_pattern)
+        {
+            child = dispatch->nodes[parent].patterns;
+            while (child >= 0
+                   && (dispatch->nodes[child].n != end - start
+                       || cosc_memcmp(dispatch->nodes[child].s, apattern + start, end - start) != 0))
+                child = dispatch->nodes[child].next;
+            if (child < 0)
+            {
+                child = cosc_dispatch_add_node(dispatch, COSC_DISPATCH_NODE_PATTERN, parent, apattern + start, end - start);
+                if (child < 0)
+                    return child;
+                ret = cosc_dispatch_add_ops(dispatch, child, apattern + start, end - start);
+                if (ret < 0)
+                    return ret;
+                if (dispatch->nodes[parent].patterns < 0)
+                    dispatch->nodes[parent].patterns = child;
+                else
+                {
+                    cosc_int32 last = dispatch->nodes[parent].patterns;
+                    while (dispatch->nodes[last].next >= 0)
+                        last = dispatch->nodes[last].next;
+                    dispatch->nodes[last].next = child;
+                }
+            }
+        }
+        else
+        {
+            cosc_uint32 hash = cosc_dispatch_hash(parent, apattern + start, end - start);
+            if (dispatch->table_size <= 0)
+                return COSC_EOVERRUN;
+            child = cosc_dispatch_lookup(dispatch, parent, apattern + start, end - start, hash, &slot);
+            if (child < 0)
+            {
+                if (slot < 0)
+                    return COSC_EOVERRUN;
+                child = cosc_dispatch_add_node(dispatch, COSC_DISPATCH_NODE_LITERAL, parent, apattern + start, end - start);
+                if (child < 0)
+                    return child;
+                dispatch->nodes[child].hash = hash;
+                dispatch->table[slot] = child;
+            }
+        }
+        parent = child;
+        if (end >= apattern_n || apattern[end] == 0)
+            break;
+        start = end + 1;
     }
-    else if (exponent > 0)
+    child = cosc_dispatch_add_node(dispatch, COSC_DISPATCH_NODE_HANDLER, parent, 0, 0);
+    if (child < 0)
+        return child;
+    dispatch->nodes[child].id = id;
+    if (tpattern)
     {
-        exponent -= 127;
-        exponent += 1023;
+        ret = cosc_dispatch_add_ops(dispatch, child, tpattern, tpattern_n);
+        if (ret < 0)
+            return ret;
     }
-    struct cosc_64bits ret = COSC_64BITS_INIT(sign | ((cosc_uint32)exponent << 20), (fraction & 0x7) << 29);
-    COSC_64BITS_HI(&ret) |= fraction >> 3;
-#ifndef COSC_NOFLOAT64
-    if (!cosc_big_endian())
+    if (dispatch->nodes[parent].handlers < 0)
+        dispatch->nodes[parent].handlers = child;
+    else
     {
-        cosc_uint32 tmp = COSC_64BITS_HI(&ret);
-        COSC_64BITS_HI(&ret) = COSC_64BITS_LO(&ret);
-        COSC_64BITS_LO(&ret) = tmp;
+        parent = dispatch->nodes[parent].handlers;
+        while (dispatch->nodes[parent].next >= 0)
+            parent = dispatch->nodes[parent].next;
+        dispatch->nodes[parent].next = child;
     }
-    return COSC_PUN(struct cosc_64bits, cosc_float64, ret);
-#else
-    return ret;
-#endif
-#endif
+    return 0;
 }
 
-#endif /* COSC_NOFLTCONV */
+cosc_int32 cosc_dispatch_add(
+    struct cosc_dispatch *dispatch,
+    const char *apattern,
+    cosc_int32 apattern_n,
+    const char *tpattern,
+    cosc_int32 tpattern_n,
+    cosc_int32 id
+)
+{
+    cosc_int32 node_count = dispatch->node_count, op_count = dispatch->op_count;
+    cosc_int32 ret = cosc_dispatch_insert(dispatch, apattern, apattern_n, tpattern, tpattern_n, id);
+    if (ret < 0)
+        cosc_dispatch_rollback(dispatch, node_count, op_count);
+    return ret;
+}
 
-cosc_int32 cosc_write_uint32(
-    void *buffer,
-    cosc_int32 size,
-    cosc_uint32 value
+cosc_int32 cosc_dispatch_match(
+    const struct cosc_dispatch *dispatch,
+    const char *address,
+    cosc_int32 address_n,
+    const char *typetag,
+    cosc_int32 typetag_n,
+    cosc_int32 *ids,
+    cosc_int32 ids_max
 )
 {
-    if (buffer)
+    cosc_int32 len = 0, node = 0, start = 0, end = -1, count = 0;
+    cosc_int32 child, child_start, child_end;
+    const struct cosc_dispatch_node *handler;
+    if (dispatch->node_count <= 0)
+        return 0;
+    while (len < address_n && address[len] != 0)
+        len++;
+    for (;;)
     {
-        if (size < 4) return COSC_EOVERRUN;
-        cosc_store_uint32(buffer, value);
+        child = -1;
+        child_start = end + 1;
+        child_end = child_start;
+        if (node && end >= len)
+        {
+            for (cosc_int32 i = dispatch->nodes[node].handlers; i >= 0; i = handler->next)
+            {
+                handler = dispatch->nodes + i;
+                if (typetag && handler->ops >= 0
+                    && !cosc_pattern_exec(dispatch->ops + handler->ops, handler->ops_n, typetag, typetag_n))
+                    continue;
+                if (ids && count < ids_max)
+                    ids[count] = handler->id;
+                count++;
+            }
+        }
+        else
+        {
+            while (child_end < len && address[child_end] != '/')
+                child_end++;
+            child = cosc_dispatch_next(dispatch, node, -1, address + child_start, child_end - child_start);
+        }
+        while (child < 0)
+        {
+            if (!node)
+                return count;
+            child_start = start;
+            child_end = end;
+            child = cosc_dispatch_next(dispatch, dispatch->nodes[node].parent, node, address + start, end - start);
+            node = dispatch->nodes[node].parent;
+            end = child_start - 1;
+            start = end;
+            while (start > 0 && address[start - 1] != '/')
+                start--;
+        }
+        node = child;
+        start = child_start;
+        end = child_end;
     }
-    return 4;
 }
 
-cosc_int32 cosc_read_uint32(
+cosc_int32 cosc_dispatch_signature_match(
+    const struct cosc_dispatch *dispatch,
     const void *buffer,
     cosc_int32 size,
-    cosc_uint32 *value
+    cosc_int32 prefix,
+    cosc_int32 *ids,
+    cosc_int32 ids_max
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value) *value = cosc_load_uint32(buffer);
-    return 4;
+    const char *address, *typetag;
+    cosc_int32 address_n, typetag_n, psize;
+    cosc_int32 ret = cosc_read_signature(
+        buffer, size, &address, &address_n, &typetag, &typetag_n,
+        prefix ? &psize : 0
+    );
+    if (ret < 0)
+        return ret;
+    return cosc_dispatch_match(dispatch, address, address_n, typetag, typetag_n, ids, ids_max);
 }
 
-cosc_int32 cosc_write_int32(
-    void *buffer,
-    cosc_int32 size,
-    cosc_int32 value
-)
-{
-    if (buffer)
-    {
-        if (size < 4) return COSC_EOVERRUN;
-        cosc_store_uint32(buffer, COSC_PUN(cosc_int32, cosc_uint32, value));
-    }
-    return 4;
-}
+#endif /* COSC_NOPATTERN */
 
-cosc_int32 cosc_read_int32(
-    const void *buffer,
-    cosc_int32 size,
-    cosc_int32 *value
+#if !defined(COSC_NOTIMETAG) || !defined(COSC_NOSCHEDULER)
+
+/*
+ * Compare timetags by the sign of a - b modulo 2^64, so that a timetag
+ * just after an era wraps around is after one just before it.
+ */
+static cosc_int32 cosc_timetag_cmp(
+    cosc_uint64 a,
+    cosc_uint64 b
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value) *value = COSC_PUN(cosc_uint32, cosc_int32, cosc_load_uint32(buffer));
-    return 4;
+#ifdef COSC_NOINT64
+    cosc_uint32 hi = COSC_64BITS_HI(&a) - COSC_64BITS_HI(&b);
+    if (COSC_64BITS_LO(&a) < COSC_64BITS_LO(&b))
+        hi--;
+    if (hi & 0x80000000)
+        return -1;
+    return hi || COSC_64BITS_LO(&a) != COSC_64BITS_LO(&b);
+#else
+    cosc_uint64 d = a - b;
+    if (d & 0x8000000000000000ULL)
+        return -1;
+    return d != 0;
+#endif
 }
 
-cosc_int32 cosc_write_float32(
-    void *buffer,
-    cosc_int32 size,
-    cosc_float32 value
+#endif /* !COSC_NOTIMETAG || !COSC_NOSCHEDULER */
+
+#ifndef COSC_NOTIMETAG
+
+cosc_uint32 cosc_timetag_to_time(
+    cosc_uint64 timetag,
+    cosc_uint32 *nanos
 )
 {
-    if (buffer)
+#ifdef COSC_NOINT64
+    if (nanos)
     {
-        if (size < 4) return COSC_EOVERRUN;
-        cosc_store_uint32(buffer, COSC_PUN(cosc_float32, cosc_uint32, value));
+        struct cosc_64bits tmp = cosc_mul64(COSC_64BITS_LO(&timetag), 1000000000);
+        cosc_add64(&tmp, 500000000);
+        *nanos = COSC_64BITS_HI(&tmp); // Same as >> 32.
     }
-    return 4;
+    return COSC_64BITS_HI(&timetag);
+#else
+    if (nanos)
+    {
+        cosc_uint64 tmp = timetag & 0xffffffff;
+        tmp *= 1000000000;
+        tmp += 500000000;
+        tmp >>= 32;
+        *nanos = tmp;
+    }
+    return (timetag & 0xffffffff00000000ULL) >> 32;
+#endif
 }
 
-cosc_int32 cosc_read_float32(
-    const void *buffer,
-    cosc_int32 size,
-    cosc_float32 *value
+cosc_uint64 cosc_time_to_timetag(
+    cosc_uint32 seconds,
+    cosc_uint32 nanos
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value) *value = COSC_PUN(cosc_uint32, cosc_float32, cosc_load_uint32(buffer));
-    return 4;
+    seconds += nanos / 1000000000;
+    nanos %= 1000000000;
+#ifdef COSC_NOINT64
+    struct cosc_64bits res = COSC_64BITS_INIT(nanos, 0);
+    cosc_add64(&res, 0x20000000);
+    cosc_div64_1e9(&res);
+    COSC_64BITS_HI(&res) = seconds;
+    return res;
+#else
+    cosc_uint64 tmp = nanos;
+    tmp <<= 32;
+    tmp += 0x20000000;
+    tmp /= 1000000000;
+    tmp |= (cosc_uint64)seconds << 32;
+    return tmp;
+#endif
 }
 
-cosc_int32 cosc_write_uint64(
-    void *buffer,
-    cosc_int32 size,
-    cosc_uint64 value
+/*
+ * Fixed-point reciprocal of 10^9 for nanoseconds to timetag units,
+ * 2^32 / 10^9 = 4 + K1 / 2^32 + K2 / 2^64 + K3 / 2^96.
+ */
+#define COSC_TIMETAG_K1 1266874889U
+#define COSC_TIMETAG_K2 3047500985U
+#define COSC_TIMETAG_K3 2336248903U
+
+/*
+ * Offset a timetag by n nanoseconds, n * 2^32 / 10^9 timetag units
+ * rounded to nearest. Arithmetic is modulo 2^64, n <= 2^63.
+ */
+static cosc_uint64 cosc_timetag_offset(
+    cosc_uint64 timetag,
+    cosc_uint64 n,
+    cosc_int32 negative
 )
 {
-    if (buffer)
-    {
-        if (size < 8) return COSC_EOVERRUN;
-        cosc_store_uint64(buffer, value);
-    }
-    return 8;
+#ifdef COSC_NOINT64
+    cosc_uint32 nh = COSC_64BITS_HI(&n), nl = COSC_64BITS_LO(&n);
+    struct cosc_64bits low = cosc_mul64(nl, COSC_TIMETAG_K2);
+    struct cosc_64bits tmp = cosc_mul64(nh, COSC_TIMETAG_K3);
+    cosc_addto64(&low, &tmp);
+    struct cosc_64bits mid = cosc_mul64(nl, COSC_TIMETAG_K1);
+    cosc_add64(&mid, COSC_64BITS_HI(&low));
+    cosc_add64(&mid, 0x80000000);
+    tmp = cosc_mul64(nh, COSC_TIMETAG_K2);
+    cosc_addto64(&mid, &tmp);
+    // delta = 4n + nh * K1 + mid / 2^32.
+    struct cosc_64bits delta = cosc_mul64(nh, COSC_TIMETAG_K1);
+    cosc_add64(&delta, COSC_64BITS_HI(&mid));
+    COSC_64BITS_SET(&tmp, (nh << 2) | (nl >> 30), nl << 2);
+    cosc_addto64(&delta, &tmp);
+    if (negative)
+        cosc_subfrom64(&timetag, &delta);
+    else
+        cosc_addto64(&timetag, &delta);
+    return timetag;
+#else
+    cosc_uint64 nh = n >> 32, nl = n & 0xffffffff;
+    cosc_uint64 low = nl * COSC_TIMETAG_K2 + nh * COSC_TIMETAG_K3;
+    cosc_uint64 mid = nl * COSC_TIMETAG_K1 + nh * COSC_TIMETAG_K2;
+    mid += (low >> 32) + 0x80000000;
+    cosc_uint64 delta = (n << 2) + nh * COSC_TIMETAG_K1 + (mid >> 32);
+    return negative ? timetag - delta : timetag + delta;
+#endif
 }
 
-cosc_int32 cosc_read_uint64(
-    const void *buffer,
-    cosc_int32 size,
-    cosc_uint64 *value
+cosc_uint64 cosc_timetag_add(
+    cosc_uint64 timetag,
+    cosc_int64 nanos
 )
 {
-    if (size < 8)
-        return COSC_EOVERRUN;
-    if (value) *value = cosc_load_uint64(buffer);
-    return 8;
+#ifdef COSC_NOINT64
+    cosc_int32 negative = (COSC_64BITS_HI(&nanos) & 0x80000000) != 0;
+    if (negative)
+        cosc_neg64(&nanos);
+    return cosc_timetag_offset(timetag, nanos, negative);
+#else
+    if (nanos < 0)
+        return cosc_timetag_offset(timetag, 0 - (cosc_uint64)nanos, 1);
+    return cosc_timetag_offset(timetag, (cosc_uint64)nanos, 0);
+#endif
 }
 
-cosc_int32 cosc_write_int64(
-    void *buffer,
-    cosc_int32 size,
-    cosc_int64 value
+cosc_uint64 cosc_timetag_sub(
+    cosc_uint64 timetag,
+    cosc_int64 nanos
 )
 {
-    if (buffer)
-    {
-        if (size < 8) return COSC_EOVERRUN;
-        cosc_store_uint64(buffer, COSC_PUN(cosc_int64, cosc_uint64, value));
-    }
-    return 8;
+#ifdef COSC_NOINT64
+    cosc_int32 negative = (COSC_64BITS_HI(&nanos) & 0x80000000) != 0;
+    if (negative)
+        cosc_neg64(&nanos);
+    return cosc_timetag_offset(timetag, nanos, !negative);
+#else
+    if (nanos < 0)
+        return cosc_timetag_offset(timetag, 0 - (cosc_uint64)nanos, 0);
+    return cosc_timetag_offset(timetag, (cosc_uint64)nanos, 1);
+#endif
 }
 
-cosc_int32 cosc_read_int64(
-    const void *buffer,
-    cosc_int32 size,
-    cosc_int64 *value
+cosc_int64 cosc_timetag_diff(
+    cosc_uint64 a,
+    cosc_uint64 b
 )
 {
-    if (size < 8)
-        return COSC_EOVERRUN;
-    if (value) *value = COSC_PUN(cosc_uint64, cosc_int64, cosc_load_uint64(buffer));
-    return 8;
+#ifdef COSC_NOINT64
+    cosc_subfrom64(&a, &b);
+    // Seconds * 10^9 + the fraction * 10^9 / 2^32, 10^9 / 2^32 = 1953125 / 2^23.
+    cosc_uint32 hi = COSC_64BITS_HI(&a);
+    cosc_int32 negative = (hi & 0x80000000) != 0;
+    struct cosc_64bits ns = cosc_mul64(negative ? 0 - hi : hi, 1000000000);
+    if (negative)
+        cosc_neg64(&ns);
+    struct cosc_64bits frac = cosc_mul64(COSC_64BITS_LO(&a), 1953125);
+    cosc_add64(&frac, 0x400000);
+    cosc_add64(&ns, (COSC_64BITS_HI(&frac) << 9) | (COSC_64BITS_LO(&frac) >> 23));
+    return ns;
+#else
+    cosc_uint64 d = a - b;
+    cosc_int64 seconds = (cosc_int64)(cosc_int32)(cosc_uint32)(d >> 32);
+    cosc_uint64 frac = ((d & 0xffffffff) * 1953125 + 0x400000) >> 23;
+    return seconds * 1000000000 + (cosc_int64)frac;
+#endif
 }
 
-cosc_int32 cosc_write_float64(
-    void *buffer,
-    cosc_int32 size,
-    cosc_float64 value
+cosc_int32 cosc_timetag_compare(
+    cosc_uint64 a,
+    cosc_uint64 b
 )
 {
-    if (buffer)
-    {
-        if (size < 8)
-            return COSC_EOVERRUN;
-#if defined(COSC_NOSWAP)
-        COSC_COPY64(buffer, &value);
-#elif defined(COSC_NOFLOAT64)
-        cosc_store_uint32(buffer, COSC_64BITS_HI(&value));
-        cosc_store_uint32((char *)buffer + 4, COSC_64BITS_LO(&value));
-#elif defined(COSC_NOINT64)
-        if (!cosc_big_endian())
-            COSC_COPY64SWAP(buffer, &value);
-        else
-            COSC_COPY64(buffer, &value);
-#else
-        cosc_store_uint64(buffer, COSC_PUN(cosc_float64, cosc_uint64, value));
-#endif
-    }
-    return 8;
+    return cosc_timetag_cmp(a, b);
 }
 
-cosc_int32 cosc_read_float64(
-    const void *buffer,
-    cosc_int32 size,
-    cosc_float64 *value
+#endif /* !COSC_NOTIMETAG */
+
+#ifndef COSC_NOFLTCONV
+
+#if defined(COSC_NOFLOAT64) || defined(COSC_NOFLOAT32)
+
+/*
+ * Float64 bits to float32 bits, rounded to nearest even. Results below
+ * the normal range round from the full significand into subnormals and
+ * NaNs are quieted keeping the top of their payload, like hardware
+ * conversions do.
+ */
+static cosc_uint32 cosc_fltconv_narrow(
+    cosc_uint32 hi,
+    cosc_uint32 lo
 )
 {
-    if (size < 8)
-        return COSC_EOVERRUN;
-#if defined(COSC_NOSWAP)
-    cosc_float64 tmp;
-    COSC_COPY64(&tmp, buffer);
-    if (value) *value = tmp;
-#elif defined(COSC_NOFLOAT64)
-    cosc_float64 tmp;
-    COSC_64BITS_HI(&tmp) = cosc_load_uint32(buffer);
-    COSC_64BITS_LO(&tmp) = cosc_load_uint32((const char *)buffer + 4);
-    if (value) *value = tmp;
-#elif defined(COSC_NOINT64)
-    cosc_float64 tmp;
-    if (!cosc_big_endian())
-        COSC_COPY64SWAP(&tmp, buffer);
-    else
-        COSC_COPY64(&tmp, buffer);
-    if (value) *value = tmp;
-#else
-    if (value) *value = COSC_PUN(cosc_uint64, cosc_float64, cosc_load_uint64(buffer));
-#endif
-    return 8;
+    cosc_uint32 sign = hi & 0x80000000;
+    cosc_int32 exponent = (hi >> 20) & 0x7ff;
+    cosc_uint32 fraction = ((hi & 0xfffff) << 3) | (lo >> 29);
+    cosc_uint32 rest = lo << 3;
+    if (exponent == 0x7ff)
+    {
+        if (fraction || rest)
+            return sign | 0x7fc00000 | fraction;
+        return sign | 0x7f800000;
+    }
+    exponent -= 1023 - 127;
+    if (exponent >= 0xff)
+        return sign | 0x7f800000;
+    if (exponent <= 0)
+    {
+        cosc_int32 shift = 1 - exponent;
+        if (shift > 24)
+            return sign;
+        cosc_uint32 significand = fraction | 0x800000;
+        cosc_uint32 half = 1U << (shift - 1);
+        cosc_uint32 remainder = significand & ((half << 1) - 1);
+        fraction = significand >> shift;
+        if (remainder > half || (remainder == half && (rest || (fraction & 1))))
+            fraction++;
+        return sign | fraction;
+    }
+    // A carry out of the fraction rounds up the exponent, to infinity at most.
+    cosc_uint32 ret = ((cosc_uint32)exponent << 23) | fraction;
+    if (rest > 0x80000000 || (rest == 0x80000000 && (fraction & 1)))
+        ret++;
+    return sign | ret;
 }
 
-cosc_int32 cosc_write_string(
-    void *buffer,
-    cosc_int32 size,
-    const char *value,
-    cosc_int32 value_n,
-    cosc_int32 *length
+/*
+ * Float32 bits to float64 bits, exact. Subnormals are normalized and
+ * NaNs are quieted keeping their payload.
+ */
+static struct cosc_64bits cosc_fltconv_widen(
+    cosc_uint32 bits
 )
 {
-    cosc_int32 len = 0, pad;
-    if (buffer)
+    cosc_uint32 sign = bits & 0x80000000;
+    cosc_uint32 exponent = (bits >> 23) & 0xff;
+    cosc_uint32 fraction = bits & 0x7fffff;
+    if (exponent == 0xff)
     {
-        if (value)
+        exponent = 0x7ff;
+        if (fraction)
+            fraction |= 0x400000;
+    }
+    else if (exponent > 0)
+        exponent += 1023 - 127;
+    else if (fraction)
+    {
+        exponent = 1023 - 127 + 1;
+        while (!(fraction & 0x800000))
         {
-            while (len < value_n && value[len] != 0)
-            {
-                if (len >= size)
-                    return COSC_EOVERRUN;
-                ((char *)buffer)[len] = value[len];
-                len++;
-            }
+            fraction <<= 1;
+            exponent--;
         }
-        pad = COSC_PADMUST(len);
-        if (len > COSC_SIZE_MAX - pad)
-            return COSC_ESIZEMAX;
-        if (len + pad > size)
-            return COSC_EOVERRUN;
-        cosc_memset((char *)buffer + len, 0, pad);
+        fraction &= 0x7fffff;
     }
-    else
+    struct cosc_64bits ret = COSC_64BITS_INIT(sign | (exponent << 20) | (fraction >> 3), fraction << 29);
+    return ret;
+}
+
+/*
+ * Split a cosc_float64 into high and low words. Only a native double
+ * without a native 64-bit integer depends on byte order, callers
+ * resolve it once per call.
+ */
+static struct cosc_64bits cosc_fltconv_load(
+    cosc_float64 value,
+    cosc_int32 big_endian
+)
+{
+    (void)big_endian;
+#if defined(COSC_NOFLOAT64)
+    return value;
+#elif !defined(COSC_NOINT64)
+    cosc_uint64 u = COSC_PUN(cosc_float64, cosc_uint64, value);
+    struct cosc_64bits bits = COSC_64BITS_INIT((cosc_uint32)(u >> 32), (cosc_uint32)u);
+    return bits;
+#else
+    struct cosc_64bits bits = COSC_PUN(cosc_float64, struct cosc_64bits, value);
+    if (!big_endian)
     {
-        if (value)
-            while (len < value_n && value[len] != 0)
-                len++;
-        pad = COSC_PADMUST(len);
-        if (len > COSC_SIZE_MAX - pad)
-            return COSC_ESIZEMAX;
+        cosc_uint32 tmp = COSC_64BITS_HI(&bits);
+        COSC_64BITS_HI(&bits) = COSC_64BITS_LO(&bits);
+        COSC_64BITS_LO(&bits) = tmp;
     }
-    if (length)
-        *length = len;
-    return len + pad;
+    return bits;
+#endif
 }
 
-cosc_int32 cosc_read_string(
-    const void *buffer,
-    cosc_int32 size,
-    char *value,
-    cosc_int32 value_n,
-    cosc_int32 *length
+static cosc_float64 cosc_fltconv_store(
+    struct cosc_64bits bits,
+    cosc_int32 big_endian
 )
 {
-    cosc_int32 len = 0, pad;
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value && value_n > 0)
+    (void)big_endian;
+#if defined(COSC_NOFLOAT64)
+    return bits;
+#elif !defined(COSC_NOINT64)
+    cosc_uint64 u = ((cosc_uint64)COSC_64BITS_HI(&bits) << 32) | COSC_64BITS_LO(&bits);
+    return COSC_PUN(cosc_uint64, cosc_float64, u);
+#else
+    if (!big_endian)
     {
-        while (len < size && ((const char *)buffer)[len] != 0)
-        {
-            if (len < value_n)
-                value[len] = ((const char *)buffer)[len];
-            len++;
-        }
-        value[len < value_n ? len : value_n - 1] = 0;
+        cosc_uint32 tmp = COSC_64BITS_HI(&bits);
+        COSC_64BITS_HI(&bits) = COSC_64BITS_LO(&bits);
+        COSC_64BITS_LO(&bits) = tmp;
     }
-    else
+    return COSC_PUN(struct cosc_64bits, cosc_float64, bits);
+#endif
+}
+
+#if defined(COSC_NOINT64) && !defined(COSC_NOFLOAT64)
+#define COSC_FLTCONV_BIG_ENDIAN() COSC_HOST_BIG_ENDIAN()
+#else
+#define COSC_FLTCONV_BIG_ENDIAN() 0
+#endif
+
+#endif /* COSC_NOFLOAT64 || COSC_NOFLOAT32 */
+
+cosc_float32 cosc_float64_to_float32(
+    cosc_float64 value
+)
+{
+#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
+    return value;
+#else
+    cosc_float32 ret;
+    cosc_float64_to_float32_n(&ret, &value, 1);
+    return ret;
+#endif
+}
+
+cosc_float64 cosc_float32_to_float64(
+    cosc_float32 value
+)
+{
+#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
+    return value;
+#else
+    cosc_float64 ret;
+    cosc_float32_to_float64_n(&ret, &value, 1);
+    return ret;
+#endif
+}
+
+void cosc_float64_to_float32_n(
+    cosc_float32 *dst,
+    const cosc_float64 *src,
+    cosc_int32 n
+)
+{
+#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
+    for (cosc_int32 i = 0; i < n; i++)
+        dst[i] = (cosc_float32)src[i];
+#else
+    cosc_int32 big_endian = COSC_FLTCONV_BIG_ENDIAN();
+    for (cosc_int32 i = 0; i < n; i++)
     {
-        while (len < size && ((const char *)buffer)[len] != 0)
-            len++;
+        struct cosc_64bits bits = cosc_fltconv_load(src[i], big_endian);
+        cosc_uint32 ret = cosc_fltconv_narrow(COSC_64BITS_HI(&bits), COSC_64BITS_LO(&bits));
+#ifndef COSC_NOFLOAT32
+        dst[i] = COSC_PUN(cosc_uint32, cosc_float32, ret);
+#else
+        dst[i] = ret;
+#endif
     }
-    pad = COSC_PADMUST(len);
-    if (len > COSC_SIZE_MAX - pad)
-        return COSC_ESIZEMAX;
-    if (len + pad > size)
-        return COSC_EOVERRUN;
-    if (length)
-        *length = len;
-    return len + pad;
+#endif
 }
 
-cosc_int32 cosc_write_blob(
-    void *buffer,
-    cosc_int32 size,
-    const void *value,
-    cosc_int32 value_n
+void cosc_float32_to_float64_n(
+    cosc_float64 *dst,
+    const cosc_float32 *src,
+    cosc_int32 n
 )
 {
-    if (value_n < 0)
-        value_n = 0;
-    else if (value_n > COSC_SIZE_MAX - 4)
-        return COSC_ESIZEMAX;
-    cosc_int32 pad = COSC_PAD(value_n);
-    if (value_n + 4 > COSC_SIZE_MAX - pad)
-        return COSC_ESIZEMAX;
-    if (buffer)
+#if !defined(COSC_NOFLOAT64) && !defined(COSC_NOFLOAT32)
+    for (cosc_int32 i = 0; i < n; i++)
+        dst[i] = src[i];
+#else
+    cosc_int32 big_endian = COSC_FLTCONV_BIG_ENDIAN();
+    for (cosc_int32 i = 0; i < n; i++)
     {
-        if (value_n > size - pad - 4)
-            return COSC_EOVERRUN;
-        cosc_store_int32(buffer, value_n);
-        if (value)
-        {
-            cosc_memcpy((char *)buffer + 4, value, value_n);
-            cosc_memset((char *)buffer + 4 + value_n, 0, pad);
-        }
-        else
-            cosc_memset((char *)buffer + 4, 0, value_n + pad);
+        cosc_uint32 bits = COSC_PUN(cosc_float32, cosc_uint32, src[i]);
+        dst[i] = cosc_fltconv_store(cosc_fltconv_widen(bits), big_endian);
     }
-    return value_n + pad + 4;
+#endif
 }
 
-cosc_int32 cosc_read_blob(
+#endif /* COSC_NOFLTCONV */
+
+cosc_int32 cosc_write_uint32(
+    void *buffer,
+    cosc_int32 size,
+    cosc_uint32 value
+)
+{
+    return cosc_inline_write_uint32(buffer, size, value);
+}
+
+cosc_int32 cosc_read_uint32(
     const void *buffer,
     cosc_int32 size,
-    void *value,
-    cosc_int32 value_n,
-    const void **data,
-    cosc_int32 *data_size
+    cosc_uint32 *value
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    cosc_int32 psize = cosc_load_int32(buffer);
-    if (psize > COSC_SIZE_MAX - 4)
-        return COSC_ESIZEMAX;
-    if (psize < 0)
-        return COSC_EPSIZE;
-    cosc_int32 pad = COSC_PAD(psize);
-    if (psize > COSC_SIZE_MAX - pad - 4)
-        return COSC_ESIZEMAX;
-    if (psize + pad > size - 4)
-        return COSC_EOVERRUN;
-    if (value && value_n > 0)
-        cosc_memcpy(value, (const char *)buffer + 4, psize < value_n ? psize : value_n);
-    if (data)
-        *data = psize > 0 ? (const char *)buffer + 4 : 0;
-    if (data_size)
-        *data_size = psize;
-    return psize + 4 + pad;
+    return cosc_inline_read_uint32(buffer, size, value);
 }
 
-cosc_int32 cosc_write_char(
+cosc_int32 cosc_write_int32(
     void *buffer,
     cosc_int32 size,
     cosc_int32 value
 )
 {
-    if (buffer)
-    {
-        if (size < 4)
-            return COSC_EOVERRUN;
-        ((unsigned char *)buffer)[0] = value;
-        ((unsigned char *)buffer)[1] = 0;
-        ((unsigned char *)buffer)[2] = 0;
-        ((unsigned char *)buffer)[3] = 0;
-    }
-    return 4;
+    return cosc_inline_write_int32(buffer, size, value);
 }
 
-cosc_int32 cosc_read_char(
+cosc_int32 cosc_read_int32(
     const void *buffer,
     cosc_int32 size,
     cosc_int32 *value
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value)
-        *value = *(const char *)buffer;
-    return 4;
+    return cosc_inline_read_int32(buffer, size, value);
 }
 
-cosc_int32 cosc_write_midi(
+cosc_int32 cosc_write_float32(
     void *buffer,
     cosc_int32 size,
-    const unsigned char value[4]
+    cosc_float32 value
 )
 {
-    if (buffer)
-    {
-        if (size < 4)
-            return COSC_EOVERRUN;
-        if (value)
-            cosc_memcpy(buffer, value, 4);
-        else
-            cosc_memset(buffer, 0, 4);
-    }
-    return 4;
+    return cosc_inline_write_float32(buffer, size, value);
 }
 
-cosc_int32 cosc_read_midi(
+cosc_int32 cosc_read_float32(
     const void *buffer,
     cosc_int32 size,
-    unsigned char value[4]
+    cosc_float32 *value
 )
 {
-    if (size < 4)
-        return COSC_EOVERRUN;
-    if (value)
-        cosc_memcpy(value, buffer, 4);
-    return 4;
+    return cosc_inline_read_float32(buffer, size, value);
 }
 
-cosc_int32 cosc_write_bundle(
+cosc_int32 cosc_write_uint64(
     void *buffer,
     cosc_int32 size,
-    cosc_uint64 timetag,
-    cosc_int32 psize
+    cosc_uint64 value
 )
 {
-    cosc_int32 req = psize != 0 ? 20 : 16;
-    if (psize > 0)
-    {
-        if (psize < 16 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4)
-            return COSC_EPSIZE;
-    }
-    if (buffer)
+    return cosc_inline_write_uint64(buffer, size, value);
+}
+
+cosc_int32 cosc_read_uint64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_uint64 *value
+)
+{
+    return cosc_inline_read_uint64(buffer, size, value);
+}
+
+cosc_int32 cosc_write_int64(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int64 value
+)
+{
+    return cosc_inline_write_int64(buffer, size, value);
+}
+
+cosc_int32 cosc_read_int64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int64 *value
+)
+{
+    return cosc_inline_read_int64(buffer, size, value);
+}
+
+cosc_int32 cosc_write_float64(
+    void *buffer,
+    cosc_int32 size,
+    cosc_float64 value
+)
+{
+    return cosc_inline_write_float64(buffer, size, value);
+}
+
+cosc_int32 cosc_read_float64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float64 *value
+)
+{
+    return cosc_inline_read_float64(buffer, size, value);
+}
+
+static cosc_int32 cosc_write_array(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int32 type,
+    cosc_int32 width,
+    const void *values,
+    cosc_int32 values_n
+)
+{
+    if (values_n <= 0)
+        return 0;
+    if (values_n > COSC_SIZE_MAX / width)
+        return COSC_ESIZEMAX;
+    if (buffer)
+    {
+        if (size < values_n * width)
+            return COSC_EOVERRUN;
+        if (values)
+            cosc_swap_n(buffer, values, type, values_n);
+        else
+            cosc_memset(buffer, 0, values_n * width);
+    }
+    return values_n * width;
+}
+
+static cosc_int32 cosc_read_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 type,
+    cosc_int32 width,
+    void *values,
+    cosc_int32 values_n
+)
+{
+    if (values_n <= 0)
+        return 0;
+    if (values_n > COSC_SIZE_MAX / width)
+        return COSC_ESIZEMAX;
+    if (size < values_n * width)
+        return COSC_EOVERRUN;
+    if (values)
+        cosc_swap_n(values, buffer, type, values_n);
+    return values_n * width;
+}
+
+cosc_int32 cosc_write_int32_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_int32 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_write_array(buffer, size, 'i', 4, values, values_n);
+}
+
+cosc_int32 cosc_read_int32_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_read_array(buffer, size, 'i', 4, values, values_n);
+}
+
+cosc_int32 cosc_write_float32_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_float32 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_write_array(buffer, size, 'f', 4, values, values_n);
+}
+
+cosc_int32 cosc_read_float32_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float32 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_read_array(buffer, size, 'f', 4, values, values_n);
+}
+
+cosc_int32 cosc_write_int64_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_int64 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_write_array(buffer, size, 'h', 8, values, values_n);
+}
+
+cosc_int32 cosc_read_int64_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int64 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_read_array(buffer, size, 'h', 8, values, values_n);
+}
+
+cosc_int32 cosc_write_float64_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_float64 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_write_array(buffer, size, 'd', 8, values, values_n);
+}
+
+cosc_int32 cosc_read_float64_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float64 *values,
+    cosc_int32 values_n
+)
+{
+    return cosc_read_array(buffer, size, 'd', 8, values, values_n);
+}
+
+cosc_int32 cosc_write_string(
+    void *buffer,
+    cosc_int32 size,
+    const char *value,
+    cosc_int32 value_n,
+    cosc_int32 *length
+)
+{
+    cosc_int32 len = 0, pad;
+    if (buffer)
+    {
+        if (value)
+        {
+            while (len < value_n && value[len] != 0)
+                len++;
+            if (len > size)
+                return COSC_EOVERRUN;
+            cosc_memcpy(buffer, value, len);
+        }
+        pad = COSC_PADMUST(len);
+        if (len > COSC_SIZE_MAX - pad)
+            return COSC_ESIZEMAX;
+        if (len + pad > size)
+            return COSC_EOVERRUN;
+        cosc_memset((char *)buffer + len, 0, pad);
+    }
+    else
+    {
+        if (value)
+            while (len < value_n && value[len] != 0)
+                len++;
+        pad = COSC_PADMUST(len);
+        if (len > COSC_SIZE_MAX - pad)
+            return COSC_ESIZEMAX;
+    }
+    if (length)
+        *length = len;
+    return len + pad;
+}
+
+cosc_int32 cosc_read_string(
+    const void *buffer,
+    cosc_int32 size,
+    char *value,
+    cosc_int32 value_n,
+    cosc_int32 *length
+)
+{
+    cosc_int32 len, pad;
+    if (size < 4)
+        return COSC_EOVERRUN;
+    len = cosc_string_length((const unsigned char *)buffer, size);
+    if (value && value_n > 0)
+    {
+        cosc_memcpy(value, buffer, len < value_n ? len : value_n);
+        value[len < value_n ? len : value_n - 1] = 0;
+    }
+    pad = COSC_PADMUST(len);
+    if (len > COSC_SIZE_MAX - pad)
+        return COSC_ESIZEMAX;
+    if (len + pad > size)
+        return COSC_EOVERRUN;
+    if (length)
+        *length = len;
+    return len + pad;
+}
+
+cosc_int32 cosc_write_blob(
+    void *buffer,
+    cosc_int32 size,
+    const void *value,
+    cosc_int32 value_n
+)
+{
+    if (value_n < 0)
+        value_n = 0;
+    else if (value_n > COSC_SIZE_MAX - 4)
+        return COSC_ESIZEMAX;
+    cosc_int32 pad = COSC_PAD(value_n);
+    if (value_n + 4 > COSC_SIZE_MAX - pad)
+        return COSC_ESIZEMAX;
+    if (buffer)
+    {
+        if (value_n > size - pad - 4)
+            return COSC_EOVERRUN;
+        cosc_store_int32(buffer, value_n);
+        if (value)
+        {
+            cosc_memcpy((char *)buffer + 4, value, value_n);
+            cosc_memset((char *)buffer + 4 + value_n, 0, pad);
+        }
+        else
+            cosc_memset((char *)buffer + 4, 0, value_n + pad);
+    }
+    return value_n + pad + 4;
+}
+
+cosc_int32 cosc_read_blob(
+    const void *buffer,
+    cosc_int32 size,
+    void *value,
+    cosc_int32 value_n,
+    const void **data,
+    cosc_int32 *data_size
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    cosc_int32 psize = cosc_load_int32(buffer);
+    if (psize > COSC_SIZE_MAX - 4)
+        return COSC_ESIZEMAX;
+    if (psize < 0)
+        return COSC_EPSIZE;
+    cosc_int32 pad = COSC_PAD(psize);
+    if (psize > COSC_SIZE_MAX - pad - 4)
+        return COSC_ESIZEMAX;
+    if (psize + pad > size - 4)
+        return COSC_EOVERRUN;
+    if (value && value_n > 0)
+        cosc_memcpy(value, (const char *)buffer + 4, psize < value_n ? psize : value_n);
+    if (data)
+        *data = psize > 0 ? (const char *)buffer + 4 : 0;
+    if (data_size)
+        *data_size = psize;
+    return psize + 4 + pad;
+}
+
+cosc_int32 cosc_write_char(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int32 value
+)
+{
+    return cosc_inline_write_char(buffer, size, value);
+}
+
+cosc_int32 cosc_read_char(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 *value
+)
+{
+    return cosc_inline_read_char(buffer, size, value);
+}
+
+cosc_int32 cosc_write_midi(
+    void *buffer,
+    cosc_int32 size,
+    const unsigned char value[4]
+)
+{
+    if (buffer)
+    {
+        if (size < 4)
+            return COSC_EOVERRUN;
+        if (value)
+            cosc_memcpy(buffer, value, 4);
+        else
+            cosc_memset(buffer, 0, 4);
+    }
+    return 4;
+}
+
+cosc_int32 cosc_read_midi(
+    const void *buffer,
+    cosc_int32 size,
+    unsigned char value[4]
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    if (value)
+        cosc_memcpy(value, buffer, 4);
+    return 4;
+}
+
+cosc_int32 cosc_write_bundle(
+    void *buffer,
+    cosc_int32 size,
+    cosc_uint64 timetag,
+    cosc_int32 psize
+)
+{
+    cosc_int32 req = psize != 0 ? 20 : 16;
+    if (psize > 0)
+    {
+        if (psize < 16 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4)
+            return COSC_EPSIZE;
+    }
+    if (buffer)
+    {
+        if (size < req)
+            return COSC_EOVERRUN;
+        if (psize != 0)
+        {
+            if (psize > 0)
+                cosc_store_int32(buffer, psize);
+            else
+                cosc_store_int32(buffer, 16);
+            buffer = (char *)buffer + 4;
+        }
+        cosc_memcpy(buffer, "#bundle", 8);
+        cosc_store_uint64((unsigned char *)buffer + 8, timetag);
+    }
+    return req;
+}
+
+cosc_int32 cosc_read_bundle(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_uint64 *timetag,
+    cosc_int32 *psize
+)
+{
+    cosc_int32 req = psize ? 20 : 16;
+    if (size < req)
+        return COSC_EOVERRUN;
+    if (psize)
+    {
+        *psize = cosc_load_int32(buffer);
+        if (*psize < 16 || *psize > COSC_SIZE_MAX - 4 || COSC_PAD(*psize))
+            return COSC_EPSIZE;
+        if (*psize > size - 4)
+            return COSC_EOVERRUN;
+        buffer = (const char *)buffer + 4;
+    }
+    if (cosc_memcmp(buffer, "#bundle", 8) != 0)
+        return COSC_ETYPE;
+    if (timetag)
+        *timetag = cosc_load_uint64((const unsigned char *)buffer + 8);
+    return req;
+}
+
+cosc_int32 cosc_bundle_index(
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_bundle_element *elements,
+    cosc_int32 elements_n,
+    cosc_uint64 *timetag,
+    cosc_int32 psize
+)
+{
+    const unsigned char *bytes = (const unsigned char *)buffer;
+    cosc_int32 bundle_size = 0;
+    cosc_uint64 tt;
+    cosc_int32 offset = cosc_read_bundle(bytes, size, &tt, psize ? &bundle_size : 0);
+    if (offset < 0)
+        return offset;
+    if (psize)
+        size = bundle_size + 4;
+    cosc_int32 count = 0;
+    while (offset < size)
+    {
+        if (offset > size - 4)
+            return COSC_EOVERRUN;
+        cosc_int32 esize = cosc_load_int32(bytes + offset);
+        offset += 4;
+        if (esize < 0 || COSC_PAD(esize))
+            return COSC_EPSIZE;
+        if (esize > size - offset)
+            return COSC_EOVERRUN;
+        cosc_int32 type = COSC_LEVEL_TYPE_MESSAGE;
+        cosc_uint64 ett = tt;
+        if (esize > 0 && bytes[offset] == '#')
+        {
+            cosc_int32 ret = cosc_read_bundle(bytes + offset, esize, &ett, 0);
+            if (ret < 0)
+                return ret;
+            type = COSC_LEVEL_TYPE_BUNDLE;
+        }
+        if (elements && count < elements_n)
+        {
+            elements[count].offset = offset;
+            elements[count].size = esize;
+            elements[count].type = type;
+            elements[count].timetag = ett;
+        }
+        count++;
+        offset += esize;
+    }
+    if (timetag)
+        *timetag = tt;
+    return count;
+}
+
+cosc_int32 cosc_write_signature(
+    void *buffer,
+    cosc_int32 size,
+    const char *address,
+    cosc_int32 address_n,
+    const char *typetag,
+    cosc_int32 typetag_n,
+    cosc_int32 psize
+)
+{
+    cosc_int32 req = 0, sz;
+    if (psize > 0)
     {
-        if (size < req)
+        if (psize > COSC_SIZE_MAX - 4)
+            return COSC_ESIZEMAX;
+        if (psize < 8 || COSC_PAD(psize))
+            return COSC_EPSIZE;
+    }
+    if (buffer && size < 12)
+        return COSC_EOVERRUN;
+    if (psize != 0)
+        req += 4;
+    if (buffer)
+        sz = cosc_write_string((unsigned char *)buffer + req, size - req, address, address_n, 0);
+    else
+        sz = cosc_write_string(0, 0, address, address_n, 0);
+    if (sz < 0)
+        return sz;
+    if (sz > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    req += sz;
+    if (buffer)
+        sz = cosc_write_string((unsigned char *)buffer + req, size - req, typetag, typetag_n, 0);
+    else
+        sz = cosc_write_string(0, 0, typetag, typetag_n, 0);
+    if (sz < 0)
+        return sz;
+    if (sz > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    req += sz;
+    if (psize > 0)
+    {
+        if (psize < req - 4 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4)
+            return COSC_EPSIZE;
+        if (buffer)
+            cosc_store_int32(buffer, psize);
+    }
+    else if (psize < 0 && buffer)
+        cosc_store_int32(buffer, req - 4);
+    return req;
+}
+
+cosc_int32 cosc_read_signature(
+    const void *buffer,
+    cosc_int32 size,
+    const char **address,
+    cosc_int32 *address_n,
+    const char **typetag,
+    cosc_int32 *typetag_n,
+    cosc_int32 *psize
+)
+{
+    cosc_int32 req = 0, sz;
+    if (size < 8)
+        return COSC_EOVERRUN;
+    if (psize)
+    {
+        *psize = cosc_load_int32(buffer);
+        if (*psize < 8 || *psize > COSC_SIZE_MAX - 8 || COSC_PAD(*psize))
+            return COSC_EPSIZE;
+        if (*psize > size - 4)
+            return COSC_EOVERRUN;
+        req += 4;
+    }
+    if (address)
+        *address = (const char *)buffer + req;
+    sz = cosc_read_string((const char *)buffer + req, size - req, 0, 0, address_n);
+    if (sz < 0)
+        return sz;
+    req += sz;
+    if (typetag)
+        *typetag = (const char *)buffer + req;
+    sz = cosc_read_string((const char *)buffer + req, size - req, 0, 0, typetag_n);
+    if (sz < 0)
+        return sz;
+    req += sz;
+    return req;
+}
+
+cosc_int32 cosc_write_value(
+    void *buffer,
+    cosc_int32 size,
+    char type,
+    const union cosc_value *value
+)
+{
+#if defined(COSC_NOINT64) || defined(COSC_NOFLOAT64)
+    static const struct cosc_64bits zero64 = COSC_64BITS_INIT(0, 0);
+#endif
+    if (buffer)
+    {
+        switch (type)
+        {
+        case 'i': return cosc_write_int32(buffer, size, value ? value->i : 0);
+        case 'r': return cosc_write_uint32(buffer, size, value ? value->r : 0);
+        case 'f': return cosc_write_float32(buffer, size, value ? value->f : 0);
+#ifdef COSC_NOINT64
+        case 'h': return cosc_write_int64(buffer, size, value ? value->h : zero64);
+        case 't': return cosc_write_uint64(buffer, size, value ? value->t : zero64);
+#else
+        case 'h': return cosc_write_int64(buffer, size, value ? value->h : 0);
+        case 't': return cosc_write_uint64(buffer, size, value ? value->t : 0);
+#endif
+#ifdef COSC_NOFLOAT64
+        case 'd': return cosc_write_float64(buffer, size, value ? value->d : zero64);
+#else
+        case 'd': return cosc_write_float64(buffer, size, value ? value->d : 0);
+#endif
+        case 'c': return cosc_write_char(buffer, size, value ? value->c : 0);
+        case 'm': return cosc_write_midi(buffer, size, value ? value->m : 0);
+        case 's':
+        case 'S': return cosc_write_string(buffer, size, value ? value->s.s : 0, value ? value->s.length : 0, 0);
+        case 'b': return cosc_write_blob(buffer, size, value ? value->b.b : 0, value ? value->b.size : 0);
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I': return 0;
+        }
+    }
+    else
+    {
+        switch (type)
+        {
+        case 'i':
+        case 'r':
+        case 'f':
+        case 'c':
+        case 'm': return 4;
+        case 'h':
+        case 't':
+        case 'd': return 8;
+        case 's':
+        case 'S': return cosc_write_string(0, 0, value ? value->s.s : 0, value ? value->s.length : 0, 0);
+        case 'b': return  cosc_write_blob(0, 0, value ? value->b.b : 0, value ? value->b.size : 0);
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I': return 0;
+        }
+    }
+    return COSC_ETYPE;
+}
+
+cosc_int32 cosc_read_value(
+    const void *buffer,
+    cosc_int32 size,
+    char type,
+    union cosc_value *value
+)
+{
+    switch (type)
+    {
+    case 'i': return cosc_read_int32(buffer, size, value ? &value->i : 0);
+    case 'r': return cosc_read_uint32(buffer, size, value ? &value->r : 0);
+    case 'f': return cosc_read_float32(buffer, size, value ? &value->f : 0);
+    case 'h': return cosc_read_int64(buffer, size, value ? &value->h : 0);
+    case 't': return cosc_read_uint64(buffer, size, value ? &value->t : 0);
+    case 'd': return cosc_read_float64(buffer, size, value ? &value->d : 0);
+    case 'c': return cosc_read_char(buffer, size, value ? &value->c : 0);
+    case 'm': return cosc_read_midi(buffer, size, value ? value->m : 0);
+    case 's':
+    case 'S':
+        if (value)
+        {
+            value->s.s = (const char *)buffer;
+            return cosc_read_string(buffer, size, 0, 0, &value->s.length);
+        }
+        return cosc_read_string(buffer, size, 0, 0, 0);
+    case 'b':
+        if (value)
+            return cosc_read_blob(buffer, size, 0, 0, &value->b.b, &value->b.size);
+        return cosc_read_blob(buffer, size, 0, 0, 0, 0);
+    case 'T':
+    case 'F':
+    case 'N':
+    case 'I':
+        if (value) cosc_memset(value, 0, sizeof(*value));
+        return 0;
+    }
+    return COSC_ETYPE;
+}
+
+cosc_int32 cosc_write_values(
+    void *buffer,
+    cosc_int32 size,
+    const char *types,
+    cosc_int32 types_n,
+    const union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count
+)
+{
+    cosc_int32 tlen = 0, vlen = 0, req = 0;
+#ifndef COSC_NOARRAY
+    cosc_int32 array_start = 0;
+#endif
+    if (types_n <= 0 || *types == 0)
+    {
+        if (value_count) *value_count = 0;
+        return 0;
+    }
+    if (*types == ',')
+        tlen++;
+    cosc_int32 payload = 0;
+    while (tlen < types_n && types[tlen] != 0)
+    {
+        cosc_int32 sz;
+#ifndef COSC_NOARRAY
+        if (types[tlen] == '[')
+        {
+            if (array_start)
+            {
+                if (value_count) *value_count = vlen;
+                return COSC_ETYPE;
+            }
+            tlen++;
+            array_start = tlen;
+            payload = 0;
+            cosc_int32 width = 0, run = cosc_array_run(types, types_n, tlen, &width);
+            if (run > 0 && run <= COSC_SIZE_MAX / width)
+            {
+                cosc_int32 reps = vlen < values_n ? (values_n - vlen - 1) / run + 1 : 1;
+                if (reps <= (COSC_SIZE_MAX - req) / (run * width)
+                    && (!buffer || reps * run * width <= size - req))
+                {
+                    cosc_int32 count = reps * run;
+                    if (buffer)
+                    {
+                        cosc_write_values_run((unsigned char *)buffer, types[tlen], values && vlen < values_n ? values + vlen : 0, values_n - vlen, count);
+                        buffer = (char *)buffer + count * width;
+                    }
+                    req += count * width;
+                    vlen += count;
+                    payload = count;
+                    tlen += run;
+                }
+            }
+            continue;
+        }
+        if (types[tlen] == ']')
+        {
+            if (!array_start)
+            {
+                if (value_count) *value_count = vlen;
+                return COSC_ETYPE;
+            }
+            if (vlen >= values_n || payload == 0)
+                break;
+            tlen = array_start;
+            continue;
+        }
+#endif
+        if (values && vlen < values_n)
+            sz = cosc_write_value(buffer, size - req, types[tlen], values + vlen);
+        else
+            sz = cosc_write_value(buffer, size - req, types[tlen], 0);
+        if (sz < 0)
+        {
+            if (value_count) *value_count = vlen;
+            return sz;
+        }
+        if (sz > COSC_SIZE_MAX - req)
+        {
+            if (value_count) *value_count = vlen;
             return COSC_EOVERRUN;
-        if (psize != 0)
+        }
+        req += sz;
+        if (buffer)
+            buffer = (char *)buffer + sz;
+        tlen++;
+        if (sz > 0)
         {
-            if (psize > 0)
-                cosc_store_int32(buffer, psize);
-            else
-                cosc_store_int32(buffer, 16);
-            buffer = (char *)buffer + 4;
+            payload++;
+            vlen++;
         }
-        cosc_memcpy(buffer, "#bundle", 8);
-        cosc_store_uint64((unsigned char *)buffer + 8, timetag);
     }
+    if (value_count) *value_count = vlen;
+#ifndef COSC_NOARRAY
+    if (array_start > 0 && (tlen >= types_n || types[tlen] != ']'))
+        return COSC_ETYPE;
+#endif
     return req;
 }
 
-cosc_int32 cosc_read_bundle(
+cosc_int32 cosc_read_values(
     const void *buffer,
     cosc_int32 size,
-    cosc_uint64 *timetag,
-    cosc_int32 *psize
+    const char *types,
+    cosc_int32 types_n,
+    union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count,
+    cosc_int32 exit_early
 )
 {
-    cosc_int32 req = psize ? 20 : 16;
-    if (size < req)
-        return COSC_EOVERRUN;
-    if (psize)
+    cosc_int32 tlen = 0, vlen = 0, req = 0;
+#ifndef COSC_NOARRAY
+    cosc_int32 array_start = 0;
+#endif
+    if (types_n <= 0 || *types == 0)
     {
-        *psize = cosc_load_int32(buffer);
-        if (*psize < 16 || *psize > COSC_SIZE_MAX - 4 || COSC_PAD(*psize))
-            return COSC_EPSIZE;
-        if (*psize > size - 4)
+        if (value_count) *value_count = 0;
+        return 0;
+    }
+    if (*types == ',')
+        tlen++;
+    cosc_int32 payload = 0;
+    while (tlen < types_n && types[tlen] != 0)
+    {
+        cosc_int32 sz;
+#ifndef COSC_NOARRAY
+        if (types[tlen] == '[')
+        {
+            if (array_start)
+            {
+                if (value_count) *value_count = vlen;
+                return COSC_ETYPE;
+            }
+            tlen++;
+            array_start = tlen;
+            payload = 0;
+            cosc_int32 width = 0, run = cosc_array_run(types, types_n, tlen, &width);
+            if (run > 0 && run <= COSC_SIZE_MAX / width)
+            {
+                cosc_int32 reps = (size - req) / (run * width);
+                if (exit_early)
+                {
+                    cosc_int32 need = vlen < values_n ? (values_n - vlen - 1) / run + 1 : 1;
+                    if (need < reps)
+                        reps = need;
+                }
+                if (reps > 0)
+                {
+                    cosc_int32 count = reps * run;
+                    if (values && vlen < values_n)
+                        cosc_read_values_run((const unsigned char *)buffer, types[tlen], values + vlen, count < values_n - vlen ? count : values_n - vlen);
+                    buffer = (const char *)buffer + count * width;
+                    req += count * width;
+                    vlen += count;
+                    payload = count;
+                    tlen += run;
+                }
+            }
+            continue;
+        }
+        if (types[tlen] == ']')
+        {
+            if (!array_start)
+            {
+                if (value_count) *value_count = vlen;
+                return COSC_ETYPE;
+            }
+            if ((vlen >= values_n && exit_early) || req >= size || payload == 0)
+                break;
+            tlen = array_start;
+            continue;
+        }
+#endif
+        if (values && vlen < values_n)
+            sz = cosc_read_value(buffer, size - req, types[tlen], values + vlen);
+        else
+            sz = cosc_read_value(buffer, size - req, types[tlen], 0);
+        if (sz < 0)
+        {
+            if (value_count) *value_count = vlen;
+            return sz;
+        }
+        if (sz > COSC_SIZE_MAX - req)
+        {
+            if (value_count) *value_count = vlen;
             return COSC_EOVERRUN;
-        buffer = (const char *)buffer + 4;
+        }
+        req += sz;
+        if (buffer)
+            buffer = (const char *)buffer + sz;
+        tlen++;
+        if (sz > 0)
+        {
+            payload++;
+            vlen++;
+        }
     }
-    if (cosc_memcmp(buffer, "#bundle", 8) != 0)
+    if (value_count) *value_count = vlen;
+#ifndef COSC_NOARRAY
+    if (array_start && (tlen >= types_n || types[tlen] != ']'))
         return COSC_ETYPE;
-    if (timetag)
-        *timetag = cosc_load_uint64((const unsigned char *)buffer + 8);
+#endif
     return req;
 }
 
-cosc_int32 cosc_write_signature(
-    void *buffer,
-    cosc_int32 size,
-    const char *address,
-    cosc_int32 address_n,
+cosc_int32 cosc_typetag_plan_compile(
+    struct cosc_typetag_plan *plan,
+    struct cosc_plan_field *fields,
+    cosc_int32 field_max,
     const char *typetag,
-    cosc_int32 typetag_n,
-    cosc_int32 psize
+    cosc_int32 typetag_n
 )
 {
-    cosc_int32 req = 0, sz;
-    if (psize > 0)
+    cosc_int32 len = 0, count = 0, run_start = -1, run_size = 0;
+    cosc_int32 array_start = -1, array_end = -1;
+    cosc_int32 sizes[2] = {0, 0}, value_counts[2] = {0, 0};
+    if (typetag_n > 0 && *typetag == ',')
+        len++;
+    while (len < typetag_n && typetag[len] != 0)
     {
-        if (psize > COSC_SIZE_MAX - 4)
-            return COSC_ESIZEMAX;
-        if (psize < 8 || COSC_PAD(psize))
-            return COSC_EPSIZE;
+        cosc_int32 size = 0;
+        switch (typetag[len])
+        {
+        case 'i':
+        case 'r':
+        case 'f':
+        case 'c':
+        case 'm': size = 4; break;
+        case 'h':
+        case 't':
+        case 'd': size = 8; break;
+        case 's':
+        case 'S':
+        case 'b': size = -1; break;
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I': size = 0; break;
+#ifndef COSC_NOARRAY
+        case '[':
+            if (array_start >= 0)
+                return COSC_ETYPE;
+            array_start = count;
+            run_start = -1;
+            len++;
+            continue;
+        case ']':
+            if (array_start < 0)
+                return COSC_ETYPE;
+            array_end = count;
+            break;
+#endif
+        default:
+            return COSC_ETYPE;
+        }
+        if (array_end >= 0)
+            break;
+        if (fields && count >= field_max)
+            return COSC_EOVERRUN;
+        cosc_int32 section = array_start >= 0;
+        if (size >= 0)
+        {
+            if (run_start < 0)
+            {
+                run_start = count;
+                run_size = 0;
+            }
+            if (sizes[section] >= 0)
+            {
+                if (size > COSC_SIZE_MAX - sizes[section])
+                    return COSC_ESIZEMAX;
+                sizes[section] += size;
+            }
+        }
+        else
+        {
+            run_start = -1;
+            sizes[section] = -1;
+        }
+        if (fields)
+        {
+            fields[count].type = typetag[len];
+            fields[count].offset = size >= 0 ? run_size : 0;
+            fields[count].size = size;
+            fields[count].run = 0;
+            if (size >= 0)
+                fields[run_start].run = run_size + size;
+        }
+        if (size >= 0)
+            run_size += size;
+        if (size != 0)
+            value_counts[section]++;
+        count++;
+        len++;
     }
-    if (buffer && size < 12)
+    if (array_start >= 0 && array_end < 0)
+        return COSC_ETYPE;
+    if (plan)
+    {
+        plan->fields = fields;
+        plan->field_count = count;
+        plan->array_start = array_start;
+        plan->array_end = array_end;
+        plan->fixed_size = sizes[0];
+        plan->array_size = sizes[1];
+        plan->value_count = value_counts[0];
+        plan->array_value_count = value_counts[1];
+    }
+    return count;
+}
+
+cosc_int32 cosc_typetag_plan_size(
+    const struct cosc_typetag_plan *plan,
+    cosc_int32 values_n
+)
+{
+    if (plan->fixed_size < 0 || plan->array_size < 0)
+        return COSC_ETYPE;
+    if (plan->array_start < 0)
+        return plan->fixed_size;
+    cosc_int32 reps = cosc_plan_reps(plan, plan->value_count, values_n);
+    if (plan->array_size > 0 && reps > (COSC_SIZE_MAX - plan->fixed_size) / plan->array_size)
         return COSC_EOVERRUN;
-    if (psize != 0)
-        req += 4;
-    if (buffer)
-        sz = cosc_write_string((unsigned char *)buffer + req, size - req, address, address_n, 0);
-    else
-        sz = cosc_write_string(0, 0, address, address_n, 0);
+    return plan->fixed_size + reps * plan->array_size;
+}
+
+cosc_int32 cosc_write_values_plan(
+    void *buffer,
+    cosc_int32 size,
+    const struct cosc_typetag_plan *plan,
+    const union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count
+)
+{
+    cosc_int32 vlen = 0, req, sz;
+    cosc_int32 end = plan->array_start >= 0 ? plan->array_start : plan->field_count;
+    req = cosc_plan_write_fields((unsigned char *)buffer, size, plan->fields, 0, end, values, values_n, &vlen);
+    if (req >= 0 && plan->array_start >= 0)
+    {
+        if (!buffer && plan->array_size >= 0)
+        {
+            cosc_int32 reps = cosc_plan_reps(plan, vlen, values_n);
+            if (plan->array_size > 0 && reps > (COSC_SIZE_MAX - req) / plan->array_size)
+                req = COSC_EOVERRUN;
+            else
+            {
+                req += reps * plan->array_size;
+                vlen += reps * plan->array_value_count;
+            }
+        }
+        else
+        {
+            do
+            {
+                sz = cosc_plan_write_fields(buffer ? (unsigned char *)buffer + req : 0, size - req, plan->fields, plan->array_start, plan->array_end, values, values_n, &vlen);
+                if (sz >= 0 && sz > COSC_SIZE_MAX - req)
+                    sz = COSC_EOVERRUN;
+                if (sz < 0)
+                {
+                    req = sz;
+                    break;
+                }
+                req += sz;
+            } while (vlen < values_n && plan->array_value_count > 0);
+        }
+    }
+    if (value_count) *value_count = vlen;
+    return req;
+}
+
+cosc_int32 cosc_read_values_plan(
+    const void *buffer,
+    cosc_int32 size,
+    const struct cosc_typetag_plan *plan,
+    union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count,
+    cosc_int32 exit_early
+)
+{
+    cosc_int32 vlen = 0, req, sz;
+    cosc_int32 end = plan->array_start >= 0 ? plan->array_start : plan->field_count;
+    req = cosc_plan_read_fields((const unsigned char *)buffer, size, plan->fields, 0, end, values, values_n, &vlen);
+    if (req >= 0 && plan->array_start >= 0)
+    {
+        do
+        {
+            sz = cosc_plan_read_fields((const unsigned char *)buffer + req, size - req, plan->fields, plan->array_start, plan->array_end, values, values_n, &vlen);
+            if (sz >= 0 && sz > COSC_SIZE_MAX - req)
+                sz = COSC_EOVERRUN;
+            if (sz < 0)
+            {
+                req = sz;
+                break;
+            }
+            req += sz;
+        } while (!(exit_early && vlen >= values_n) && req < size && plan->array_value_count > 0);
+    }
+    if (value_count) *value_count = vlen;
+    return req;
+}
+
+cosc_int32 cosc_write_message(
+    void *buffer,
+    cosc_int32 size,
+    const struct cosc_message *message,
+    cosc_int32 psize,
+    cosc_int32 *value_count
+)
+{
+    cosc_int32 req = 0, sz;
+    struct cosc_message tmp_message = {0, 0, 0, 0, {0}, 0};
+
+    if (!message)
+        message = &tmp_message;
+    sz = cosc_write_signature(
+        buffer ? buffer : 0, buffer ? size - req : 0,
+        message->address, message->address_n,
+        message->typetag, message->typetag_n,
+        psize
+    );
     if (sz < 0)
+    {
+        if (value_count) *value_count = 0;
         return sz;
+    }
     if (sz > COSC_SIZE_MAX - req)
-        return COSC_ESIZEMAX;
+    {
+        if (value_count) *value_count = 0;
+        return COSC_SIZE_MAX;
+    }
     req += sz;
-    if (buffer)
-        sz = cosc_write_string((unsigned char *)buffer + req, size - req, typetag, typetag_n, 0);
-    else
-        sz = cosc_write_string(0, 0, typetag, typetag_n, 0);
+    sz = cosc_write_values(
+        buffer ? (unsigned char *)buffer + req : 0, size - req,
+        message->typetag, message->typetag_n,
+        message->values.write, message->values_n,
+        value_count
+    );
     if (sz < 0)
         return sz;
     if (sz > COSC_SIZE_MAX - req)
-        return COSC_ESIZEMAX;
+        return COSC_SIZE_MAX;
     req += sz;
     if (psize > 0)
     {
         if (psize < req - 4 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4)
             return COSC_EPSIZE;
-        cosc_store_int32(buffer, psize);
+        cosc_write_int32(buffer, 4, psize);
     }
     else if (psize < 0)
-        cosc_store_int32(buffer, req - 4);
+        cosc_write_int32(buffer, 4, req - 4);
     return req;
 }
 
-cosc_int32 cosc_read_signature(
+cosc_int32 cosc_read_message(
     const void *buffer,
     cosc_int32 size,
-    const char **address,
-    cosc_int32 *address_n,
-    const char **typetag,
-    cosc_int32 *typetag_n,
-    cosc_int32 *psize
+    struct cosc_message *message,
+    cosc_int32 *psize,
+    cosc_int32 *value_count,
+    cosc_int32 exit_early
 )
 {
     cosc_int32 req = 0, sz;
-    if (size < 8)
-        return COSC_EOVERRUN;
+    struct cosc_message tmp_message;
+    if (!message)
+        message = &tmp_message;
+    sz = cosc_read_signature(
+        buffer, size - req,
+        &message->address, &message->address_n,
+        &message->typetag, &message->typetag_n,
+        psize
+    );
     if (psize)
     {
-        *psize = cosc_load_int32(buffer);
-        if (*psize < 8 || *psize > COSC_SIZE_MAX - 8 || COSC_PAD(*psize))
+        if (*psize < 8 || COSC_PAD(*psize) || *psize > COSC_SIZE_MAX - 4)
             return COSC_EPSIZE;
-        if (*psize > size - 4)
-            return COSC_EOVERRUN;
-        req += 4;
     }
-    if (address)
-        *address = (const char *)buffer + req;
-    sz = cosc_read_string((const char *)buffer + req, size - req, 0, 0, address_n);
     if (sz < 0)
+    {
+        if (value_count) *value_count = 0;
         return sz;
+    }
+    if (sz > COSC_SIZE_MAX - req)
+    {
+        if (value_count) *value_count = 0;
+        return COSC_SIZE_MAX;
+    }
     req += sz;
-    if (typetag)
-        *typetag = (const char *)buffer + req;
-    sz = cosc_read_string((const char *)buffer + req, size - req, 0, 0, typetag_n);
+    buffer = (char *)buffer + sz;
+    sz = cosc_read_values(
+        buffer, size - req,
+        message->typetag, message->typetag_n,
+        message->values.read, message->values_n,
+        value_count, exit_early
+    );
     if (sz < 0)
+    {
+        if (value_count) *value_count = 0;
         return sz;
+    }
+    if (sz > COSC_SIZE_MAX - req)
+    {
+        if (value_count) *value_count = 0;
+        return COSC_SIZE_MAX;
+    }
     req += sz;
     return req;
 }
 
-cosc_int32 cosc_write_value(
+static cosc_int32 cosc_binding_write(
     void *buffer,
     cosc_int32 size,
-    char type,
-    const union cosc_value *value
+    const struct cosc_binding *binding,
+    const unsigned char *data
 )
 {
-#if defined(COSC_NOINT64) || defined(COSC_NOFLOAT64)
-    static const struct cosc_64bits zero64 = COSC_64BITS_INIT(0, 0);
-#endif
-    if (buffer)
-    {
-        switch (type)
-        {
-        case 'i': return cosc_write_int32(buffer, size, value ? value->i : 0);
-        case 'r': return cosc_write_uint32(buffer, size, value ? value->r : 0);
-        case 'f': return cosc_write_float32(buffer, size, value ? value->f : 0);
-#ifdef COSC_NOINT64
-        case 'h': return cosc_write_int64(buffer, size, value ? value->h : zero64);
-        case 't': return cosc_write_uint64(buffer, size, value ? value->t : zero64);
-#else
-        case 'h': return cosc_write_int64(buffer, size, value ? value->h : 0);
-        case 't': return cosc_write_uint64(buffer, size, value ? value->t : 0);
-#endif
-#ifdef COSC_NOFLOAT64
-        case 'd': return cosc_write_float64(buffer, size, value ? value->d : zero64);
-#else
-        case 'd': return cosc_write_float64(buffer, size, value ? value->d : 0);
-#endif
-        case 'c': return cosc_write_char(buffer, size, value ? value->c : 0);
-        case 'm': return cosc_write_midi(buffer, size, value ? value->m : 0);
-        case 's':
-        case 'S': return cosc_write_string(buffer, size, value ? value->s.s : 0, value ? value->s.length : 0, 0);
-        case 'b': return cosc_write_blob(buffer, size, value ? value->b.b : 0, value ? value->b.size : 0);
-        case 'T':
-        case 'F':
-        case 'N':
-        case 'I': return 0;
-        }
-    }
-    else
+    const unsigned char *member;
+    if (!data)
+        return cosc_write_value(buffer, size, (char)binding->type, 0);
+    member = data + binding->offset;
+    switch (binding->type)
     {
-        switch (type)
-        {
-        case 'i':
-        case 'r':
-        case 'f':
-        case 'c':
-        case 'm': return 4;
-        case 'h':
-        case 't':
-        case 'd': return 8;
-        case 's':
-        case 'S': return cosc_write_string(0, 0, value ? value->s.s : 0, value ? value->s.length : 0, 0);
-        case 'b': return  cosc_write_blob(0, 0, value ? value->b.b : 0, value ? value->b.size : 0);
-        case 'T':
-        case 'F':
-        case 'N':
-        case 'I': return 0;
-        }
+    case 'i': return cosc_write_int32(buffer, size, *(const cosc_int32 *)member);
+    case 'r': return cosc_write_uint32(buffer, size, *(const cosc_uint32 *)member);
+    case 'f': return cosc_write_float32(buffer, size, *(const cosc_float32 *)member);
+    case 'h': return cosc_write_int64(buffer, size, *(const cosc_int64 *)member);
+    case 't': return cosc_write_uint64(buffer, size, *(const cosc_uint64 *)member);
+    case 'd': return cosc_write_float64(buffer, size, *(const cosc_float64 *)member);
+    case 'c': return cosc_write_char(buffer, size, *(const cosc_int32 *)member);
+    case 'm': return cosc_write_midi(buffer, size, member);
+    case 's':
+    case 'S':
+        return cosc_write_string(
+            buffer, size, *(const char *const *)member,
+            binding->size_offset >= 0 ? *(const cosc_int32 *)(data + binding->size_offset) : COSC_SIZE_MAX,
+            0
+        );
+    case 'b':
+        if (binding->size_offset < 0)
+            return COSC_EINVAL;
+        return cosc_write_blob(buffer, size, *(const void *const *)member, *(const cosc_int32 *)(data + binding->size_offset));
+    case 'T':
+    case 'F':
+    case 'N':
+    case 'I': return 0;
     }
     return COSC_ETYPE;
 }
 
-cosc_int32 cosc_read_value(
+static cosc_int32 cosc_binding_read(
     const void *buffer,
     cosc_int32 size,
-    char type,
-    union cosc_value *value
+    const struct cosc_binding *binding,
+    unsigned char *data
 )
 {
-    switch (type)
+    unsigned char *member = data ? data + binding->offset : 0;
+    cosc_int32 sz, length;
+    const void *blob;
+    switch (binding->type)
     {
-    case 'i': return cosc_read_int32(buffer, size, value ? &value->i : 0);
-    case 'r': return cosc_read_uint32(buffer, size, value ? &value->r : 0);
-    case 'f': return cosc_read_float32(buffer, size, value ? &value->f : 0);
-    case 'h': return cosc_read_int64(buffer, size, value ? &value->h : 0);
-    case 't': return cosc_read_uint64(buffer, size, value ? &value->t : 0);
-    case 'd': return cosc_read_float64(buffer, size, value ? &value->d : 0);
-    case 'c': return cosc_read_char(buffer, size, value ? &value->c : 0);
-    case 'm': return cosc_read_midi(buffer, size, value ? value->m : 0);
+    case 'i': return cosc_read_int32(buffer, size, (cosc_int32 *)member);
+    case 'r': return cosc_read_uint32(buffer, size, (cosc_uint32 *)member);
+    case 'f': return cosc_read_float32(buffer, size, (cosc_float32 *)member);
+    case 'h': return cosc_read_int64(buffer, size, (cosc_int64 *)member);
+    case 't': return cosc_read_uint64(buffer, size, (cosc_uint64 *)member);
+    case 'd': return cosc_read_float64(buffer, size, (cosc_float64 *)member);
+    case 'c': return cosc_read_char(buffer, size, (cosc_int32 *)member);
+    case 'm': return cosc_read_midi(buffer, size, member);
     case 's':
     case 'S':
-        if (value)
+        sz = cosc_read_string(buffer, size, 0, 0, &length);
+        if (sz >= 0 && data)
         {
-            value->s.s = (const char *)buffer;
-            return cosc_read_string(buffer, size, 0, 0, &value->s.length);
+            *(const char **)member = (const char *)buffer;
+            if (binding->size_offset >= 0)
+                *(cosc_int32 *)(data + binding->size_offset) = length;
         }
-        return cosc_read_string(buffer, size, 0, 0, 0);
+        return sz;
     case 'b':
-        if (value)
-            return cosc_read_blob(buffer, size, 0, 0, &value->b.b, &value->b.size);
-        return cosc_read_blob(buffer, size, 0, 0, 0, 0);
+        sz = cosc_read_blob(buffer, size, 0, 0, &blob, &length);
+        if (sz >= 0 && data)
+        {
+            *(const void **)member = blob;
+            if (binding->size_offset >= 0)
+                *(cosc_int32 *)(data + binding->size_offset) = length;
+        }
+        return sz;
     case 'T':
     case 'F':
     case 'N':
-    case 'I':
-        if (value) cosc_memset(value, 0, sizeof(*value));
-        return 0;
+    case 'I': return 0;
     }
     return COSC_ETYPE;
 }
 
-cosc_int32 cosc_write_values(
+cosc_int32 cosc_write_message_from(
     void *buffer,
     cosc_int32 size,
-    const char *types,
-    cosc_int32 types_n,
-    const union cosc_value *values,
-    cosc_int32 values_n,
-    cosc_int32 *value_count
+    const char *address,
+    cosc_int32 address_n,
+    const struct cosc_binding *bindings,
+    cosc_int32 bindings_n,
+    const void *data,
+    cosc_int32 psize
 )
 {
-    cosc_int32 tlen = 0, vlen = 0, req = 0;
-#ifndef COSC_NOARRAY
-    cosc_int32 array_start = 0;
-#endif
-    if (types_n <= 0 || *types == 0)
+    cosc_int32 req = 0, sz, pad;
+    if (psize > 0)
     {
-        if (value_count) *value_count = 0;
-        return 0;
+        if (psize > COSC_SIZE_MAX - 4)
+            return COSC_ESIZEMAX;
+        if (psize < 8 || COSC_PAD(psize))
+            return COSC_EPSIZE;
     }
-    if (*types == ',')
-        tlen++;
-    cosc_int32 payload = 0;
-    while (tlen < types_n && types[tlen] != 0)
+    if (bindings_n < 0 || bindings_n > COSC_SIZE_MAX - 8)
+        return COSC_ESIZEMAX;
+    if (psize != 0)
     {
-        cosc_int32 sz;
-#ifndef COSC_NOARRAY
-        if (types[tlen] == '[')
-        {
-            if (array_start)
-            {
-                if (value_count) *value_count = vlen;
-                return COSC_ETYPE;
-            }
-            tlen++;
-            array_start = tlen;
-            payload = 0;
-            continue;
-        }
-        if (types[tlen] == ']')
-        {
-            if (!array_start)
-            {
-                if (value_count) *value_count = vlen;
-                return COSC_ETYPE;
-            }
-            if (vlen >= values_n || payload == 0)
-                break;
-            tlen = array_start;
-            continue;
-        }
-#endif
-        if (values && vlen < values_n)
-            sz = cosc_write_value(buffer, size - req, types[tlen], values + vlen);
-        else
-            sz = cosc_write_value(buffer, size - req, types[tlen], 0);
+        if (buffer && size < 4)
+            return COSC_EOVERRUN;
+        req += 4;
+    }
+    sz = cosc_write_string(buffer ? (unsigned char *)buffer + req : 0, buffer ? size - req : 0, address, address_n, 0);
+    if (sz < 0)
+        return sz;
+    if (sz > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    req += sz;
+    pad = COSC_PADMUST(bindings_n + 1);
+    if (bindings_n + 1 + pad > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    if (buffer)
+    {
+        if (bindings_n + 1 + pad > size - req)
+            return COSC_EOVERRUN;
+        ((char *)buffer)[req] = ',';
+        for (cosc_int32 i = 0; i < bindings_n; i++)
+            ((char *)buffer)[req + 1 + i] = (char)bindings[i].type;
+        cosc_memset((char *)buffer + req + 1 + bindings_n, 0, pad);
+    }
+    req += bindings_n + 1 + pad;
+    for (cosc_int32 i = 0; i < bindings_n; i++)
+    {
+        sz = cosc_binding_write(
+            buffer ? (unsigned char *)buffer + req : 0, buffer ? size - req : 0,
+            bindings + i, (const unsigned char *)data
+        );
         if (sz < 0)
-        {
-            if (value_count) *value_count = vlen;
             return sz;
-        }
         if (sz > COSC_SIZE_MAX - req)
-        {
-            if (value_count) *value_count = vlen;
-            return COSC_EOVERRUN;
-        }
+            return COSC_ESIZEMAX;
         req += sz;
+    }
+    if (psize > 0)
+    {
+        if (psize < req - 4)
+            return COSC_EPSIZE;
         if (buffer)
-            buffer = (char *)buffer + sz;
-        tlen++;
-        if (sz > 0)
-        {
-            payload++;
-            vlen++;
-        }
+            cosc_store_int32(buffer, psize);
     }
-    if (value_count) *value_count = vlen;
-#ifndef COSC_NOARRAY
-    if (array_start > 0 && (tlen >= types_n || types[tlen] != ']'))
-        return COSC_ETYPE;
-#endif
+    else if (psize < 0 && buffer)
+        cosc_store_int32(buffer, req - 4);
     return req;
 }
 
-cosc_int32 cosc_read_values(
+cosc_int32 cosc_read_message_into(
     const void *buffer,
     cosc_int32 size,
-    const char *types,
-    cosc_int32 types_n,
-    union cosc_value *values,
-    cosc_int32 values_n,
-    cosc_int32 *value_count,
-    cosc_int32 exit_early
+    const char **address,
+    cosc_int32 *address_n,
+    const struct cosc_binding *bindings,
+    cosc_int32 bindings_n,
+    void *data,
+    cosc_int32 *psize
 )
 {
-    cosc_int32 tlen = 0, vlen = 0, req = 0;
-#ifndef COSC_NOARRAY
-    cosc_int32 array_start = 0;
-#endif
-    if (types_n <= 0 || *types == 0)
+    const char *typetag;
+    cosc_int32 req, sz, typetag_n;
+    req = cosc_read_signature(buffer, size, address, address_n, &typetag, &typetag_n, psize);
+    if (psize)
     {
-        if (value_count) *value_count = 0;
-        return 0;
+        if (*psize < 8 || COSC_PAD(*psize) || *psize > COSC_SIZE_MAX - 4)
+            return COSC_EPSIZE;
     }
-    if (*types == ',')
-        tlen++;
-    cosc_int32 payload = 0;
-    while (tlen < types_n && types[tlen] != 0)
+    if (req < 0)
+        return req;
+    if (typetag_n != bindings_n + 1 || typetag[0] != ',')
+        return COSC_EMSGTYPE;
+    for (cosc_int32 i = 0; i < bindings_n; i++)
     {
-        cosc_int32 sz;
+        if (typetag[i + 1] != bindings[i].type)
+            return COSC_EMSGTYPE;
+    }
+    for (cosc_int32 i = 0; i < bindings_n; i++)
+    {
+        sz = cosc_binding_read((const unsigned char *)buffer + req, size - req, bindings + i, (unsigned char *)data);
+        if (sz < 0)
+            return sz;
+        if (sz > COSC_SIZE_MAX - req)
+            return COSC_ESIZEMAX;
+        req += sz;
+    }
+    return req;
+}
+
+/*
+ * Resolve the next value(s) of a view the same way cosc_read_values()
+ * walks the typetag, returns 1 if at least one value was resolved, 0 if
+ * there are no more values or a negative error code.
+ */
+static cosc_int32 cosc_message_view_next(
+    struct cosc_message_view *view
+)
+{
+    const char *types = view->typetag;
+    cosc_int32 sz;
+    while (view->type_index < view->typetag_n && types[view->type_index] != 0)
+    {
+        cosc_int32 type = types[view->type_index];
+        const unsigned char *p = view->values + view->offset;
+        cosc_int32 left = view->values_size - view->offset;
+        switch (type)
+        {
 #ifndef COSC_NOARRAY
-        if (types[tlen] == '[')
+        case '[':
         {
-            if (array_start)
-            {
-                if (value_count) *value_count = vlen;
+            if (view->array_start)
                 return COSC_ETYPE;
+            view->type_index++;
+            view->array_start = view->type_index;
+            view->array_values = 0;
+            cosc_int32 width = 0, run = cosc_array_run(types, view->typetag_n, view->type_index, &width);
+            if (run > 0 && run <= COSC_SIZE_MAX / width)
+            {
+                cosc_int32 reps = left / (run * width);
+                if (reps > 0)
+                {
+                    view->run_start = view->count;
+                    view->run_count = reps * run;
+                    view->run_offset = view->offset;
+                    view->run_type = types[view->type_index];
+                    view->count += view->run_count;
+                    view->offset += view->run_count * width;
+                    view->array_values = view->run_count;
+                    view->type_index += run;
+                    return 1;
+                }
             }
-            tlen++;
-            array_start = tlen;
-            payload = 0;
             continue;
         }
-        if (types[tlen] == ']')
-        {
-            if (!array_start)
-            {
-                if (value_count) *value_count = vlen;
+        case ']':
+            if (!view->array_start)
                 return COSC_ETYPE;
+            if (view->offset >= view->values_size || view->array_values == 0)
+            {
+                view->done = 1;
+                return 0;
             }
-            if ((vlen >= values_n && exit_early) || req >= size || payload == 0)
-                break;
-            tlen = array_start;
+            view->type_index = view->array_start;
             continue;
-        }
 #endif
-        if (values && vlen < values_n)
-            sz = cosc_read_value(buffer, size - req, types[tlen], values + vlen);
-        else
-            sz = cosc_read_value(buffer, size - req, types[tlen], 0);
+        case 'i':
+        case 'r':
+        case 'f':
+        case 'c':
+        case 'm':
+            sz = left < 4 ? COSC_EOVERRUN : 4;
+            break;
+        case 'h':
+        case 't':
+        case 'd':
+            sz = left < 8 ? COSC_EOVERRUN : 8;
+            break;
+        case 's':
+        case 'S':
+            sz = cosc_read_string(p, left, 0, 0, 0);
+            break;
+        case 'b':
+            sz = cosc_read_blob(p, left, 0, 0, 0, 0);
+            break;
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I':
+            view->type_index++;
+            continue;
+        default:
+            return COSC_ETYPE;
+        }
         if (sz < 0)
-        {
-            if (value_count) *value_count = vlen;
             return sz;
-        }
-        if (sz > COSC_SIZE_MAX - req)
-        {
-            if (value_count) *value_count = vlen;
-            return COSC_EOVERRUN;
-        }
-        req += sz;
-        if (buffer)
-            buffer = (const char *)buffer + sz;
-        tlen++;
-        if (sz > 0)
-        {
-            payload++;
-            vlen++;
-        }
+        view->last.offset = view->offset;
+        view->last.type = type;
+        if (view->args && view->count < view->args_max)
+            view->args[view->count] = view->last;
+        view->count++;
+        view->offset += sz;
+        view->array_values++;
+        view->type_index++;
+        return 1;
     }
-    if (value_count) *value_count = vlen;
-#ifndef COSC_NOARRAY
-    if (array_start && (tlen >= types_n || types[tlen] != ']'))
+    if (view->array_start)
         return COSC_ETYPE;
-#endif
-    return req;
+    view->done = 1;
+    return 0;
 }
 
-cosc_int32 cosc_write_message(
-    void *buffer,
-    cosc_int32 size,
-    const struct cosc_message *message,
-    cosc_int32 psize,
-    cosc_int32 *value_count
+static void cosc_message_view_rewind(
+    struct cosc_message_view *view
 )
 {
-    cosc_int32 req = 0, sz;
-    struct cosc_message tmp_message = {0, 0, 0, 0, {0}, 0};
+    view->count = 0;
+    view->offset = 0;
+    view->type_index = 1;
+    view->array_start = 0;
+    view->array_values = 0;
+    view->run_start = 0;
+    view->run_count = 0;
+    view->done = 0;
+}
 
-    if (!message)
-        message = &tmp_message;
-    sz = cosc_write_signature(
-        buffer ? buffer : 0, buffer ? size - req : 0,
-        message->address, message->address_n,
-        message->typetag, message->typetag_n,
-        psize
-    );
-    if (sz < 0)
+cosc_int32 cosc_message_view_setup(
+    struct cosc_message_view *view,
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_message_arg *args,
+    cosc_int32 args_max,
+    cosc_int32 *psize
+)
+{
+    cosc_int32 req;
+    cosc_memset(view, 0, sizeof(*view));
+    req = cosc_read_signature(buffer, size, &view->address, &view->address_n, &view->typetag, &view->typetag_n, psize);
+    if (psize)
     {
-        if (value_count) *value_count = 0;
-        return sz;
+        if (*psize < 8 || COSC_PAD(*psize) || *psize > COSC_SIZE_MAX - 4)
+            return COSC_EPSIZE;
     }
-    if (sz > COSC_SIZE_MAX - req)
+    if (req < 0)
+        return req;
+    if (!cosc_typetag_validate(view->typetag, view->typetag_n, 0))
+        return COSC_ETYPE;
+    if (psize)
     {
-        if (value_count) *value_count = 0;
-        return COSC_SIZE_MAX;
+        if (*psize + 4 < req)
+            return COSC_EPSIZE;
+        size = *psize + 4;
     }
-    req += sz;
-    sz = cosc_write_values(
-        (unsigned char *)buffer + req, size - req,
-        message->typetag, message->typetag_n,
-        message->values.write, message->values_n,
-        value_count
-    );
-    if (sz < 0)
-        return sz;
-    if (sz > COSC_SIZE_MAX - req)
-        return COSC_SIZE_MAX;
-    req += sz;
-    if (psize > 0)
+    view->values = (const unsigned char *)buffer + req;
+    view->values_size = size - req;
+    view->args = args;
+    view->args_max = args ? args_max : 0;
+    cosc_message_view_rewind(view);
+
+    // Fixed size values up front are resolved without reading them.
+    while (view->count < view->args_max)
     {
-        if (psize < req - 4 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4)
-            return COSC_EPSIZE;
-        cosc_write_int32(buffer, 4, psize);
+        cosc_int32 type = view->typetag[view->type_index];
+        if (type == 's' || type == 'S' || type == 'b' || type == '[' || type == 0)
+            break;
+        if (cosc_message_view_next(view) <= 0)
+            break;
     }
-    else if (psize < 0)
-        cosc_write_int32(buffer, 4, req - 4);
     return req;
 }
 
-cosc_int32 cosc_read_message(
-    const void *buffer,
+cosc_int32 cosc_message_view_get(
+    struct cosc_message_view *view,
+    cosc_int32 index,
+    char *type,
+    union cosc_value *value
+)
+{
+    struct cosc_message_arg arg;
+    cosc_int32 ret;
+    if (index < 0)
+        return COSC_EINVAL;
+    if (index >= view->args_max && index < view->count - 1)
+    {
+        // Past the cache, walk from the start unless it's in the run.
+        if (view->run_count == 0 || index < view->run_start || index >= view->run_start + view->run_count)
+            cosc_message_view_rewind(view);
+    }
+    while (index >= view->count && !view->done)
+    {
+        ret = cosc_message_view_next(view);
+        if (ret < 0)
+            return ret;
+    }
+    if (index >= view->count)
+        return COSC_EINVAL;
+    if (view->run_count > 0 && index >= view->run_start && index < view->run_start + view->run_count)
+    {
+        arg.type = view->run_type;
+        arg.offset = view->run_offset + (index - view->run_start) * (arg.type == 'h' || arg.type == 't' || arg.type == 'd' ? 8 : 4);
+    }
+    else if (index < view->args_max)
+        arg = view->args[index];
+    else
+        arg = view->last;
+    if (type)
+        *type = (char)arg.type;
+    return cosc_read_value(view->values + arg.offset, view->values_size - arg.offset, (char)arg.type, value);
+}
+
+cosc_int32 cosc_message_view_count(
+    struct cosc_message_view *view,
+    cosc_int32 *size
+)
+{
+    cosc_int32 ret;
+    while (!view->done)
+    {
+        ret = cosc_message_view_next(view);
+        if (ret < 0)
+            return ret;
+    }
+    if (size)
+        *size = view->offset;
+    return view->count;
+}
+
+/*
+ * One contiguous part of an edited message, the bytes of add followed
+ * by the bytes moved from src and zero padding up to dst_n.
+ */
+struct cosc_edit_part
+{
+    unsigned char *dst;
+    cosc_int32 dst_n;
+    const unsigned char *src;
+    cosc_int32 src_n;
+    const char *add;
+    cosc_int32 add_n;
+};
+
+static void cosc_edit_part_move(
+    const struct cosc_edit_part *part
+)
+{
+    cosc_memmove(part->dst + part->add_n, part->src, part->src_n);
+    if (part->add_n > 0)
+        cosc_memcpy(part->dst, part->add, part->add_n);
+    cosc_memset(part->dst + part->add_n + part->src_n, 0, part->dst_n - part->add_n - part->src_n);
+}
+
+cosc_int32 cosc_edit_message(
+    void *buffer,
     cosc_int32 size,
-    struct cosc_message *message,
-    cosc_int32 *psize,
-    cosc_int32 *value_count,
-    cosc_int32 exit_early
+    const void *message,
+    cosc_int32 message_size,
+    const struct cosc_message_edit *edit,
+    cosc_int32 psize
 )
 {
-    cosc_int32 req = 0, sz;
-    struct cosc_message tmp_message;
-    if (!message)
-        message = &tmp_message;
-    sz = cosc_read_signature(
-        buffer, size - req,
-        &message->address, &message->address_n,
-        &message->typetag, &message->typetag_n,
-        psize
-    );
-    if (psize)
+    static const struct cosc_message_edit no_edit = {0, 0, 0, 0, 0, 0, 0, 0};
+    struct cosc_edit_part parts[3];
+    const char *address, *typetag;
+    cosc_int32 address_n, typetag_n, sig, keep, prefix_n = 0, types_n = 0, append, req, len, i;
+    if (!edit)
+        edit = &no_edit;
+    sig = cosc_read_signature(message, message_size, &address, &address_n, &typetag, &typetag_n, 0);
+    if (sig < 0)
+        return sig;
+    if (!cosc_typetag_validate(typetag, typetag_n, 0))
+        return COSC_ETYPE;
+    if (edit->address_strip < 0 || edit->address_strip > address_n)
+        return COSC_EINVAL;
+    if (edit->remove < 0 || edit->remove > typetag_n - 1)
+        return COSC_EINVAL;
+    if (edit->address_prefix)
+        while (prefix_n < edit->address_prefix_n && edit->address_prefix[prefix_n] != 0)
+            prefix_n++;
+    if (edit->types)
     {
-        if (*psize < 8 || COSC_PAD(*psize) || *psize > COSC_SIZE_MAX - 4)
-            return COSC_EPSIZE;
+        while (types_n < edit->types_n && edit->types[types_n] != 0)
+        {
+            if (edit->types[types_n] == '[' || edit->types[types_n] == ']' || !cosc_typetag_char_validate(edit->types[types_n]))
+                return COSC_ETYPE;
+            types_n++;
+        }
     }
-    if (sz < 0)
+    if (edit->remove > 0 || types_n > 0)
     {
-        if (value_count) *value_count = 0;
-        return sz;
+        for (i = 1; i < typetag_n; i++)
+            if (typetag[i] == '[')
+                return COSC_ETYPE;
     }
-    if (sz > COSC_SIZE_MAX - req)
+
+    // Only the sizes of the values that are kept are needed.
+    keep = message_size - sig;
+    if (edit->remove > 0)
     {
-        if (value_count) *value_count = 0;
-        return COSC_SIZE_MAX;
+        keep = 0;
+        for (i = 1; i < typetag_n - edit->remove; i++)
+        {
+            cosc_int32 sz = cosc_read_value((const unsigned char *)message + sig + keep, message_size - sig - keep, typetag[i], 0);
+            if (sz < 0)
+                return sz;
+            keep += sz;
+        }
     }
-    req += sz;
-    buffer = (char *)buffer + sz;
-    sz = cosc_read_values(
-        buffer, size - req,
-        message->typetag, message->typetag_n,
-        message->values.read, message->values_n,
-        value_count, exit_early
-    );
+    append = cosc_write_values(0, 0, edit->types, types_n, edit->values, edit->values_n, 0);
+    if (append < 0)
+        return append;
+
+    req = psize ? 4 : 0;
+    len = prefix_n + address_n - edit->address_strip;
+    if (len > COSC_SIZE_MAX - req - 4)
+        return COSC_ESIZEMAX;
+    parts[0].dst_n = len + COSC_PADMUST(len);
+    req += parts[0].dst_n;
+    len = typetag_n - edit->remove + types_n;
+    if (len > COSC_SIZE_MAX - req - 4)
+        return COSC_ESIZEMAX;
+    parts[1].dst_n = len + COSC_PADMUST(len);
+    req += parts[1].dst_n;
+    if (keep > COSC_SIZE_MAX - req || append > COSC_SIZE_MAX - req - keep)
+        return COSC_ESIZEMAX;
+    req += keep + append;
+    if (psize > 0 && (psize < req - 4 || COSC_PAD(psize) || psize > COSC_SIZE_MAX - 4))
+        return COSC_EPSIZE;
+    if (!buffer)
+        return req;
+    if (req > size)
+        return COSC_EOVERRUN;
+
+    parts[0].dst = (unsigned char *)buffer + (psize ? 4 : 0);
+    parts[0].src = (const unsigned char *)address + edit->address_strip;
+    parts[0].src_n = address_n - edit->address_strip;
+    parts[0].add = edit->address_prefix;
+    parts[0].add_n = prefix_n;
+    parts[1].dst = parts[0].dst + parts[0].dst_n;
+    parts[1].src = (const unsigned char *)typetag;
+    parts[1].src_n = typetag_n - edit->remove;
+    parts[1].add = 0;
+    parts[1].add_n = 0;
+    parts[2].dst = parts[1].dst + parts[1].dst_n;
+    parts[2].dst_n = keep;
+    parts[2].src = (const unsigned char *)message + sig;
+    parts[2].src_n = keep;
+    parts[2].add = 0;
+    parts[2].add_n = 0;
+
+    /*
+     * When editing in place parts moving right are moved last to first
+     * and then parts moving left first to last, so no part overwrites
+     * bytes that have not been moved yet.
+     */
+    for (i = 2; i >= 0; i--)
+        if (parts[i].dst + parts[i].add_n > parts[i].src)
+            cosc_edit_part_move(parts + i);
+    for (i = 0; i < 3; i++)
+        if (parts[i].dst + parts[i].add_n <= parts[i].src)
+            cosc_edit_part_move(parts + i);
+    if (types_n > 0)
+    {
+        cosc_memcpy(parts[1].dst + parts[1].src_n, edit->types, types_n);
+        cosc_write_values(parts[2].dst + keep, append, edit->types, types_n, edit->values, edit->values_n, 0);
+    }
+
+    if (psize > 0)
+        cosc_write_int32(buffer, 4, psize);
+    else if (psize < 0)
+        cosc_write_int32(buffer, 4, req - 4);
+    return req;
+}
+
+static cosc_int32 cosc_packet_validate_message(
+    const unsigned char *buffer,
+    cosc_int32 size,
+    cosc_int32 flags,
+    struct cosc_packet_stats *stats
+)
+{
+    const char *address, *typetag;
+    cosc_int32 address_n, typetag_n, count = 0, sig, sz;
+    sig = cosc_read_signature(buffer, size, &address, &address_n, &typetag, &typetag_n, 0);
+    if (sig < 0)
+        return sig;
+    if ((flags & COSC_PACKET_ADDRESS) && !cosc_address_validate(address, address_n, 0))
+        return COSC_EINVAL;
+    if (!cosc_typetag_validate(typetag, typetag_n, 0))
+        return COSC_ETYPE;
+    sz = cosc_read_values(buffer + sig, size - sig, typetag, typetag_n, 0, 0, &count, 0);
+    stats->values += count;
     if (sz < 0)
-    {
-        if (value_count) *value_count = 0;
         return sz;
+    if (sz != size - sig)
+        return COSC_EPSIZE;
+    stats->messages++;
+    if (size > stats->message_size_max)
+        stats->message_size_max = size;
+    return size;
+}
+
+cosc_int32 cosc_packet_validate(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 flags,
+    struct cosc_packet_stats *stats
+)
+{
+    const unsigned char *bytes = (const unsigned char *)buffer;
+    struct cosc_packet_stats tmp_stats;
+    cosc_int32 ends[COSC_PACKET_DEPTH_MAX];
+    cosc_int32 depth = 0, offset = 0, end, ret;
+    if (!stats)
+        stats = &tmp_stats;
+    cosc_memset(stats, 0, sizeof(*stats));
+    if (size < 0 || size > COSC_SIZE_MAX)
+        return COSC_ESIZEMAX;
+    end = size;
+    if (flags & COSC_PACKET_PSIZE)
+    {
+        if (size < 4)
+            return COSC_EOVERRUN;
+        end = cosc_load_int32(bytes);
+        if (end < 8 || end > COSC_SIZE_MAX - 4 || COSC_PAD(end))
+            return COSC_EPSIZE;
+        if (end > size - 4)
+            return COSC_EOVERRUN;
+        offset = 4;
+        end += 4;
     }
-    if (sz > COSC_SIZE_MAX - req)
+    ret = end;
+
+    // Bundles push their end, elements are validated until all are popped.
+    while (1)
     {
-        if (value_count) *value_count = 0;
-        return COSC_SIZE_MAX;
+        if (end - offset >= 8 && bytes[offset] == '#')
+        {
+            if (end - offset < 16)
+                return COSC_EOVERRUN;
+            if (cosc_memcmp(bytes + offset, "#bundle", 8) != 0)
+                return COSC_ETYPE;
+            if (depth >= COSC_PACKET_DEPTH_MAX)
+                return COSC_ELEVELMAX;
+            ends[depth++] = end;
+            stats->bundles++;
+            if (depth > stats->depth)
+                stats->depth = depth;
+            offset += 16;
+        }
+        else
+        {
+            cosc_int32 sz = cosc_packet_validate_message(bytes + offset, end - offset, flags, stats);
+            if (sz < 0)
+                return sz;
+            offset = end;
+        }
+        while (depth > 0 && offset == ends[depth - 1])
+            depth--;
+        if (depth == 0)
+            break;
+        end = ends[depth - 1];
+        if (offset > end - 4)
+            return COSC_EOVERRUN;
+        cosc_int32 esize = cosc_load_int32(bytes + offset);
+        offset += 4;
+        if (esize < 0 || COSC_PAD(esize))
+            return COSC_EPSIZE;
+        if (esize > end - offset)
+            return COSC_EOVERRUN;
+        end = offset + esize;
     }
-    req += sz;
-    return req;
+    return ret;
 }
 
 #if !defined(COSC_NOSTDLIB) && !defined(COSC_NODUMP)
@@ -2145,6 +4334,15 @@ cosc_int32 cosc_message_dump(
 
 #define COSC_SERIAL_DOPSIZE(serial_) ((serial_)->level >= 0 || ((serial_)->flags & COSC_SERIAL_PSIZE))
 
+/*
+ * Writer buffer pointers, offsets are logical and include referenced
+ * bytes that are not in the buffer. COSC_SERIAL_WOUT() is NULL when
+ * measuring so that the cosc_write_*() functions only return sizes.
+ */
+#define COSC_SERIAL_WPTR(serial_, offset_) ((serial_)->wbuffer + (offset_) - (serial_)->ref)
+#define COSC_SERIAL_WOUT(serial_, offset_) ((serial_)->wbuffer ? COSC_SERIAL_WPTR(serial_, offset_) : 0)
+#define COSC_SERIAL_WLEVEL(serial_) ((serial_)->wbuffer + (serial_)->levels[(serial_)->level].start - (serial_)->levels[(serial_)->level].ref)
+
 static void cosc_serial_setup(
     struct cosc_serial *serial,
     void *wbuffer,
@@ -2171,7 +4369,30 @@ static void cosc_serial_setup(
     serial->level_max = levels ? level_max : 0;
     serial->level = -1;
     serial->size = 0;
-    serial->flags = flags;
+    serial->flags = flags & ~(cosc_uint32)COSC_SERIAL_MEASURE;
+    serial->iov = 0;
+    serial->iov_max = 0;
+    serial->iov_count = 0;
+    serial->iov_min = 0;
+    serial->ref = 0;
+}
+
+/*
+ * Get a byte of the current message typetag, tt is a buffer offset
+ * or when measuring an index in the typetag the message level was
+ * started with.
+ */
+static cosc_int32 cosc_serial_ttchar(
+    const struct cosc_serial *serial,
+    cosc_int32 tt
+)
+{
+    if (COSC_SERIAL_ISREADER(serial))
+        return serial->rbuffer[tt];
+    if (serial->wbuffer)
+        return serial->wbuffer[tt];
+    const struct cosc_level *level = serial->levels + serial->level;
+    return tt < level->typetag_n ? (unsigned char)level->typetag[tt] : 0;
 }
 
 static cosc_int32 cosc_serial_next_msgtype(
@@ -2182,16 +4403,27 @@ static cosc_int32 cosc_serial_next_msgtype(
         return 0;
     if (serial->levels[serial->level].type != COSC_LEVEL_TYPE_MESSAGE)
         return 0;
-    const unsigned char *buffer = COSC_SERIAL_ISREADER(serial) ? serial->rbuffer : serial->wbuffer;
     cosc_int32 offset = serial->levels[serial->level].ttstart;
     offset += serial->levels[serial->level].ttindex;
-    if (!buffer[offset])
+    if (!cosc_serial_ttchar(serial, offset))
         return 0;
     offset++;
     if (offset >= serial->levels[serial->level].ttend)
         return 0;
     serial->levels[serial->level].ttindex = offset - serial->levels[serial->level].ttstart;
-    return buffer[offset];
+    return cosc_serial_ttchar(serial, offset);
+}
+
+/*
+ * The referenced bytes of an iovec writer count towards the offsets
+ * but not the buffer, so they are added to the capacity here instead
+ * of modifying buffer_size.
+ */
+static cosc_int32 cosc_serial_get_capacity(
+    const struct cosc_serial *serial
+)
+{
+    return serial->buffer_size + serial->ref;
 }
 
 static cosc_int32 cosc_serial_get_available(
@@ -2199,7 +4431,7 @@ static cosc_int32 cosc_serial_get_available(
 )
 {
     if (serial->level < 0)
-        return serial->buffer_size - serial->size;
+        return cosc_serial_get_capacity(serial) - serial->size;
     return serial->levels[serial->level].size_max - serial->levels[serial->level].size;
 }
 
@@ -2267,15 +4499,18 @@ static cosc_int32 cosc_serial_start_level(
     else
     {
         level->start = serial->size;
-        level->size_max = serial->buffer_size - serial->size;
+        level->size_max = cosc_serial_get_capacity(serial) - serial->size;
     }
     if (req_size > level->size_max)
         return COSC_EOVERRUN;
     level->type = level_type;
+    level->ref = serial->ref;
     level->size = 0;
     level->ttstart = 0;
     level->ttindex = 0;
     level->ttend = 0;
+    level->typetag = 0;
+    level->typetag_n = 0;
     serial->level++;
     return serial->level;
 }
@@ -2347,18 +4582,128 @@ static cosc_int32 cosc_serial_repeat(
         return type;
     if (type != ']')
         return COSC_EMSGTYPE;
-    const char *buffer = (const char *)(COSC_SERIAL_ISREADER(serial) ? serial->rbuffer : serial->wbuffer);
     cosc_int32 offset = serial->levels[serial->level].ttstart;
     offset += serial->levels[serial->level].ttindex;
-    while (offset > serial->levels[serial->level].ttstart + 1 && buffer[offset] != '[')
+    while (offset > serial->levels[serial->level].ttstart + 1 && cosc_serial_ttchar(serial, offset) != '[')
         offset--;
-    if (buffer[offset] != '[')
+    if (cosc_serial_ttchar(serial, offset) != '[')
         return COSC_EMSGTYPE;
     serial->levels[serial->level].ttindex = offset - serial->levels[serial->level].ttstart;
 #endif
     return 0;
 }
 
+/*
+ * Start a run of at most n values of a fixed size numeric type. In a
+ * message an array start is stepped over and an array end repeats the
+ * array. Returns the number of values in the run and stores the
+ * offset of the first value in offset, on failure the typetag
+ * position is left untouched.
+ */
+static cosc_int32 cosc_serial_start_run(
+    struct cosc_serial *serial,
+    cosc_int32 type,
+    cosc_int32 width,
+    cosc_int32 n,
+    cosc_int32 *offset
+)
+{
+    if (serial->level < 0)
+        return COSC_ELEVELTYPE;
+    struct cosc_level *level = serial->levels + serial->level;
+    cosc_int32 ttindex = level->ttindex;
+    cosc_int32 run = n;
+    if (level->type == COSC_LEVEL_TYPE_MESSAGE)
+    {
+        cosc_int32 t = cosc_serial_get_msgtype(serial);
+#ifndef COSC_NOARRAY
+        if (t == ']')
+        {
+            cosc_int32 ret = cosc_serial_repeat(serial);
+            if (ret < 0)
+                return ret;
+            t = cosc_serial_get_msgtype(serial);
+        }
+        if (t == '[')
+        {
+            cosc_serial_next_msgtype(serial);
+            t = cosc_serial_get_msgtype(serial);
+        }
+#endif
+        if (t != type)
+        {
+            level->ttindex = ttindex;
+            return COSC_EMSGTYPE;
+        }
+        cosc_int32 tt = level->ttstart + level->ttindex;
+        run = 1;
+        while (run < n && tt + run < level->ttend && cosc_serial_ttchar(serial, tt + run) == type)
+            run++;
+    }
+    else if (level->type != COSC_LEVEL_TYPE_BLOB)
+        return COSC_ELEVELTYPE;
+    if (run > cosc_serial_get_available(serial) / width)
+    {
+        level->ttindex = ttindex;
+        return COSC_EOVERRUN;
+    }
+    *offset = cosc_serial_get_offset(serial);
+    return run;
+}
+
+static void cosc_serial_end_run(
+    struct cosc_serial *serial,
+    cosc_int32 width,
+    cosc_int32 run
+)
+{
+    struct cosc_level *level = serial->levels + serial->level;
+    level->size += run * width;
+    if (level->type == COSC_LEVEL_TYPE_MESSAGE)
+    {
+        level->ttindex += run - 1;
+        cosc_serial_next_msgtype(serial);
+    }
+}
+
+/*
+ * Write (wvalues) or read (rvalues) n values of a fixed size numeric
+ * type in as few runs as the typetag allows.
+ */
+static cosc_int32 cosc_serial_array(
+    struct cosc_serial *serial,
+    cosc_int32 type,
+    cosc_int32 width,
+    void *rvalues,
+    const void *wvalues,
+    cosc_int32 values_n
+)
+{
+    cosc_int32 req = 0;
+    for (cosc_int32 i = 0; i < values_n;)
+    {
+        cosc_int32 offset = 0;
+        cosc_int32 run = cosc_serial_start_run(serial, type, width, values_n - i, &offset);
+        if (run < 0)
+            return run;
+        if (COSC_SERIAL_ISREADER(serial))
+        {
+            if (rvalues)
+                cosc_swap_n((unsigned char *)rvalues + i * width, serial->rbuffer + offset, type, run);
+        }
+        else if (!serial->wbuffer)
+            ;
+        else if (wvalues)
+            cosc_swap_n(COSC_SERIAL_WPTR(serial, offset), (const unsigned char *)wvalues + i * width, type, run);
+        else
+            cosc_memset(COSC_SERIAL_WPTR(serial, offset), 0, run * width);
+        cosc_serial_end_run(serial, width, run);
+        req += run * width;
+        i += run;
+    }
+    return req;
+}
+
 cosc_int32 cosc_serial_get_buffer_size(
     const struct cosc_serial *serial
 )
@@ -2386,9 +4731,7 @@ cosc_int32 cosc_serial_get_msgtype(
     tt += serial->levels[serial->level].ttindex;
     if (tt >= serial->levels[serial->level].ttend)
         return 0;
-    if (COSC_SERIAL_ISREADER(serial))
-        return serial->rbuffer[tt];
-    return serial->wbuffer[tt];
+    return cosc_serial_ttchar(serial, tt);
 }
 
 void cosc_serial_reset(
@@ -2397,12 +4740,52 @@ void cosc_serial_reset(
 {
     serial->size = 0;
     serial->level = -1;
+    serial->ref = 0;
+    serial->iov_count = 0;
 }
 
 #endif /* !COSC_NOWRITER && !COSC_NOREADER */
 
 #ifndef COSC_NOWRITER
 
+static cosc_int32 cosc_serial_referable(
+    const struct cosc_serial *serial,
+    cosc_int32 n
+)
+{
+    return serial->iov && n > 0 && n >= serial->iov_min
+        && serial->iov_count <= serial->iov_max - 3
+        && n <= COSC_SIZE_MAX - cosc_serial_get_capacity(serial);
+}
+
+/*
+ * Reference n bytes at the current position instead of copying them,
+ * the buffer up to the current position becomes a segment followed by
+ * the referenced segment. Check with cosc_serial_referable() first.
+ */
+static void cosc_serial_reference(
+    struct cosc_serial *serial,
+    const void *value,
+    cosc_int32 n
+)
+{
+    cosc_int32 cut = 0;
+    if (serial->iov_count > 0)
+    {
+        const struct cosc_iovec *last = serial->iov + serial->iov_count - 2;
+        cut = (cosc_int32)((const unsigned char *)last->base - serial->wbuffer) + (cosc_int32)last->len;
+    }
+    serial->iov[serial->iov_count].base = serial->wbuffer + cut;
+    serial->iov[serial->iov_count].len = (COSC_TYPE_SIZE)(cosc_serial_get_offset(serial) - serial->ref - cut);
+    serial->iov[serial->iov_count + 1].base = (void *)value;
+    serial->iov[serial->iov_count + 1].len = (COSC_TYPE_SIZE)n;
+    serial->iov_count += 2;
+    serial->ref += n;
+    for (cosc_int32 i = 0; i <= serial->level; i++)
+        serial->levels[i].size_max += n;
+    serial->levels[serial->level].size += n;
+}
+
 void cosc_writer_setup(
     struct cosc_serial *serial,
     void *buffer,
@@ -2415,6 +4798,63 @@ void cosc_writer_setup(
     cosc_serial_setup(serial, buffer, 0, buffer_size, levels, level_max, flags);
 }
 
+void cosc_measure_setup(
+    struct cosc_serial *serial,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+)
+{
+    cosc_serial_setup(serial, 0, 0, 0, levels, level_max, flags);
+    serial->buffer_size = COSC_SIZE_MAX;
+    serial->flags |= COSC_SERIAL_MEASURE;
+}
+
+void cosc_writer_setup_iovec(
+    struct cosc_serial *serial,
+    void *buffer,
+    cosc_int32 buffer_size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags,
+    struct cosc_iovec *iov,
+    cosc_int32 iov_max,
+    cosc_int32 iov_min
+)
+{
+    cosc_serial_setup(serial, buffer, 0, buffer_size, levels, level_max, flags);
+    serial->iov = iov;
+    serial->iov_max = iov ? iov_max : 0;
+    serial->iov_min = iov_min;
+}
+
+cosc_int32 cosc_writer_finish_iovec(
+    struct cosc_serial *serial
+)
+{
+    if (!COSC_SERIAL_ISWRITER(serial) || !serial->iov || serial->iov_count >= serial->iov_max)
+        return COSC_EINVAL;
+    if (serial->level >= 0)
+        return COSC_ELEVELTYPE;
+    cosc_int32 cut = 0;
+    if (serial->iov_count > 0)
+    {
+        const struct cosc_iovec *last = serial->iov + serial->iov_count - 2;
+        cut = (cosc_int32)((const unsigned char *)last->base - serial->wbuffer) + (cosc_int32)last->len;
+    }
+    serial->iov[serial->iov_count].base = serial->wbuffer + cut;
+    serial->iov[serial->iov_count].len = (COSC_TYPE_SIZE)(serial->size - serial->ref - cut);
+    serial->iov_count++;
+    cosc_int32 count = 0;
+    for (cosc_int32 i = 0; i < serial->iov_count; i++)
+    {
+        if (serial->iov[i].len > 0)
+            serial->iov[count++] = serial->iov[i];
+    }
+    serial->iov_count = count;
+    return count;
+}
+
 cosc_int32 cosc_writer_start_bundle(
     struct cosc_serial *serial,
     cosc_uint64 timetag
@@ -2427,7 +4867,7 @@ cosc_int32 cosc_writer_start_bundle(
         return COSC_EPSIZEFLAG;
     cosc_int32 available = cosc_serial_get_available(serial);
     cosc_int32 offset = cosc_serial_get_offset(serial);
-    cosc_int32 sz = cosc_write_bundle(serial->wbuffer + offset, available, timetag, use_psize ? -1 : 0);
+    cosc_int32 sz = cosc_write_bundle(COSC_SERIAL_WOUT(serial, offset), available, timetag, use_psize ? -1 : 0);
     if (sz < 0)
         return sz;
     cosc_int32 level = cosc_serial_start_level(serial, COSC_LEVEL_TYPE_BUNDLE);
@@ -2445,8 +4885,8 @@ cosc_int32 cosc_writer_end_bundle(
         return COSC_EINVAL;
     if (serial->level < 0 || serial->levels[serial->level].type != COSC_LEVEL_TYPE_BUNDLE)
         return COSC_ELEVELTYPE;
-    if (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE))
-        cosc_store_int32(serial->wbuffer + serial->levels[serial->level].start, serial->levels[serial->level].size - 4);
+    if (serial->wbuffer && (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE)))
+        cosc_store_int32(COSC_SERIAL_WLEVEL(serial), serial->levels[serial->level].size - 4);
     cosc_serial_end_level(serial);
     return 0;
 }
@@ -2473,23 +4913,34 @@ cosc_int32 cosc_writer_start_message(
         return COSC_EOVERRUN;
     if (use_psize)
         req += 4;
-    cosc_int32 address_size = cosc_write_string(serial->wbuffer + offset + req, available - req, address, address_n, 0);
+    cosc_int32 address_size = cosc_write_string(COSC_SERIAL_WOUT(serial, offset + req), available - req, address, address_n, 0);
     if (address_size < 0)
         return address_size;
     req += address_size;
-    cosc_int32 typetag_size = cosc_write_string(serial->wbuffer + offset + req, available - req, typetag, typetag_n, 0);
+    cosc_int32 typetag_size = cosc_write_string(COSC_SERIAL_WOUT(serial, offset + req), available - req, typetag, typetag_n, 0);
     if (typetag_size < 0)
         return typetag_size;
     req += typetag_size;
-    if (use_psize)
-        cosc_store_int32(serial->wbuffer + offset, req);
+    if (req > available)
+        return COSC_EOVERRUN;
+    if (use_psize && serial->wbuffer)
+        cosc_store_int32(COSC_SERIAL_WPTR(serial, offset), req);
     cosc_int32 level = cosc_serial_start_level(serial, COSC_LEVEL_TYPE_MESSAGE);
     if (level < 0)
         return level;
     serial->levels[level].size += req;
-    serial->levels[level].ttstart = serial->levels[level].start + address_size;
-    if (use_psize)
-        serial->levels[level].ttstart += 4;
+    if (serial->wbuffer)
+    {
+        serial->levels[level].ttstart = serial->levels[level].start - serial->ref + address_size;
+        if (use_psize)
+            serial->levels[level].ttstart += 4;
+    }
+    else
+    {
+        serial->levels[level].typetag = typetag;
+        while (serial->levels[level].typetag_n < typetag_n && typetag[serial->levels[level].typetag_n])
+            serial->levels[level].typetag_n++;
+    }
     serial->levels[level].ttend = serial->levels[level].ttstart + typetag_size;
     cosc_serial_next_msgtype(serial);
     return req;
@@ -2514,8 +4965,8 @@ cosc_int32 cosc_writer_end_message(
             return sz;
         add += sz;
     }
-    if (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE))
-        cosc_store_int32(serial->wbuffer + serial->levels[serial->level].start, serial->levels[serial->level].size - 4);
+    if (serial->wbuffer && (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE)))
+        cosc_store_int32(COSC_SERIAL_WLEVEL(serial), serial->levels[serial->level].size - 4);
     cosc_serial_end_level(serial);
     return add;
 }
@@ -2528,7 +4979,7 @@ cosc_int32 cosc_writer_start_blob(
         return COSC_EINVAL;
     cosc_int32 available = cosc_serial_get_available(serial);
     cosc_int32 offset = cosc_serial_get_offset(serial);
-    cosc_int32 sz = cosc_write_int32(serial->wbuffer + offset, available, 0);
+    cosc_int32 sz = cosc_write_int32(COSC_SERIAL_WOUT(serial, offset), available, 0);
     if (sz < 0)
         return sz;
     cosc_int32 level = cosc_serial_start_level(serial, COSC_LEVEL_TYPE_BLOB);
@@ -2548,11 +4999,12 @@ cosc_int32 cosc_writer_end_blob(
         return COSC_ELEVELTYPE;
     cosc_int32 available = cosc_serial_get_available(serial);
     cosc_int32 pad = COSC_PAD(serial->levels[serial->level].size);
-    if (serial->levels[serial->level].size > available - pad)
+    if (pad > available)
         return COSC_EOVERRUN;
-    if (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE))
-        cosc_store_int32(serial->wbuffer + serial->levels[serial->level].start, serial->levels[serial->level].size - 4);
-    cosc_memset(serial->wbuffer + serial->levels[serial->level].start + serial->levels[serial->level].size, 0, pad);
+    if (serial->wbuffer && (serial->level > 0 || (serial->flags & COSC_SERIAL_PSIZE)))
+        cosc_store_int32(COSC_SERIAL_WLEVEL(serial), serial->levels[serial->level].size - 4);
+    if (serial->wbuffer)
+        cosc_memset(COSC_SERIAL_WPTR(serial, cosc_serial_get_offset(serial)), 0, pad);
     serial->levels[serial->level].size += pad;
     cosc_serial_end_level(serial);
     cosc_serial_next_msgtype(serial);
@@ -2569,7 +5021,7 @@ cosc_int32 cosc_writer_uint32(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'r', 4);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_uint32(serial->wbuffer + offset, 4, value));
+    return cosc_serial_end_scalar(serial, cosc_write_uint32(COSC_SERIAL_WOUT(serial, offset), 4, value));
 }
 
 cosc_int32 cosc_writer_int32(
@@ -2582,7 +5034,7 @@ cosc_int32 cosc_writer_int32(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'i', 4);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_int32(serial->wbuffer + offset, 4, value));
+    return cosc_serial_end_scalar(serial, cosc_write_int32(COSC_SERIAL_WOUT(serial, offset), 4, value));
 }
 
 cosc_int32 cosc_writer_float32(
@@ -2595,7 +5047,7 @@ cosc_int32 cosc_writer_float32(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'f', 4);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_float32(serial->wbuffer + offset, 4, value));
+    return cosc_serial_end_scalar(serial, cosc_write_float32(COSC_SERIAL_WOUT(serial, offset), 4, value));
 }
 
 cosc_int32 cosc_writer_uint64(
@@ -2608,7 +5060,7 @@ cosc_int32 cosc_writer_uint64(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 't', 8);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_uint64(serial->wbuffer + offset, 8, value));
+    return cosc_serial_end_scalar(serial, cosc_write_uint64(COSC_SERIAL_WOUT(serial, offset), 8, value));
 }
 
 cosc_int32 cosc_writer_int64(
@@ -2621,7 +5073,7 @@ cosc_int32 cosc_writer_int64(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'h', 8);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_int64(serial->wbuffer + offset, 8, value));
+    return cosc_serial_end_scalar(serial, cosc_write_int64(COSC_SERIAL_WOUT(serial, offset), 8, value));
 }
 
 cosc_int32 cosc_writer_float64(
@@ -2634,7 +5086,51 @@ cosc_int32 cosc_writer_float64(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'd', 8);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_float64(serial->wbuffer + offset, 8, value));
+    return cosc_serial_end_scalar(serial, cosc_write_float64(COSC_SERIAL_WOUT(serial, offset), 8, value));
+}
+
+cosc_int32 cosc_writer_int32_array(
+    struct cosc_serial *serial,
+    const cosc_int32 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISWRITER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'i', 4, 0, values, values_n);
+}
+
+cosc_int32 cosc_writer_float32_array(
+    struct cosc_serial *serial,
+    const cosc_float32 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISWRITER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'f', 4, 0, values, values_n);
+}
+
+cosc_int32 cosc_writer_int64_array(
+    struct cosc_serial *serial,
+    const cosc_int64 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISWRITER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'h', 8, 0, values, values_n);
+}
+
+cosc_int32 cosc_writer_float64_array(
+    struct cosc_serial *serial,
+    const cosc_float64 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISWRITER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'd', 8, 0, values, values_n);
 }
 
 cosc_int32 cosc_writer_string(
@@ -2650,9 +5146,23 @@ cosc_int32 cosc_writer_string(
     if (offset < 0)
         return offset;
     cosc_int32 available = cosc_serial_get_available(serial);
-    cosc_int32 sz = cosc_write_string(serial->wbuffer + offset, available, value, value_n, length);
+    cosc_int32 len = 0;
+    cosc_int32 sz = cosc_write_string(0, 0, value, value_n, &len);
+    if (sz >= 0 && sz - len <= available && cosc_serial_referable(serial, len))
+    {
+        cosc_serial_reference(serial, value, len);
+        cosc_memset(COSC_SERIAL_WPTR(serial, offset + len), 0, sz - len);
+        serial->levels[serial->level].size += sz - len;
+        cosc_serial_next_msgtype(serial);
+        if (length)
+            *length = len;
+        return sz;
+    }
+    sz = cosc_write_string(COSC_SERIAL_WOUT(serial, offset), available, value, value_n, length);
     if (sz < 0)
         return sz;
+    if (sz > available)
+        return COSC_EOVERRUN;
     serial->levels[serial->level].size += sz;
     cosc_serial_next_msgtype(serial);
     return sz;
@@ -2670,9 +5180,22 @@ cosc_int32 cosc_writer_blob(
     if (offset < 0)
         return offset;
     cosc_int32 available = cosc_serial_get_available(serial);
-    cosc_int32 sz = cosc_write_blob(serial->wbuffer + offset, available, value, value_n);
+    cosc_int32 sz = cosc_write_blob(0, 0, value, value_n);
+    if (value && sz >= 0 && sz - value_n <= available && cosc_serial_referable(serial, value_n))
+    {
+        cosc_store_int32(COSC_SERIAL_WPTR(serial, offset), value_n);
+        serial->levels[serial->level].size += 4;
+        cosc_serial_reference(serial, value, value_n);
+        cosc_memset(COSC_SERIAL_WPTR(serial, offset + 4 + value_n), 0, sz - 4 - value_n);
+        serial->levels[serial->level].size += sz - 4 - value_n;
+        cosc_serial_next_msgtype(serial);
+        return sz;
+    }
+    sz = cosc_write_blob(COSC_SERIAL_WOUT(serial, offset), available, value, value_n);
     if (sz < 0)
         return sz;
+    if (sz > available)
+        return COSC_EOVERRUN;
     serial->levels[serial->level].size += sz;
     cosc_serial_next_msgtype(serial);
     return sz;
@@ -2688,7 +5211,7 @@ cosc_int32 cosc_writer_char(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'c', 4);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_int32(serial->wbuffer + offset, 4, value));
+    return cosc_serial_end_scalar(serial, cosc_write_int32(COSC_SERIAL_WOUT(serial, offset), 4, value));
 }
 
 cosc_int32 cosc_writer_midi(
@@ -2701,7 +5224,7 @@ cosc_int32 cosc_writer_midi(
     cosc_int32 offset = cosc_serial_start_scalar(serial, 'm', 4);
     if (offset < 0)
         return offset;
-    return cosc_serial_end_scalar(serial, cosc_write_midi(serial->wbuffer + offset, 4, value));
+    return cosc_serial_end_scalar(serial, cosc_write_midi(COSC_SERIAL_WOUT(serial, offset), 4, value));
 }
 
 cosc_int32 cosc_writer_value(
@@ -2777,9 +5300,11 @@ cosc_int32 cosc_writer_message(
     }
     cosc_int32 available = cosc_serial_get_available(serial);
     cosc_int32 offset = cosc_serial_get_offset(serial);
-    cosc_int32 sz = cosc_write_message(serial->wbuffer + offset, available, message, use_psize ? -1 : 0, value_count);
+    cosc_int32 sz = cosc_write_message(COSC_SERIAL_WOUT(serial, offset), available, message, use_psize ? -1 : 0, value_count);
     if (sz < 0)
         return sz;
+    if (sz > available)
+        return COSC_EOVERRUN;
     if (serial->level >= 0)
         serial->levels[serial->level].size += sz;
     else
@@ -2787,6 +5312,106 @@ cosc_int32 cosc_writer_message(
     return sz;
 }
 
+/*
+ * Fields for the typetag plan cached by cosc_writer_messages(), typetags
+ * with more fields are written with cosc_write_values() instead.
+ */
+#define COSC_WRITER_PLAN_FIELDS 32
+
+static cosc_int32 cosc_typetag_equal(
+    const char *a,
+    cosc_int32 a_n,
+    const char *b,
+    cosc_int32 b_n
+)
+{
+    cosc_int32 i;
+    if (a == b && a_n == b_n)
+        return 1;
+    if (!a || !b)
+        return 0;
+    for (i = 0; i < a_n && i < b_n && a[i] != 0; i++)
+    {
+        if (a[i] != b[i])
+            return 0;
+    }
+    return (i < a_n ? a[i] : 0) == (i < b_n ? b[i] : 0);
+}
+
+cosc_int32 cosc_writer_messages(
+    struct cosc_serial *serial,
+    const struct cosc_message *messages,
+    cosc_int32 messages_n,
+    cosc_int32 *message_count
+)
+{
+    struct cosc_plan_field fields[COSC_WRITER_PLAN_FIELDS];
+    struct cosc_typetag_plan plan;
+    const char *typetag = 0;
+    cosc_int32 typetag_n = 0, planned = 0, req = 0, i = 0, sz = 0;
+    if (message_count) *message_count = 0;
+    if (!COSC_SERIAL_ISWRITER(serial) || messages_n < 0 || (messages_n > 0 && !messages))
+        return COSC_EINVAL;
+    cosc_int32 use_psize = COSC_SERIAL_DOPSIZE(serial);
+    if (serial->level < 0 && (serial->size > 0 || messages_n > 1) && !use_psize)
+        return COSC_EPSIZEFLAG;
+    if (serial->level >= 0
+        && serial->levels[serial->level].type != COSC_LEVEL_TYPE_BUNDLE
+        && serial->levels[serial->level].type != COSC_LEVEL_TYPE_BLOB)
+        return COSC_ELEVELTYPE;
+    cosc_int32 head = use_psize ? 4 : 0;
+    cosc_int32 available = cosc_serial_get_available(serial);
+    unsigned char *p = COSC_SERIAL_WOUT(serial, cosc_serial_get_offset(serial));
+    unsigned char *q = 0;
+    for (i = 0; i < messages_n; i++)
+    {
+        const struct cosc_message *message = messages + i;
+        if (p)
+            q = p + req + head;
+        sz = cosc_write_signature(
+            q, available - req - head,
+            message->address, message->address_n,
+            message->typetag, message->typetag_n,
+            0
+        );
+        if (sz < 0)
+            break;
+        cosc_int32 msize = sz;
+        if (i == 0 || !cosc_typetag_equal(typetag, typetag_n, message->typetag, message->typetag_n))
+        {
+            typetag = message->typetag;
+            typetag_n = message->typetag_n;
+            planned = cosc_typetag_plan_compile(&plan, fields, COSC_WRITER_PLAN_FIELDS, typetag, typetag_n) >= 0;
+        }
+        if (planned)
+            sz = cosc_write_values_plan(
+                q ? q + msize : 0, available - req - head - msize,
+                &plan, message->values.write, message->values_n, 0
+            );
+        else
+            sz = cosc_write_values(
+                q ? q + msize : 0, available - req - head - msize,
+                message->typetag, message->typetag_n,
+                message->values.write, message->values_n, 0
+            );
+        if (sz >= 0 && sz > available - req - head - msize)
+            sz = COSC_EOVERRUN;
+        if (sz < 0)
+            break;
+        msize += sz;
+        if (use_psize && p)
+            cosc_store_int32(p + req, msize);
+        req += head + msize;
+        sz = 0;
+    }
+    if (serial->level >= 0)
+        serial->levels[serial->level].size += req;
+    else
+        serial->size += req;
+    if (message_count) *message_count = i;
+    return sz < 0 ? sz : req;
+}
+
 cosc_int32 cosc_writer_bytes(
     struct cosc_serial *serial,
     const void *value,
@@ -2797,16 +5422,23 @@ cosc_int32 cosc_writer_bytes(
         return COSC_EINVAL;
     if (serial->level < 0 || serial->levels[serial->level].type != COSC_LEVEL_TYPE_BLOB)
         return COSC_ELEVELTYPE;
+    if (value && cosc_serial_referable(serial, value_n))
+    {
+        cosc_serial_reference(serial, value, value_n);
+        return value_n;
+    }
     cosc_int32 available = cosc_serial_get_available(serial);
     if (value_n > available)
         return COSC_EOVERRUN;
     else if (value_n < 0)
         value_n = 0;
     cosc_int32 offset = cosc_serial_get_offset(serial);
-    if (value)
-        cosc_memcpy(serial->wbuffer + offset, value, value_n);
+    if (!serial->wbuffer)
+        ;
+    else if (value)
+        cosc_memcpy(COSC_SERIAL_WPTR(serial, offset), value, value_n);
     else
-        cosc_memset(serial->wbuffer + offset, 0, value_n);
+        cosc_memset(COSC_SERIAL_WPTR(serial, offset), 0, value_n);
     serial->levels[serial->level].size += value_n;
     return value_n;
 }
@@ -3124,6 +5756,50 @@ cosc_int32 cosc_reader_float64(
     return cosc_serial_end_scalar(serial, cosc_read_float64(serial->rbuffer + offset, 8, value));
 }
 
+cosc_int32 cosc_reader_int32_array(
+    struct cosc_serial *serial,
+    cosc_int32 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISREADER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'i', 4, values, 0, values_n);
+}
+
+cosc_int32 cosc_reader_float32_array(
+    struct cosc_serial *serial,
+    cosc_float32 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISREADER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'f', 4, values, 0, values_n);
+}
+
+cosc_int32 cosc_reader_int64_array(
+    struct cosc_serial *serial,
+    cosc_int64 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISREADER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'h', 8, values, 0, values_n);
+}
+
+cosc_int32 cosc_reader_float64_array(
+    struct cosc_serial *serial,
+    cosc_float64 *values,
+    cosc_int32 values_n
+)
+{
+    if (!COSC_SERIAL_ISREADER(serial))
+        return COSC_EINVAL;
+    return cosc_serial_array(serial, 'd', 8, values, 0, values_n);
+}
+
 cosc_int32 cosc_reader_string(
     struct cosc_serial *serial,
     char *value,
@@ -3320,4 +5996,647 @@ cosc_int32 cosc_reader_repeat(
     return cosc_serial_repeat(serial);
 }
 
+/*
+ * Make n bytes of the current element contiguous without consuming
+ * them. Returns 1 and stores the bytes in data if available, 0 if more
+ * data is required. The element is copied to the tail buffer only if
+ * it is split between chunks.
+ */
+static cosc_int32 cosc_stream_gather(
+    struct cosc_stream *stream,
+    cosc_int32 n,
+    const unsigned char **data
+)
+{
+    cosc_int32 left = stream->chunk_size - stream->chunk_offset;
+    if (stream->tail == 0 && left >= n)
+    {
+        *data = stream->chunk + stream->chunk_offset;
+        return 1;
+    }
+    if (stream->tail < n)
+    {
+        if (n > stream->buffer_size)
+            return COSC_EOVERRUN;
+        cosc_int32 take = n - stream->tail;
+        if (take > left)
+            take = left;
+        cosc_memcpy(stream->buffer + stream->tail, stream->chunk + stream->chunk_offset, take);
+        stream->tail += take;
+        stream->chunk_offset += take;
+        if (stream->tail < n)
+            return 0;
+    }
+    *data = stream->buffer;
+    return 1;
+}
+
+static void cosc_stream_consume(
+    struct cosc_stream *stream,
+    cosc_int32 n
+)
+{
+    if (stream->tail > 0)
+        stream->tail = 0;
+    else
+        stream->chunk_offset += n;
+}
+
+void cosc_stream_setup(
+    struct cosc_stream *stream,
+    void *buffer,
+    cosc_int32 buffer_size,
+    struct cosc_level *levels,
+    cosc_int32 level_max
+)
+{
+    stream->buffer = (unsigned char *)buffer;
+    stream->buffer_size = buffer ? (buffer_size < COSC_SIZE_MAX ? buffer_size : COSC_SIZE_MAX) : 0;
+    stream->tail = 0;
+    stream->chunk = 0;
+    stream->chunk_size = 0;
+    stream->chunk_offset = 0;
+    stream->psize = -1;
+    stream->levels = levels;
+    stream->level_max = levels ? level_max : 0;
+    stream->level = -1;
+}
+
+cosc_int32 cosc_stream_feed(
+    struct cosc_stream *stream,
+    const void *chunk,
+    cosc_int32 chunk_size
+)
+{
+    if (stream->chunk_offset < stream->chunk_size)
+        return COSC_EINVAL;
+    stream->chunk = (const unsigned char *)chunk;
+    stream->chunk_size = chunk ? (chunk_size > 0 ? chunk_size : 0) : 0;
+    stream->chunk_offset = 0;
+    return 0;
+}
+
+cosc_int32 cosc_stream_next(
+    struct cosc_stream *stream,
+    struct cosc_stream_event *event
+)
+{
+    const unsigned char *data = 0;
+    cosc_int32 ret;
+    event->data = 0;
+    event->size = 0;
+    if (stream->psize < 0 && stream->level >= 0
+        && stream->levels[stream->level].size >= stream->levels[stream->level].size_max)
+    {
+        event->type = COSC_EVENT_BUNDLE_END;
+        event->level = stream->level--;
+        return event->type;
+    }
+    if (stream->psize < 0)
+    {
+        ret = cosc_stream_gather(stream, 4, &data);
+        if (ret <= 0)
+            return ret;
+        cosc_int32 psize = cosc_load_int32(data);
+        if (psize < 8 || psize > COSC_SIZE_MAX - 4 || COSC_PAD(psize))
+            return COSC_EPSIZE;
+        if (stream->level >= 0)
+        {
+            struct cosc_level *level = stream->levels + stream->level;
+            if (psize > level->size_max - level->size - 4)
+                return COSC_EPSIZE;
+            level->size += psize + 4;
+        }
+        cosc_stream_consume(stream, 4);
+        stream->psize = psize;
+    }
+    ret = cosc_stream_gather(stream, 1, &data);
+    if (ret <= 0)
+        return ret;
+    if (data[0] == '#')
+    {
+        if (stream->level >= stream->level_max - 1)
+            return COSC_ELEVELMAX;
+        if (stream->psize < 16)
+            return COSC_EPSIZE;
+        ret = cosc_stream_gather(stream, 16, &data);
+        if (ret <= 0)
+            return ret;
+        ret = cosc_read_bundle(data, 16, &event->timetag, 0);
+        if (ret < 0)
+            return ret;
+        cosc_stream_consume(stream, 16);
+        struct cosc_level *level = stream->levels + ++stream->level;
+        level->type = COSC_LEVEL_TYPE_BUNDLE;
+        level->start = 0;
+        level->size_max = stream->psize;
+        level->size = 16;
+        level->ttstart = 0;
+        level->ttend = 0;
+        level->ttindex = 0;
+        level->ref = 0;
+        stream->psize = -1;
+        event->type = COSC_EVENT_BUNDLE_START;
+        event->level = stream->level;
+        return event->type;
+    }
+    ret = cosc_stream_gather(stream, stream->psize, &data);
+    if (ret <= 0)
+        return ret;
+    cosc_stream_consume(stream, stream->psize);
+    event->type = COSC_EVENT_MESSAGE;
+    event->level = stream->level + 1;
+    event->data = data;
+    event->size = stream->psize;
+    stream->psize = -1;
+    return event->type;
+}
+
+cosc_int32 cosc_walk(
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_int32 flags,
+    cosc_walk_callback callback,
+    void *context
+)
+{
+    const unsigned char *bytes = (const unsigned char *)buffer;
+    struct cosc_stream_event event;
+    struct cosc_level *level;
+    cosc_int32 depth = -1, offset = 0, end = size, ret;
+    cosc_memset(&event, 0, sizeof(event));
+    if (size < 0 || size > COSC_SIZE_MAX)
+        return COSC_ESIZEMAX;
+    if (flags & COSC_SERIAL_PSIZE)
+    {
+        if (size < 4)
+            return COSC_EOVERRUN;
+        end = cosc_load_int32(bytes);
+        if (end < 8 || end > COSC_SIZE_MAX - 4 || COSC_PAD(end))
+            return COSC_EPSIZE;
+        if (end > size - 4)
+            return COSC_EOVERRUN;
+        offset = 4;
+        end += 4;
+    }
+    else if (size < 8)
+        return COSC_EOVERRUN;
+    ret = end;
+
+    // The element is offset to end, bundles are popped when filled.
+    while (1)
+    {
+        if (bytes[offset] == '#')
+        {
+            if (depth >= level_max - 1)
+                return COSC_ELEVELMAX;
+            cosc_int32 sz = cosc_read_bundle(bytes + offset, end - offset, &event.timetag, 0);
+            if (sz < 0)
+                return sz;
+            level = levels + ++depth;
+            level->type = COSC_LEVEL_TYPE_BUNDLE;
+            level->start = offset;
+            level->size_max = end - offset;
+            level->size = sz;
+            level->ttstart = 0;
+            level->ttend = 0;
+            level->ttindex = 0;
+            level->ref = 0;
+            event.type = COSC_EVENT_BUNDLE_START;
+            event.level = depth;
+            event.data = 0;
+            event.size = 0;
+            offset += sz;
+        }
+        else
+        {
+            event.type = COSC_EVENT_MESSAGE;
+            event.level = depth + 1;
+            event.data = bytes + offset;
+            event.size = end - offset;
+            offset = end;
+        }
+        if (callback)
+        {
+            cosc_int32 cret = callback(&event, context);
+            if (cret < 0)
+                return cret;
+        }
+        while (depth >= 0)
+        {
+            level = levels + depth;
+            level->size = offset - level->start;
+            if (level->size < level->size_max)
+                break;
+            event.type = COSC_EVENT_BUNDLE_END;
+            event.level = depth--;
+            event.data = 0;
+            event.size = 0;
+            if (callback)
+            {
+                cosc_int32 cret = callback(&event, context);
+                if (cret < 0)
+                    return cret;
+            }
+        }
+        if (depth < 0)
+            break;
+        end = level->start + level->size_max;
+        if (offset > end - 4)
+            return COSC_EOVERRUN;
+        cosc_int32 esize = cosc_load_int32(bytes + offset);
+        offset += 4;
+        if (esize < 8 || COSC_PAD(esize))
+            return COSC_EPSIZE;
+        if (esize > end - offset)
+            return COSC_EPSIZE;
+        end = offset + esize;
+    }
+    return ret;
+}
+
+#endif /* !COSC_NOREADER */
+
+#ifndef COSC_NORING
+
+/*
+ * Each slot starts with two words in native byte order, the payload
+ * size padded to 8 bytes and the state. The state is 0 until
+ * committed, then the packet size + 1 or COSC_RING_SKIP for padding
+ * at the end of the storage and cancelled reservations.
+ */
+#define COSC_RING_SKIP 0xffffffffU
+
+/*
+ * Zero a consumed slot, so that stale bytes can never look like a
+ * committed state, and hand it back to the producers.
+ */
+static void cosc_ring_advance(
+    struct cosc_ring *ring,
+    cosc_uint32 *header
+)
+{
+    cosc_uint32 size = 8 + header[0];
+    cosc_memset(header, 0, size);
+    COSC_ATOMIC_STORE(&ring->tail, ring->tail + size);
+}
+
+cosc_int32 cosc_ring_setup(
+    struct cosc_ring *ring,
+    void *buffer,
+    cosc_int32 size
+)
+{
+    if (!buffer || size < 16 || (size & (size - 1)))
+        return COSC_EINVAL;
+    /* The slot headers are accessed atomically as 32-bit words. */
+    if ((COSC_UINTPTR)buffer & 7)
+        return COSC_EINVAL;
+    ring->buffer = (unsigned char *)buffer;
+    ring->mask = (cosc_uint32)size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    cosc_memset(buffer, 0, size);
+    return 0;
+}
+
+cosc_int32 cosc_ring_reserve(
+    struct cosc_ring *ring,
+    cosc_int32 size,
+    void **data
+)
+{
+    if (size < 0)
+        return COSC_EINVAL;
+    cosc_uint32 capacity = ring->mask + 1;
+    if ((cosc_uint32)size > capacity / 2 - 8)
+        return COSC_ESIZEMAX;
+    cosc_uint32 len = ((cosc_uint32)size + 7) & ~(cosc_uint32)7;
+    cosc_uint32 head, pos, skip;
+    for (;;)
+    {
+        cosc_uint32 tail = COSC_ATOMIC_LOAD(&ring->tail);
+        head = COSC_ATOMIC_LOAD(&ring->head);
+        /* The tail may be laps behind if this thread was preempted. */
+        if (head - tail > capacity)
+            continue;
+        pos = head & ring->mask;
+        skip = capacity - pos < len + 8 ? capacity - pos : 0;
+        if (skip + len + 8 > capacity - (head - tail))
+            return COSC_EOVERRUN;
+        if (COSC_ATOMIC_CAS(&ring->head, head, head + skip + len + 8))
+            break;
+    }
+    if (skip)
+    {
+        cosc_uint32 *header = (cosc_uint32 *)(ring->buffer + pos);
+        header[0] = skip - 8;
+        COSC_ATOMIC_STORE(header + 1, COSC_RING_SKIP);
+        pos = 0;
+    }
+    ((cosc_uint32 *)(ring->buffer + pos))[0] = len;
+    *data = ring->buffer + pos + 8;
+    return (cosc_int32)pos;
+}
+
+cosc_int32 cosc_ring_commit(
+    struct cosc_ring *ring,
+    cosc_int32 slot,
+    cosc_int32 size
+)
+{
+    cosc_uint32 *header = (cosc_uint32 *)(ring->buffer + slot);
+    if (size > 0 && (cosc_uint32)size > header[0])
+        return COSC_EINVAL;
+    COSC_ATOMIC_STORE(header + 1, size > 0 ? (cosc_uint32)size + 1 : COSC_RING_SKIP);
+    return 0;
+}
+
+cosc_int32 cosc_ring_peek(
+    struct cosc_ring *ring,
+    const void **data
+)
+{
+    for (;;)
+    {
+        cosc_uint32 *header = (cosc_uint32 *)(ring->buffer + (ring->tail & ring->mask));
+        cosc_uint32 state = COSC_ATOMIC_LOAD(header + 1);
+        if (state == 0)
+            return 0;
+        if (state != COSC_RING_SKIP)
+        {
+            if (data)
+                *data = header + 2;
+            return (cosc_int32)(state - 1);
+        }
+        cosc_ring_advance(ring, header);
+    }
+}
+
+cosc_int32 cosc_ring_release(
+    struct cosc_ring *ring
+)
+{
+    cosc_int32 size = cosc_ring_peek(ring, 0);
+    if (size > 0)
+        cosc_ring_advance(ring, (cosc_uint32 *)(ring->buffer + (ring->tail & ring->mask)));
+    return size;
+}
+
+#ifndef COSC_NOWRITER
+
+cosc_int32 cosc_ring_writer_setup(
+    struct cosc_ring *ring,
+    struct cosc_serial *serial,
+    cosc_int32 size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+)
+{
+    void *data = 0;
+    cosc_int32 slot = cosc_ring_reserve(ring, size, &data);
+    if (slot < 0)
+        return slot;
+    cosc_writer_setup(serial, data, size, levels, level_max, flags);
+    return slot;
+}
+
+cosc_int32 cosc_ring_writer_commit(
+    struct cosc_ring *ring,
+    const struct cosc_serial *serial,
+    cosc_int32 slot
+)
+{
+    if (serial->level >= 0)
+        return COSC_ELEVELTYPE;
+    cosc_int32 size = cosc_serial_get_size(serial);
+    cosc_int32 ret = cosc_ring_commit(ring, slot, size);
+    if (ret < 0)
+        return ret;
+    return size;
+}
+
+#endif /* !COSC_NOWRITER */
+
+#ifndef COSC_NOREADER
+
+cosc_int32 cosc_ring_reader_setup(
+    struct cosc_ring *ring,
+    struct cosc_serial *serial,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+)
+{
+    const void *data = 0;
+    cosc_int32 size = cosc_ring_peek(ring, &data);
+    if (size > 0)
+        cosc_reader_setup(serial, data, size, levels, level_max, flags);
+    return size;
+}
+
 #endif /* !COSC_NOREADER */
+
+#endif /* !COSC_NORING */
+
+#ifndef COSC_NOSCHEDULER
+
+static cosc_int32 cosc_scheduler_immediate(
+    cosc_uint64 timetag
+)
+{
+#ifdef COSC_NOINT64
+    return COSC_64BITS_HI(&timetag) == 0 && COSC_64BITS_LO(&timetag) == 1;
+#else
+    return timetag == 1;
+#endif
+}
+
+/*
+ * Returns true if timetag a is before b, wrap-aware so a schedule
+ * keeps its order across an NTP era rollover.
+ */
+static cosc_int32 cosc_scheduler_timetag_before(
+    cosc_uint64 a,
+    cosc_uint64 b
+)
+{
+    return cosc_timetag_cmp(a, b) < 0;
+}
+
+/*
+ * Heap order, immediate packets first, then by timetag and the order
+ * they were added in.
+ */
+static cosc_int32 cosc_scheduler_before(
+    const struct cosc_scheduled *a,
+    const struct cosc_scheduled *b
+)
+{
+    cosc_int32 a_now = cosc_scheduler_immediate(a->timetag);
+    cosc_int32 b_now = cosc_scheduler_immediate(b->timetag);
+    if (a_now != b_now)
+        return a_now;
+    if (!a_now)
+    {
+        if (cosc_scheduler_timetag_before(a->timetag, b->timetag))
+            return 1;
+        if (cosc_scheduler_timetag_before(b->timetag, a->timetag))
+            return 0;
+    }
+    return (cosc_int32)(a->seq - b->seq) < 0;
+}
+
+cosc_int32 cosc_scheduler_setup(
+    struct cosc_scheduler *scheduler,
+    struct cosc_scheduled *entries,
+    cosc_int32 entry_max
+)
+{
+    if (!entries || entry_max < 1)
+        return COSC_EINVAL;
+    scheduler->entries = entries;
+    scheduler->entry_max = entry_max;
+    scheduler->count = 0;
+    scheduler->seq = 0;
+    return 0;
+}
+
+cosc_int32 cosc_scheduler_add(
+    struct cosc_scheduler *scheduler,
+    cosc_uint64 timetag,
+    const void *packet,
+    cosc_int32 size
+)
+{
+    if (size < 0)
+        return COSC_EINVAL;
+    if (scheduler->count >= scheduler->entry_max)
+        return COSC_EOVERRUN;
+    struct cosc_scheduled entry;
+    entry.timetag = timetag;
+    entry.packet = packet;
+    entry.size = size;
+    entry.seq = scheduler->seq++;
+    cosc_int32 i = scheduler->count++;
+    while (i > 0)
+    {
+        cosc_int32 parent = (i - 1) / 2;
+        if (!cosc_scheduler_before(&entry, scheduler->entries + parent))
+            break;
+        scheduler->entries[i] = scheduler->entries[parent];
+        i = parent;
+    }
+    scheduler->entries[i] = entry;
+    return scheduler->count;
+}
+
+cosc_int32 cosc_scheduler_push(
+    struct cosc_scheduler *scheduler,
+    const void *packet,
+    cosc_int32 size,
+    cosc_uint32 flags
+)
+{
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    cosc_int32 psize = 0, head = (flags & COSC_PACKET_PSIZE) ? 4 : 0;
+    if (size < 0)
+        return COSC_EINVAL;
+    if (size > head && ((const char *)packet)[head] == '#')
+    {
+        cosc_int32 ret = cosc_read_bundle(packet, size, &timetag, head ? &psize : 0);
+        if (ret < 0)
+            return ret;
+    }
+    else
+    {
+#ifdef COSC_NOINT64
+        COSC_64BITS_SET(&timetag, 0, 1);
+#else
+        timetag = 1;
+#endif
+    }
+    return cosc_scheduler_add(scheduler, timetag, packet, size);
+}
+
+cosc_int32 cosc_scheduler_peek(
+    const struct cosc_scheduler *scheduler,
+    struct cosc_scheduled *entry
+)
+{
+    if (entry && scheduler->count > 0)
+        *entry = scheduler->entries[0];
+    return scheduler->count;
+}
+
+cosc_int32 cosc_scheduler_pop(
+    struct cosc_scheduler *scheduler,
+    cosc_uint64 now,
+    struct cosc_scheduled *entry
+)
+{
+    if (scheduler->count <= 0)
+        return 0;
+    const struct cosc_scheduled *top = scheduler->entries;
+    if (!cosc_scheduler_immediate(top->timetag)
+        && cosc_scheduler_timetag_before(now, top->timetag))
+        return 0;
+    if (entry)
+        *entry = *top;
+    struct cosc_scheduled last = scheduler->entries[--scheduler->count];
+    cosc_int32 n = scheduler->count;
+    cosc_int32 i = 0;
+    for (;;)
+    {
+        cosc_int32 child = i * 2 + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && cosc_scheduler_before(scheduler->entries + child + 1, scheduler->entries + child))
+            child++;
+        if (!cosc_scheduler_before(scheduler->entries + child, &last))
+            break;
+        scheduler->entries[i] = scheduler->entries[child];
+        i = child;
+    }
+    if (n > 0)
+        scheduler->entries[i] = last;
+    return 1;
+}
+
+#ifndef COSC_NOTIMETAG
+
+cosc_int32 cosc_scheduler_wait(
+    const struct cosc_scheduler *scheduler,
+    cosc_uint64 now,
+    cosc_uint32 *seconds,
+    cosc_uint32 *nanos
+)
+{
+    if (scheduler->count <= 0)
+        return 0;
+    cosc_uint64 timetag = scheduler->entries[0].timetag;
+    cosc_uint32 s = 0, ns = 0;
+    if (!cosc_scheduler_immediate(timetag)
+        && cosc_scheduler_timetag_before(now, timetag))
+    {
+#ifdef COSC_NOINT64
+        if (COSC_64BITS_LO(&timetag) < COSC_64BITS_LO(&now))
+            COSC_64BITS_HI(&timetag)--;
+        COSC_64BITS_HI(&timetag) -= COSC_64BITS_HI(&now);
+        COSC_64BITS_LO(&timetag) -= COSC_64BITS_LO(&now);
+#else
+        timetag -= now;
+#endif
+        s = cosc_timetag_to_time(timetag, &ns);
+    }
+    if (seconds) *seconds = s;
+    if (nanos) *nanos = ns;
+    return 1;
+}
+
+#endif /* !COSC_NOTIMETAG */
+
+#endif /* !COSC_NOSCHEDULER */
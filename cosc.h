@@ -11,6 +11,11 @@
  *   This will also remove the dump functions.
  * - COSC_NOPATTERN to remove the pattern matching functions.
  * - COSC_NOSWAP for no endian swapping.
+ * - COSC_BIG_ENDIAN to set the host byte order if it can't be detected,
+ *   1 for big endian and 0 for little endian.
+ * - COSC_NOBUILTIN to byte swap and multiply without compiler builtins.
+ * - COSC_NOSWAR to scan strings one byte at a time instead of one word.
+ * - COSC_NOSIMD to byte swap arrays without SSE2/AVX2/NEON intrinsics.
  * - COSC_NOARRAY to remove the support for arrays.
  * - COSC_NOSTDINT to not include `stdint.h` (or `cstdint` if C++).
  * - COSC_NODUMP to remove the dump functions.
@@ -18,6 +23,9 @@
  * - COSC_NOFLTCONV to remove float conversion functions.
  * - COSC_NOWRITER to remove the writer functions.
  * - COSC_NOREADER to remove the reader functions.
+ * - COSC_NORING to remove the packet ring buffer, defined automatically
+ *   when the compiler has no atomic operations.
+ * - COSC_NOSCHEDULER to remove the timetag scheduler.
  * - COSC_NOINT64 to typedef `cosc_int64` and `cosc_uint64` as @ref cosc_64bits.
  * - COSC_NOFLOAT32 to typedef `cosc_float32` as @ref cosc_uint32.
  * - COSC_NOFLOAT64 to typedef `cosc_float64` as @ref cosc_64bits.
@@ -30,6 +38,11 @@
  * - COSC_TYPE_UINT64 used to override typedef @ref cosc_uint64.
  * - COSC_TYPE_INT64 used to override typedef @ref cosc_int64.
  * - COSC_TYPE_FLOAT64 used to override typedef @ref cosc_float64.
+ * - COSC_TYPE_SIZE used to override the length type of @ref cosc_iovec.
+ *
+ * Limit overrides (also at compile AND include time):
+ *
+ * - COSC_PACKET_DEPTH_MAX used to override @ref COSC_PACKET_DEPTH_MAX.
  *
  * NOTE that type overrides will not work for types affected by
  * COSC_NOINT64, COSC_FLOAT32 or COSC_NOFLOAT64 when those
@@ -96,6 +109,29 @@
 #endif /* COSC_BUILD_SHARED */
 #endif /* COSC_API */
 
+/**
+ * Non-zero if the host is big endian, zero if little endian.
+ * @def COSC_BIG_ENDIAN
+ * @note Detected at compile time when the compiler or platform tells,
+ * otherwise left undefined and cosc_big_endian() checks at runtime.
+ * The CMake build defines it from the detected target byte order.
+ * @note On big endian hosts values are stored and loaded with plain
+ * copies, as with COSC_NOSWAP.
+ */
+#ifndef COSC_BIG_ENDIAN
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define COSC_BIG_ENDIAN 1
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define COSC_BIG_ENDIAN 0
+#elif defined(_WIN32)
+#define COSC_BIG_ENDIAN 0
+#elif defined(__BIG_ENDIAN__) || defined(__ARMEB__) || defined(__AARCH64EB__) || defined(__MIPSEB__)
+#define COSC_BIG_ENDIAN 1
+#elif defined(__LITTLE_ENDIAN__) || defined(__ARMEL__) || defined(__AARCH64EL__) || defined(__MIPSEL__)
+#define COSC_BIG_ENDIAN 0
+#endif
+#endif /* !COSC_BIG_ENDIAN */
+
 /**
  * Used to typedef @ref cosc_uint32.
  * @def COSC_TYPE_UINT32
@@ -138,6 +174,38 @@
  * @note Must be exactly 64 bits in width.
  */
 
+/**
+ * Used for the length of @ref cosc_iovec.
+ * @def COSC_TYPE_SIZE
+ * @note If defined it must be at both compile and include time.
+ * @note Must match `size_t` for @ref cosc_iovec to match `struct iovec`.
+ */
+
+#ifndef COSC_TYPE_SIZE
+#ifndef COSC_NOSTDLIB
+#ifdef __cplusplus
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif
+#define COSC_TYPE_SIZE size_t
+#elif defined(__SIZE_TYPE__)
+#define COSC_TYPE_SIZE __SIZE_TYPE__
+#else
+#define COSC_TYPE_SIZE unsigned long
+#endif
+#endif /* !COSC_TYPE_SIZE */
+
+/*
+ * The ring buffer needs atomic operations, it is removed when the
+ * compiler has none that cosc.c knows about.
+ */
+#if !defined(COSC_NORING) && !defined(__GNUC__) && !defined(__clang__) && !defined(_MSC_VER) \
+    && !(defined(__cplusplus) && __cplusplus >= 202002L && !defined(COSC_NOSTDLIB)) \
+    && !(defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__))
+#define COSC_NORING
+#endif
+
 #ifndef COSC_NOSTDINT
 
 #ifdef __cplusplus
@@ -395,6 +463,49 @@ typedef COSC_TYPE_FLOAT64 cosc_float64;
  */
 #define COSC_SERIAL_PSIZE 1
 
+/**
+ * Set by cosc_measure_setup(), the serial writes nothing and
+ * only counts bytes.
+ */
+#define COSC_SERIAL_MEASURE 2
+
+/**
+ * Tell cosc_packet_validate() that the packet is prefixed with a
+ * packet size.
+ */
+#define COSC_PACKET_PSIZE 1
+
+/**
+ * Tell cosc_packet_validate() to validate the message addresses,
+ * patterns are not allowed.
+ */
+#define COSC_PACKET_ADDRESS 2
+
+/**
+ * The maximum number of nested bundles cosc_packet_validate() accepts.
+ */
+#ifndef COSC_PACKET_DEPTH_MAX
+#define COSC_PACKET_DEPTH_MAX 32
+#endif
+
+/**
+ * A stream event for the start of a bundle.
+ * @see cosc_stream_next().
+ */
+#define COSC_EVENT_BUNDLE_START 1
+
+/**
+ * A stream event for a complete message.
+ * @see cosc_stream_next().
+ */
+#define COSC_EVENT_MESSAGE 2
+
+/**
+ * A stream event for the end of a bundle.
+ * @see cosc_stream_next().
+ */
+#define COSC_EVENT_BUNDLE_END 3
+
 /**
  * Buffer overrun.
  */
@@ -582,12 +693,269 @@ struct cosc_message
 
 };
 
+/**
+ * Binds one message value to a member of a user struct.
+ *
+ * The member at @p offset must have the type matching @p type:
+ *
+ * - 'i' and 'c' @ref cosc_int32.
+ * - 'r' @ref cosc_uint32.
+ * - 'f' @ref cosc_float32.
+ * - 'h' @ref cosc_int64.
+ * - 't' @ref cosc_uint64.
+ * - 'd' @ref cosc_float64.
+ * - 'm' `unsigned char[4]`.
+ * - 's' and 'S' `const char *`.
+ * - 'b' `const void *`.
+ * - 'T', 'F', 'N' and 'I' have no member and @p offset is ignored.
+ *
+ * @see cosc_write_message_from() and cosc_read_message_into().
+ */
+struct cosc_binding
+{
+
+    /**
+     * The OSC type, arrays are not supported.
+     */
+    cosc_int32 type;
+
+    /**
+     * The offset of the member, use offsetof().
+     */
+    cosc_int32 offset;
+
+    /**
+     * For 's', 'S' and 'b' the offset of a @ref cosc_int32 member
+     * holding the string length or blob size, or -1 for none. Without
+     * one strings are read to the zero terminator when writing and
+     * blobs must always have one.
+     */
+    cosc_int32 size_offset;
+
+};
+
+/**
+ * The location of a value resolved by a message view.
+ * @see cosc_message_view_setup().
+ */
+struct cosc_message_arg
+{
+
+    /**
+     * The byte offset of the value from the start of the values.
+     */
+    cosc_int32 offset;
+
+    /**
+     * The type.
+     */
+    cosc_int32 type;
+
+};
+
+/**
+ * A message with values decoded on demand.
+ *
+ * The offsets of the values are resolved lazily in order and cached in
+ * an array of @ref cosc_message_arg provided by the caller. Values of
+ * a fixed size before the first string or blob are resolved by
+ * cosc_message_view_setup() without reading them, and so is a run of
+ * fixed size array members.
+ *
+ * @note Do not modify the members, use the cosc_message_view_*()
+ * functions.
+ * @see cosc_message_view_setup().
+ */
+struct cosc_message_view
+{
+
+    /**
+     * The address.
+     */
+    const char *address;
+
+    /**
+     * The address length excluding the zero terminator.
+     */
+    cosc_int32 address_n;
+
+    /**
+     * The typetag.
+     */
+    const char *typetag;
+
+    /**
+     * The typetag length excluding the zero terminator.
+     */
+    cosc_int32 typetag_n;
+
+    /**
+     * A pointer to the first value.
+     */
+    const unsigned char *values;
+
+    /**
+     * The number of bytes after @p values that belong to the message.
+     */
+    cosc_int32 values_size;
+
+    /**
+     * The cached value locations.
+     */
+    struct cosc_message_arg *args;
+
+    /**
+     * The maximum number of cached value locations.
+     */
+    cosc_int32 args_max;
+
+    /**
+     * The number of values resolved so far.
+     */
+    cosc_int32 count;
+
+    /**
+     * The byte offset after the last resolved value.
+     */
+    cosc_int32 offset;
+
+    /**
+     * The typetag index of the next type to resolve.
+     */
+    cosc_int32 type_index;
+
+    /**
+     * The typetag index of the first array type, 0 if not in an array.
+     */
+    cosc_int32 array_start;
+
+    /**
+     * The number of values resolved since the start of the array.
+     */
+    cosc_int32 array_values;
+
+    /**
+     * The index of the first value of a run of fixed size array members.
+     */
+    cosc_int32 run_start;
+
+    /**
+     * The number of values in the run, 0 if none.
+     */
+    cosc_int32 run_count;
+
+    /**
+     * The byte offset of the first value of the run.
+     */
+    cosc_int32 run_offset;
+
+    /**
+     * The type of the run.
+     */
+    cosc_int32 run_type;
+
+    /**
+     * The location of the last resolved value.
+     */
+    struct cosc_message_arg last;
+
+    /**
+     * Non-zero when all values have been resolved.
+     */
+    cosc_int32 done;
+
+};
+
+/**
+ * What cosc_packet_validate() found in a packet.
+ */
+struct cosc_packet_stats
+{
+
+    /**
+     * The number of bundles.
+     */
+    cosc_int32 bundles;
+
+    /**
+     * The number of messages.
+     */
+    cosc_int32 messages;
+
+    /**
+     * The number of values in all messages, types T, F, N and I
+     * not included.
+     */
+    cosc_int32 values;
+
+    /**
+     * The deepest bundle nesting, 0 for a message that is not in a bundle.
+     */
+    cosc_int32 depth;
+
+    /**
+     * The size of the largest message.
+     */
+    cosc_int32 message_size_max;
+
+};
+
+/**
+ * Changes to make when copying a message.
+ * @see cosc_edit_message().
+ */
+struct cosc_message_edit
+{
+
+    /**
+     * Remove this many bytes from the start of the address.
+     */
+    cosc_int32 address_strip;
+
+    /**
+     * Prepend this to the address after stripping it, NULL for nothing.
+     */
+    const char *address_prefix;
+
+    /**
+     * Read at most this many bytes from @p address_prefix.
+     */
+    cosc_int32 address_prefix_n;
+
+    /**
+     * Remove this many types and their values from the end.
+     */
+    cosc_int32 remove;
+
+    /**
+     * Append these types after removing, without the comma prefix,
+     * NULL for nothing.
+     */
+    const char *types;
+
+    /**
+     * Read at most this many bytes from @p types.
+     */
+    cosc_int32 types_n;
+
+    /**
+     * The values of the appended types.
+     */
+    const union cosc_value *values;
+
+    /**
+     * Read at most this many members from @p values.
+     */
+    cosc_int32 values_n;
+
+};
+
 /**
  * Macro to check if a serial is a writer.
  * @param serial_ A pointer to the serial.
  * @returns True or false.
  */
-#define COSC_SERIAL_ISWRITER(serial_) ((serial_)->wbuffer != 0)
+#define COSC_SERIAL_ISWRITER(serial_) ((serial_)->wbuffer != 0 || ((serial_)->flags & COSC_SERIAL_MEASURE))
 
 /**
  * Macro to check if a serial is a reader.
@@ -596,6 +964,37 @@ struct cosc_message
  */
 #define COSC_SERIAL_ISREADER(serial_) ((serial_)->rbuffer != 0)
 
+/**
+ * An element of a bundle.
+ * @see cosc_bundle_index().
+ */
+struct cosc_bundle_element
+{
+
+    /**
+     * The buffer byte offset of the element, after it's packet size.
+     */
+    cosc_int32 offset;
+
+    /**
+     * The element byte size, excluding the packet size.
+     */
+    cosc_int32 size;
+
+    /**
+     * The element type, @ref COSC_LEVEL_TYPE_BUNDLE or
+     * @ref COSC_LEVEL_TYPE_MESSAGE.
+     */
+    cosc_int32 type;
+
+    /**
+     * The timetag of a nested bundle, for messages the timetag of
+     * the indexed bundle.
+     */
+    cosc_uint64 timetag;
+
+};
+
 /**
  * Used to manage the levels of a serial.
  */
@@ -644,6 +1043,45 @@ struct cosc_level
      */
     cosc_int32 ttindex;
 
+    /**
+     * The number of referenced bytes before the level start.
+     * @note Only used by iovec writers, see cosc_writer_setup_iovec().
+     */
+    cosc_int32 ref;
+
+    /**
+     * The typetag of the message, NULL unless the serial is measuring.
+     * @note Only used if type is message.
+     */
+    const char *typetag;
+
+    /**
+     * The length of @ref typetag.
+     * @note Only used if type is message.
+     */
+    cosc_int32 typetag_n;
+
+};
+
+/**
+ * A segment of an iovec writer, same layout as POSIX `struct iovec`
+ * so an array of them can be cast and passed to `writev()`.
+ * @see cosc_writer_setup_iovec().
+ * @note The layout only matches when @ref COSC_TYPE_SIZE is `size_t`.
+ */
+struct cosc_iovec
+{
+
+    /**
+     * The segment bytes, never written to by this library.
+     */
+    void *base;
+
+    /**
+     * The number of bytes in the segment.
+     */
+    COSC_TYPE_SIZE len;
+
 };
 
 /**
@@ -692,17 +1130,539 @@ struct cosc_serial
      */
     cosc_uint32 flags;
 
-};
+    /**
+     * A pointer to an array of segments, NULL unless the serial
+     * is an iovec writer.
+     */
+    struct cosc_iovec *iov;
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+    /**
+     * Maximum number of segments.
+     */
+    cosc_int32 iov_max;
 
-/**
- * Feature test for 64-bit integer support.
- * @returns Non-zero if cosc was built with 64-bit integer support.
- */
-COSC_API cosc_int32 cosc_feature_int64(void);
+    /**
+     * The number of used segments.
+     */
+    cosc_int32 iov_count;
+
+    /**
+     * Strings and blobs of at least this many bytes are referenced
+     * instead of copied.
+     */
+    cosc_int32 iov_min;
+
+    /**
+     * The number of referenced bytes, the buffer holds the written
+     * bytes minus this many.
+     */
+    cosc_int32 ref;
+
+};
+
+/**
+ * An event emitted by a stream.
+ * @see cosc_stream_next().
+ */
+struct cosc_stream_event
+{
+
+    /**
+     * The event type, see COSC_EVENT_* macros.
+     */
+    cosc_int32 type;
+
+    /**
+     * The bundle nesting level of the event, 0 for top level packets.
+     */
+    cosc_int32 level;
+
+    /**
+     * The message bytes without the packet size, only valid until the
+     * next call to cosc_stream_next() or cosc_stream_feed().
+     * @note Only used if type is @ref COSC_EVENT_MESSAGE.
+     */
+    const void *data;
+
+    /**
+     * The message size in bytes.
+     * @note Only used if type is @ref COSC_EVENT_MESSAGE.
+     */
+    cosc_int32 size;
+
+    /**
+     * The bundle timetag.
+     * @note Only used if type is @ref COSC_EVENT_BUNDLE_START.
+     */
+    cosc_uint64 timetag;
+
+};
+
+/**
+ * Used to read packet size prefixed packets fed in arbitrary chunks.
+ * @see cosc_stream_setup().
+ */
+struct cosc_stream
+{
+
+    /**
+     * The tail buffer holding the start of an element split
+     * between chunks.
+     */
+    unsigned char *buffer;
+
+    /**
+     * The size of the tail buffer.
+     */
+    cosc_int32 buffer_size;
+
+    /**
+     * The number of bytes in the tail buffer.
+     */
+    cosc_int32 tail;
+
+    /**
+     * The current chunk.
+     */
+    const unsigned char *chunk;
+
+    /**
+     * The size of the current chunk.
+     */
+    cosc_int32 chunk_size;
+
+    /**
+     * The number of consumed bytes in the current chunk.
+     */
+    cosc_int32 chunk_offset;
+
+    /**
+     * The size of the current element, or -1 if the
+     * packet size has not been read yet.
+     */
+    cosc_int32 psize;
+
+    /**
+     * A pointer to an array of levels, one for each open bundle.
+     */
+    struct cosc_level *levels;
+
+    /**
+     * Maximum number of levels.
+     */
+    cosc_int32 level_max;
+
+    /**
+     * The current level, -1 if between top level packets.
+     */
+    cosc_int32 level;
+
+};
+
+/**
+ * A fixed capacity packet ring buffer for many producer threads
+ * and one consumer thread.
+ * @see cosc_ring_setup().
+ */
+struct cosc_ring
+{
+
+    /**
+     * The caller provided storage.
+     */
+    unsigned char *buffer;
+
+    /**
+     * The storage size - 1, the size is a power of two.
+     */
+    cosc_uint32 mask;
+
+    /**
+     * Keep the cursors on separate cache lines.
+     */
+    unsigned char pad0[64];
+
+    /**
+     * The reserve cursor, advanced by producers.
+     */
+    cosc_uint32 head;
+
+    /**
+     * Keep the cursors on separate cache lines.
+     */
+    unsigned char pad1[64];
+
+    /**
+     * The release cursor, advanced by the consumer.
+     */
+    cosc_uint32 tail;
+
+};
+
+/**
+ * A packet waiting in a scheduler.
+ * @see cosc_scheduler_push().
+ */
+struct cosc_scheduled
+{
+
+    /**
+     * The timetag the packet is due at.
+     */
+    cosc_uint64 timetag;
+
+    /**
+     * The packet.
+     */
+    const void *packet;
+
+    /**
+     * The packet size in bytes.
+     */
+    cosc_int32 size;
+
+    /**
+     * The order the packet was added in, packets with the same timetag
+     * are popped in the order they were added.
+     */
+    cosc_uint32 seq;
+
+};
+
+/**
+ * A timetag ordered packet scheduler, a binary heap over caller
+ * provided storage.
+ * @see cosc_scheduler_setup().
+ */
+struct cosc_scheduler
+{
+
+    /**
+     * The caller provided storage.
+     */
+    struct cosc_scheduled *entries;
+
+    /**
+     * The number of entries in the storage.
+     */
+    cosc_int32 entry_max;
+
+    /**
+     * The number of scheduled packets.
+     */
+    cosc_int32 count;
+
+    /**
+     * The order of the next added packet.
+     */
+    cosc_uint32 seq;
+
+};
+
+/**
+ * The pattern operation matches a run of literal characters.
+ */
+#define COSC_PATTERN_OP_LITERAL 'L'
+
+/**
+ * The pattern operation matches the typetag comma prefix.
+ */
+#define COSC_PATTERN_OP_COMMA ','
+
+/**
+ * The pattern operation matches zero or more characters.
+ */
+#define COSC_PATTERN_OP_STAR '*'
+
+/**
+ * The pattern operation matches any single character.
+ */
+#define COSC_PATTERN_OP_ANY '?'
+
+/**
+ * The pattern operation matches a digit or numeric type.
+ */
+#define COSC_PATTERN_OP_NUMERIC '#'
+
+/**
+ * The pattern operation matches a boolean type.
+ */
+#define COSC_PATTERN_OP_BOOL 'B'
+
+/**
+ * The pattern operation matches a single character in a set.
+ */
+#define COSC_PATTERN_OP_CHARSET '['
+
+/**
+ * The pattern operation matches one of the alternatives that follow it.
+ */
+#define COSC_PATTERN_OP_STRINGSET '{'
+
+/**
+ * The pattern operation is an alternative of a preceding string set.
+ */
+#define COSC_PATTERN_OP_ALTERNATIVE '|'
+
+/**
+ * A compiled pattern operation.
+ * @see cosc_pattern_compile() and cosc_pattern_exec().
+ */
+struct cosc_pattern_op
+{
+
+    /**
+     * The operation type.
+     */
+    cosc_int32 type;
+
+    /**
+     * For literals and alternatives this is the number of characters
+     * in @p s, for string sets the number of alternatives that follow.
+     */
+    cosc_int32 n;
+
+    /**
+     * For literals and alternatives this points into the pattern.
+     */
+    const char *s;
+
+    /**
+     * One bit per character for character sets.
+     */
+    cosc_uint32 set[8];
+
+};
+
+/**
+ * The dispatch node is a literal address segment.
+ */
+#define COSC_DISPATCH_NODE_LITERAL 'L'
+
+/**
+ * The dispatch node is an address segment with pattern characters.
+ */
+#define COSC_DISPATCH_NODE_PATTERN 'P'
+
+/**
+ * The dispatch node is a handler.
+ */
+#define COSC_DISPATCH_NODE_HANDLER 'H'
+
+/**
+ * A node in a dispatch table.
+ * @note The members are managed by the dispatch functions.
+ */
+struct cosc_dispatch_node
+{
+
+    /**
+     * The node type.
+     */
+    cosc_int32 type;
+
+    /**
+     * A pointer to the address segment, points into the address pattern.
+     */
+    const char *s;
+
+    /**
+     * The length of the address segment.
+     */
+    cosc_int32 n;
+
+    /**
+     * The index of the parent node.
+     */
+    cosc_int32 parent;
+
+    /**
+     * Hash of the parent index and the address segment.
+     */
+    cosc_uint32 hash;
+
+    /**
+     * The index of the first compiled operation for segment patterns
+     * and handler typetag patterns, -1 if none.
+     */
+    cosc_int32 ops;
+
+    /**
+     * The number of compiled operations.
+     */
+    cosc_int32 ops_n;
+
+    /**
+     * The index of the first pattern child node, -1 if none.
+     */
+    cosc_int32 patterns;
+
+    /**
+     * The index of the first handler node, -1 if none.
+     */
+    cosc_int32 handlers;
+
+    /**
+     * The index of the next pattern sibling or handler, -1 if none.
+     */
+    cosc_int32 next;
+
+    /**
+     * The handler id.
+     */
+    cosc_int32 id;
+
+};
+
+/**
+ * A dispatch table matching addresses against many patterns at once.
+ *
+ * Address patterns are split into segments at '/' and stored as a tree,
+ * literal segments are looked up in a hash table while segments with
+ * pattern characters are matched with compiled operations.
+ *
+ * @note Pattern characters never match across '/', i.e "/a/b*" does not
+ * match "/a/bc/d" as it would with cosc_pattern_match().
+ * @see cosc_dispatch_setup().
+ */
+struct cosc_dispatch
+{
+
+    /**
+     * A pointer to an array of nodes.
+     */
+    struct cosc_dispatch_node *nodes;
+
+    /**
+     * Maximum number of nodes.
+     */
+    cosc_int32 node_max;
+
+    /**
+     * The number of used nodes.
+     */
+    cosc_int32 node_count;
+
+    /**
+     * A pointer to the hash table of literal nodes.
+     */
+    cosc_int32 *table;
+
+    /**
+     * The number of hash table slots, a power of two.
+     */
+    cosc_int32 table_size;
+
+    /**
+     * A pointer to an array of compiled pattern operations.
+     */
+    struct cosc_pattern_op *ops;
+
+    /**
+     * Maximum number of operations.
+     */
+    cosc_int32 op_max;
+
+    /**
+     * The number of used operations.
+     */
+    cosc_int32 op_count;
+
+};
+
+/**
+ * A field of a typetag plan, one per type in the typetag excluding
+ * the comma prefix and the array markers.
+ * @see cosc_typetag_plan_compile().
+ */
+struct cosc_plan_field
+{
+
+    /**
+     * The type.
+     */
+    cosc_int32 type;
+
+    /**
+     * The offset from the start of the run of fixed size fields
+     * this field belongs to, zero for variable size fields.
+     */
+    cosc_int32 offset;
+
+    /**
+     * The size in bytes, -1 for variable size fields (s, S and b)
+     * and 0 for types without payload (T, F, N and I).
+     */
+    cosc_int32 size;
+
+    /**
+     * For the first field of a run of fixed size fields this is the
+     * size of the whole run, otherwise 0.
+     */
+    cosc_int32 run;
+
+};
+
+/**
+ * A typetag compiled into fields, offsets and the array repeat region.
+ * @see cosc_typetag_plan_compile().
+ */
+struct cosc_typetag_plan
+{
+
+    /**
+     * A pointer to the fields.
+     */
+    const struct cosc_plan_field *fields;
+
+    /**
+     * The number of fields.
+     */
+    cosc_int32 field_count;
+
+    /**
+     * The index of the first array field or -1 if there is no array.
+     */
+    cosc_int32 array_start;
+
+    /**
+     * The index after the last array field or -1 if there is no array.
+     */
+    cosc_int32 array_end;
+
+    /**
+     * The size of the fields outside the array or -1 if any of them
+     * is of variable size.
+     */
+    cosc_int32 fixed_size;
+
+    /**
+     * The size of one array repetition or -1 if any of the array
+     * fields is of variable size.
+     */
+    cosc_int32 array_size;
+
+    /**
+     * The number of values outside the array.
+     */
+    cosc_int32 value_count;
+
+    /**
+     * The number of values in one array repetition.
+     */
+    cosc_int32 array_value_count;
+
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Feature test for 64-bit integer support.
+ * @returns Non-zero if cosc was built with 64-bit integer support.
+ */
+COSC_API cosc_int32 cosc_feature_int64(void);
 
 /**
  * Feature test for 32-bit float support.
@@ -718,7 +1678,8 @@ COSC_API cosc_int32 cosc_feature_float64(void);
 
 /**
  * Feature test for endian swapping.
- * @returns Non-zero if cosc was built with endian swapping.
+ * @returns Non-zero if cosc was built with endian swapping, zero
+ * with COSC_NOSWAP or on big endian hosts where it isn't needed.
  */
 COSC_API cosc_int32 cosc_feature_swap(void);
 
@@ -758,11 +1719,25 @@ COSC_API cosc_int32 cosc_feature_writer(void);
  */
 COSC_API cosc_int32 cosc_feature_reader(void);
 
+/**
+ * Feature test for ring buffer support.
+ * @returns Non-zero if cosc was built with ring buffer support.
+ */
+COSC_API cosc_int32 cosc_feature_ring(void);
+
+/**
+ * Feature test for scheduler support.
+ * @returns Non-zero if cosc was built with scheduler support.
+ */
+COSC_API cosc_int32 cosc_feature_scheduler(void);
+
 /**
  * If big endian was detected when building this function returns non-zero,
  * otherwise zero.
  * @returns Non-zero if big endian was detected when building,
  * otherwise zero.
+ * @note Returns @ref COSC_BIG_ENDIAN when defined, only checks at
+ * runtime if the byte order was not known at compile time.
  */
 COSC_API cosc_int32 cosc_big_endian(void);
 
@@ -907,16 +1882,20 @@ COSC_API cosc_int32 cosc_pattern_validate(
  *
  * - `*` match zero or more characters.
  * - `[]` match any character inside square brackets.
- * - `{}` match any comma separated string inside curly brackets.
+ * - `{}` match any comma separated string inside curly brackets,
+ *   the first matching string is used.
  * - '?' match a single character.
  *
- * Extended syntax for typetags, not part of the OSC specification:
+ * Extended syntax, not part of the OSC specification:
  *
  * - '#' for typetags match a numeric type ('i', 'f', 'r', 'h', 't' and 'd').
  * - '#' for addresses match a base-10 digit (0-9).
- * - 'B' match a boolean ('T' or 'F').
+ * - 'B' for typetags match a boolean ('T' or 'F'), for addresses
+ *   'B' is a literal character.
  *
- * When matching addresses '#' is simply ignored.
+ * A pattern that is matched many times can be compiled once with
+ * cosc_pattern_compile() and matched with cosc_pattern_exec(), the
+ * result is the same.
  */
 COSC_API cosc_int32 cosc_pattern_match(
     const char *s,
@@ -949,6 +1928,163 @@ COSC_API cosc_int32 cosc_signature_match(
     cosc_int32 prefix
 );
 
+/**
+ * Setup a dispatch table.
+ * @param[out] dispatch The dispatch table.
+ * @param nodes A pointer to an array of nodes.
+ * @param node_max The number of nodes in @p nodes.
+ * @param table A pointer to an array of hash table slots.
+ * @param table_size The number of slots in @p table, must be a power
+ * of two.
+ * @param ops A pointer to an array of pattern operations or NULL
+ * for a table with only literal addresses and no typetag patterns.
+ * @param op_max The number of operations in @p ops.
+ * @returns 0 on success or @ref COSC_EINVAL if @p node_max is less
+ * than 1 or @p table_size is not a power of two.
+ * @note Each distinct address segment uses one node and one hash
+ * table slot, each handler uses one node. Keep @p table_size at about
+ * twice the number of literal segments for short lookups.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_dispatch_setup(
+    struct cosc_dispatch *dispatch,
+    struct cosc_dispatch_node *nodes,
+    cosc_int32 node_max,
+    cosc_int32 *table,
+    cosc_int32 table_size,
+    struct cosc_pattern_op *ops,
+    cosc_int32 op_max
+);
+
+/**
+ * Add a handler to a dispatch table.
+ * @param dispatch The dispatch table.
+ * @param apattern The matching pattern for the address.
+ * @param apattern_n Read at most this many bytes from @p apattern.
+ * @param tpattern The matching pattern for the typetag or NULL to
+ * match any typetag.
+ * @param tpattern_n Read at most this many bytes from @p tpattern.
+ * @param id The handler id.
+ * @returns 0 on success or a negative error code on failure.
+ * @note On failure the dispatch table is left as it was before the call.
+ * @note The patterns are referenced by the dispatch table and must
+ * outlive it.
+ * @note Matching handlers are reported depth first by address segment,
+ * at each segment a literal match is followed before the patterns in
+ * the order they were first added. Handlers on the same address
+ * pattern are reported in the order they were added.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ *
+ * Errors:
+ *
+ * - @ref COSC_EOVERRUN if out of nodes, hash table slots or operations,
+ * or a pattern is added to a table without operations.
+ * - @ref COSC_EINVAL if a '[' or '{' is not closed or contains a '/'.
+ */
+COSC_API cosc_int32 cosc_dispatch_add(
+    struct cosc_dispatch *dispatch,
+    const char *apattern,
+    cosc_int32 apattern_n,
+    const char *tpattern,
+    cosc_int32 tpattern_n,
+    cosc_int32 id
+);
+
+/**
+ * Find all handlers matching an address and typetag.
+ * @param dispatch The dispatch table.
+ * @param address The address.
+ * @param address_n Read at most this many bytes from @p address.
+ * @param typetag The typetag or NULL to ignore handler typetag patterns.
+ * @param typetag_n Read at most this many bytes from @p typetag.
+ * @param[out] ids If non-NULL store the matching handler ids here.
+ * @param ids_max Store at most this many ids to @p ids.
+ * @returns The number of matching handlers, this may be larger than
+ * @p ids_max.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_dispatch_match(
+    const struct cosc_dispatch *dispatch,
+    const char *address,
+    cosc_int32 address_n,
+    const char *typetag,
+    cosc_int32 typetag_n,
+    cosc_int32 *ids,
+    cosc_int32 ids_max
+);
+
+/**
+ * Find all handlers matching the address and typetag of a message.
+ * @param dispatch The dispatch table.
+ * @param buffer The buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param prefix Non-zero to expect a message with a 32-bit signed
+ * size integer prefix.
+ * @param[out] ids If non-NULL store the matching handler ids here.
+ * @param ids_max Store at most this many ids to @p ids.
+ * @returns The number of matching handlers, this may be larger than
+ * @p ids_max, or a negative error code if the signature is invalid.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_dispatch_signature_match(
+    const struct cosc_dispatch *dispatch,
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 prefix,
+    cosc_int32 *ids,
+    cosc_int32 ids_max
+);
+
+/**
+ * Compile a matching pattern into operations.
+ * @param[out] ops If non-NULL store the operations here.
+ * @param ops_max Store at most this many operations to @p ops.
+ * @param pattern The matching pattern.
+ * @param pattern_n Read at most this many bytes from @p pattern.
+ * @returns The number of operations on success or a negative error code
+ * on failure.
+ * @note If @p ops is NULL the function returns the number of operations
+ * required to compile the pattern.
+ * @note Literals and alternatives point into @p pattern, it must
+ * outlive the operations.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ *
+ * Errors:
+ *
+ * - @ref COSC_EOVERRUN if @p ops_max is too small.
+ * - @ref COSC_EINVAL if a '[' or '{' is not closed.
+ */
+COSC_API cosc_int32 cosc_pattern_compile(
+    struct cosc_pattern_op *ops,
+    cosc_int32 ops_max,
+    const char *pattern,
+    cosc_int32 pattern_n
+);
+
+/**
+ * Match an address or typetag with compiled operations.
+ * @param ops The operations.
+ * @param ops_n The number of operations in @p ops.
+ * @param s The address or typetag to match with.
+ * @param s_n Read at most this many bytes from @p s.
+ * @returns Non-zero when matching or zero for no match.
+ * @note The result is the same as cosc_pattern_match() with the
+ * pattern the operations were compiled from.
+ * @remark This function is not available if COSC_NOPATTERN
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_pattern_exec(
+    const struct cosc_pattern_op *ops,
+    cosc_int32 ops_n,
+    const char *s,
+    cosc_int32 s_n
+);
+
 #endif /* !COSC_NOPATTERN */
 
 #ifndef COSC_NOTIMETAG
@@ -978,6 +2114,57 @@ COSC_API cosc_uint64 cosc_time_to_timetag(
     cosc_uint32 nanos
 );
 
+/**
+ * Add nanoseconds to a timetag.
+ * @param timetag The timetag.
+ * @param nanos The nanoseconds to add, may be negative.
+ * @returns The timetag, wrapping around at the end of the NTP era.
+ * @note The offset is rounded to the nearest timetag fraction.
+ */
+COSC_API cosc_uint64 cosc_timetag_add(
+    cosc_uint64 timetag,
+    cosc_int64 nanos
+);
+
+/**
+ * Subtract nanoseconds from a timetag.
+ * @param timetag The timetag.
+ * @param nanos The nanoseconds to subtract, may be negative.
+ * @returns The timetag, wrapping around at the start of the NTP era.
+ * @note The offset is rounded to the nearest timetag fraction.
+ */
+COSC_API cosc_uint64 cosc_timetag_sub(
+    cosc_uint64 timetag,
+    cosc_int64 nanos
+);
+
+/**
+ * Get the signed difference between two timetags.
+ * @param a The first timetag.
+ * @param b The second timetag.
+ * @returns @p a - @p b in nanoseconds, rounded to nearest.
+ * @note The difference is taken modulo 2^64 so timetags on either
+ * side of an era rollover are within ~68 years of each other.
+ */
+COSC_API cosc_int64 cosc_timetag_diff(
+    cosc_uint64 a,
+    cosc_uint64 b
+);
+
+/**
+ * Compare two timetags.
+ * @param a The first timetag.
+ * @param b The second timetag.
+ * @returns Less than, equal to or greater than zero if @p a is
+ * before, equal to or after @p b.
+ * @note Wrap-aware, @p a is after @p b if @p a - @p b modulo 2^64
+ * is less than 2^63.
+ */
+COSC_API cosc_int32 cosc_timetag_compare(
+    cosc_uint64 a,
+    cosc_uint64 b
+);
+
 #endif /* !COSC_NOTIMETAG */
 
 #ifndef COSC_NOFLTCONV
@@ -1008,6 +2195,38 @@ COSC_API cosc_float64 cosc_float32_to_float64(
     cosc_float32 value
 );
 
+/**
+ * Convert an array of 64-bit floats to 32-bit floats.
+ * @param[out] dst Store the 32-bit floats here.
+ * @param src The 64-bit floats.
+ * @param n The number of values.
+ * @note Rounds to nearest even, values below the normal 32-bit range
+ * become subnormals and NaNs are quieted keeping the top of
+ * their payload.
+ * @remark This function is not available if cosc was built
+ * with COSC_NOFLTCONV.
+ */
+COSC_API void cosc_float64_to_float32_n(
+    cosc_float32 *dst,
+    const cosc_float64 *src,
+    cosc_int32 n
+);
+
+/**
+ * Convert an array of 32-bit floats to 64-bit floats.
+ * @param[out] dst Store the 64-bit floats here.
+ * @param src The 32-bit floats.
+ * @param n The number of values.
+ * @note The conversion is exact, NaNs are quieted keeping their payload.
+ * @remark This function is not available if cosc was built
+ * with COSC_NOFLTCONV.
+ */
+COSC_API void cosc_float32_to_float64_n(
+    cosc_float64 *dst,
+    const cosc_float32 *src,
+    cosc_int32 n
+);
+
 #endif /* !COSC_NOFLTCONV */
 
 /**
@@ -1244,6 +2463,194 @@ COSC_API cosc_int32 cosc_read_float64(
     cosc_float64 *value
 );
 
+/**
+ * Write an array of signed 32-bit integers as big endian.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note The bytes are swapped with SSE2/AVX2/NEON where available
+ * and one value at a time otherwise.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_write_int32_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_int32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of big endian signed 32-bit integers.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_read_int32_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of 32-bit floating points as big endian.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note The bytes are swapped with SSE2/AVX2/NEON where available
+ * and one value at a time otherwise.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_write_float32_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_float32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of big endian 32-bit floating points.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_read_float32_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of signed 64-bit integers as big endian.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note The bytes are swapped with SSE2/AVX2/NEON where available
+ * and one value at a time otherwise.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_write_int64_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_int64 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of big endian signed 64-bit integers.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_read_int64_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int64 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of 64-bit floating points as big endian.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note The bytes are swapped with SSE2/AVX2/NEON where available
+ * and one value at a time otherwise.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_write_float64_array(
+    void *buffer,
+    cosc_int32 size,
+    const cosc_float64 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of big endian 64-bit floating points.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if the values exceed @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_read_float64_array(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float64 *values,
+    cosc_int32 values_n
+);
+
 /**
  * Write a string.
  * @param[out] buffer If non-NULL store the OSC data here, if NULL
@@ -1483,6 +2890,37 @@ COSC_API cosc_int32 cosc_read_bundle(
     cosc_int32 *psize
 );
 
+/**
+ * Index the elements of an OSC bundle in one pass.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] elements If non-NULL store at most @p elements_n
+ * elements here, offsets are relative to @p buffer.
+ * @param elements_n The number of provided elements.
+ * @param[out] timetag If non-NULL and the function does not return
+ * a negative error code the bundle timetag is stored here.
+ * @param psize Non-zero if the bundle is prefixed with a packet size.
+ * @returns The number of elements in the bundle, which may be more than
+ * @p elements_n, or a negative error code if the operation fails.
+ * @note Only the direct elements are indexed, index a nested bundle
+ * by passing it's offset and size. Messages are not validated.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_EPSIZE if a packet size is invalid.
+ * - @ref COSC_ETYPE if @p buffer or an element starting with '#' does
+ *   not have a "#bundle" head.
+ */
+COSC_API cosc_int32 cosc_bundle_index(
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_bundle_element *elements,
+    cosc_int32 elements_n,
+    cosc_uint64 *timetag,
+    cosc_int32 psize
+);
+
 /**
  * Write an OSC message signature.
  * @param[out] buffer If non-NULL store the OSC data here, if NULL
@@ -1588,77 +3026,183 @@ COSC_API cosc_int32 cosc_write_value(
  * @returns The number of read bytes or a negative error code if the
  * operation fails.
  *
- * - @ref COSC_EOVERRUN if @p size is too small.
- * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
- * - @ref COSC_ETYPE if @p type is invalid.
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if @p type is invalid.
+ */
+COSC_API cosc_int32 cosc_read_value(
+    const void *buffer,
+    cosc_int32 size,
+    char type,
+    union cosc_value *value
+);
+
+/**
+ * Write OSC values.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param types The types, the starting comma may be omitted.
+ * @param types_n Read at most this many bytes from @p types.
+ * @param values The values.
+ * @param values_n Read at most this many members from @p values.
+ * @param[out] value_count If non-NULL the number of written values is
+ * stored here.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note If @p values_n is less than the values specified by @p typetag
+ * the remaining values are written as zero/empty.
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if on of the @p types is invalid.
+ */
+COSC_API cosc_int32 cosc_write_values(
+    void *buffer,
+    cosc_int32 size,
+    const char *types,
+    cosc_int32 types_n,
+    const union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count
+);
+
+/**
+ * Read OSC values.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param types The types, the starting comma may be omitted.
+ * @param types_n Read at most this many bytes from @p types.
+ * @param[out] values If non-NULL store the read values here.
+ * @param values_n Store at most this many members to @p values.
+ * @param[out] value_count If non-NULL the number of read values is
+ * stored here.
+ * @param exit_early If non-zero and the @p types have an array specified
+ * the function will stop reading more array members and exit early even
+ * if there are more bytes left in @p buffer.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ * @note If @p values_n is less than the values specified by @p types
+ * the remaining values are discarded.
+ * @note The value of @p exit_early has no effect if COSC_NOARRAY was
+ * defined when building.
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if @p type is invalid.
+ */
+COSC_API cosc_int32 cosc_read_values(
+    const void *buffer,
+    cosc_int32 size,
+    const char *types,
+    cosc_int32 types_n,
+    union cosc_value *values,
+    cosc_int32 values_n,
+    cosc_int32 *value_count,
+    cosc_int32 exit_early
+);
+
+/**
+ * Compile a typetag into a plan for cosc_write_values_plan() and
+ * cosc_read_values_plan().
+ * @param[out] plan If non-NULL store the plan here.
+ * @param[out] fields If non-NULL store the fields here, the plan
+ * points to them so they must outlive it.
+ * @param field_max Store at most this many fields to @p fields.
+ * @param typetag The typetag, the starting comma may be omitted.
+ * @param typetag_n Read at most this many bytes from @p typetag.
+ * @returns The number of fields if @p fields is non-NULL, the required
+ * number of fields if @p fields is NULL or a negative error code if
+ * the operation fails.
+ * @note Types after the array end are ignored, just like
+ * cosc_write_values() and cosc_read_values() do.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_EOVERRUN if @p fields is non-NULL and @p field_max is too small.
+ * - @ref COSC_ESIZEMAX if the fixed size fields exceed @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if the typetag has an invalid type or array.
+ */
+COSC_API cosc_int32 cosc_typetag_plan_compile(
+    struct cosc_typetag_plan *plan,
+    struct cosc_plan_field *fields,
+    cosc_int32 field_max,
+    const char *typetag,
+    cosc_int32 typetag_n
+);
+
+/**
+ * Get the exact size of the values of a plan without variable size fields.
+ * @param plan The plan.
+ * @param values_n The number of values, used to determine the number of
+ * array repetitions.
+ * @returns The size in bytes or a negative error code if the operation
+ * fails.
+ *
+ * Possible error codes:
+ *
+ * - @ref COSC_ETYPE if the plan has variable size fields, use
+ *   cosc_write_values_plan() with a NULL buffer instead.
+ * - @ref COSC_EOVERRUN if the size exceeds @ref COSC_SIZE_MAX.
  */
-COSC_API cosc_int32 cosc_read_value(
-    const void *buffer,
-    cosc_int32 size,
-    char type,
-    union cosc_value *value
+COSC_API cosc_int32 cosc_typetag_plan_size(
+    const struct cosc_typetag_plan *plan,
+    cosc_int32 values_n
 );
 
 /**
- * Write OSC values.
+ * Write OSC values using a compiled typetag plan.
  * @param[out] buffer If non-NULL store the OSC data here, if NULL
  * then no bytes are stored.
  * @param size Store at most this many bytes to @p buffer.
- * @param types The types, the starting comma may be omitted.
- * @param types_n Read at most this many bytes from @p types.
+ * @param plan The plan.
  * @param values The values.
- * @param values_n Read at most this many members from @p values.
+ * @param values_n The number of values.
  * @param[out] value_count If non-NULL the number of written values is
  * stored here.
  * @returns The number of written bytes if @p buffer is non-NULL,
  * the required size if @p buffer is NULL or a negative error code
  * if the operation fails.
- * @note If @p values_n is less than the values specified by @p typetag
- * the remaining values are written as zero/empty.
+ * @note Same results as cosc_write_values() with the typetag the plan
+ * was compiled from, but each run of fixed size fields is bounds checked
+ * once and the array is repeated without scanning the typetag.
  *
  * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
- * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
- * - @ref COSC_ETYPE if on of the @p types is invalid.
  */
-COSC_API cosc_int32 cosc_write_values(
+COSC_API cosc_int32 cosc_write_values_plan(
     void *buffer,
     cosc_int32 size,
-    const char *types,
-    cosc_int32 types_n,
+    const struct cosc_typetag_plan *plan,
     const union cosc_value *values,
     cosc_int32 values_n,
     cosc_int32 *value_count
 );
 
 /**
- * Read OSC values.
+ * Read OSC values using a compiled typetag plan.
  * @param buffer Read bytes from this buffer.
  * @param size Read at most this many bytes from @p buffer.
- * @param types The types, the starting comma may be omitted.
- * @param types_n Read at most this many bytes from @p types.
+ * @param plan The plan.
  * @param[out] values If non-NULL store the read values here.
  * @param values_n Store at most this many members to @p values.
  * @param[out] value_count If non-NULL the number of read values is
  * stored here.
- * @param exit_early If non-zero and the @p types have an array specified
- * the function will stop reading more array members and exit early even
- * if there are more bytes left in @p buffer.
+ * @param exit_early If non-zero and the plan has an array the function
+ * will stop reading more array members and exit early even if there
+ * are more bytes left in @p buffer.
  * @returns The number of read bytes or a negative error code if the
  * operation fails.
- * @note If @p values_n is less than the values specified by @p types
- * the remaining values are discarded.
- * @note The value of @p exit_early has no effect if COSC_NOARRAY was
- * defined when building.
+ * @note Same results as cosc_read_values() with the typetag the plan
+ * was compiled from.
  *
  * - @ref COSC_EOVERRUN if @p size is too small.
- * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
- * - @ref COSC_ETYPE if @p type is invalid.
+ * - @ref COSC_ESIZEMAX if a string or blob exceeds @ref COSC_SIZE_MAX.
  */
-COSC_API cosc_int32 cosc_read_values(
+COSC_API cosc_int32 cosc_read_values_plan(
     const void *buffer,
     cosc_int32 size,
-    const char *types,
-    cosc_int32 types_n,
+    const struct cosc_typetag_plan *plan,
     union cosc_value *values,
     cosc_int32 values_n,
     cosc_int32 *value_count,
@@ -1732,6 +3276,222 @@ COSC_API cosc_int32 cosc_read_message(
     cosc_int32 exit_early
 );
 
+/**
+ * Write an OSC message from the members of a struct.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param address The address.
+ * @param address_n Read at most this many bytes from @p address.
+ * @param bindings The bindings, one per value. The typetag is made
+ * from their types.
+ * @param bindings_n The number of bindings.
+ * @param data A pointer to the struct, if NULL the values are written
+ * as zero/empty.
+ * @param psize 0 for no packet size integer, < 0 to write a packet
+ * size integer based on the message data or > 0 to set the
+ * packet size to a specific value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note Unlike cosc_write_message() no array of @ref cosc_value is
+ * needed, the values are written directly from @p data.
+ * @note The message address is NOT validated.
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if the message exceeds @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if the type of a binding is invalid.
+ * - @ref COSC_EINVAL if a 'b' binding has no size member.
+ * - @ref COSC_EPSIZE if @p psize > 0 and is invalid or too small.
+ */
+COSC_API cosc_int32 cosc_write_message_from(
+    void *buffer,
+    cosc_int32 size,
+    const char *address,
+    cosc_int32 address_n,
+    const struct cosc_binding *bindings,
+    cosc_int32 bindings_n,
+    const void *data,
+    cosc_int32 psize
+);
+
+/**
+ * Read an OSC message into the members of a struct.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] address If non-NULL store a pointer to the address here.
+ * @param[out] address_n If non-NULL store the address length here.
+ * @param bindings The bindings, one per value.
+ * @param bindings_n The number of bindings.
+ * @param[out] data If non-NULL a pointer to the struct to store the
+ * values in.
+ * @param[out] psize If non-NULL the message is expected to start with
+ * a packet size integer and it is stored here.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ * @note Strings and blobs point into @p buffer.
+ * @note If the function fails @p data may be partially written.
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if the message exceeds @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if the type of a binding is invalid.
+ * - @ref COSC_EPSIZE if the packet size is invalid.
+ * - @ref COSC_EMSGTYPE if the message typetag does not match the
+ *   types of @p bindings.
+ */
+COSC_API cosc_int32 cosc_read_message_into(
+    const void *buffer,
+    cosc_int32 size,
+    const char **address,
+    cosc_int32 *address_n,
+    const struct cosc_binding *bindings,
+    cosc_int32 bindings_n,
+    void *data,
+    cosc_int32 *psize
+);
+
+/**
+ * Set up a view of an OSC message without reading its values.
+ * @param[out] view The view.
+ * @param buffer Read bytes from this buffer, it must outlive the view.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] args If non-NULL cache the value locations here, it must
+ * outlive the view.
+ * @param args_max Cache at most this many value locations.
+ * @param[out] psize If non-NULL the message is expected to start with
+ * a packet size integer and it is stored here, the values are then
+ * limited to the packet size.
+ * @returns The number of bytes read for the signature or a negative
+ * error code if the operation fails.
+ * @note The message address is NOT validated.
+ * @note Values after the first @p args_max that are not part of a fixed
+ * size array run are found by walking from the first value.
+ *
+ * - @ref COSC_EOVERRUN if @p size is too small.
+ * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if message typetag is invalid.
+ * - @ref COSC_EPSIZE if the packet size is invalid.
+ */
+COSC_API cosc_int32 cosc_message_view_setup(
+    struct cosc_message_view *view,
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_message_arg *args,
+    cosc_int32 args_max,
+    cosc_int32 *psize
+);
+
+/**
+ * Read a value of a message view.
+ * @param view The view.
+ * @param index The index of the value, types T, F, N and I have no
+ * value and are not counted.
+ * @param[out] type If non-NULL store the type here.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code if the
+ * operation fails.
+ * @note Strings and blobs point into the buffer of the view.
+ *
+ * - @ref COSC_EOVERRUN if the values are truncated.
+ * - @ref COSC_ESIZEMAX if a string or blob exceeds @ref COSC_SIZE_MAX.
+ * - @ref COSC_EINVAL if @p index is out of range.
+ */
+COSC_API cosc_int32 cosc_message_view_get(
+    struct cosc_message_view *view,
+    cosc_int32 index,
+    char *type,
+    union cosc_value *value
+);
+
+/**
+ * Resolve all values of a message view.
+ * @param view The view.
+ * @param[out] size If non-NULL store the byte size of the values here.
+ * @returns The number of values or a negative error code if the
+ * operation fails.
+ *
+ * - @ref COSC_EOVERRUN if the values are truncated.
+ * - @ref COSC_ESIZEMAX if a string or blob exceeds @ref COSC_SIZE_MAX.
+ */
+COSC_API cosc_int32 cosc_message_view_count(
+    struct cosc_message_view *view,
+    cosc_int32 *size
+);
+
+/**
+ * Copy an OSC message with a new address and/or values removed from
+ * and appended to the end, without decoding the values.
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param message The message without any packet size integer.
+ * @param message_size The exact byte size of @p message.
+ * @param edit The changes or NULL to copy the message as is.
+ * @param psize 0 for no packet size integer, < 0 to write a packet
+ * size integer based on the message data or > 0 to set the
+ * packet size to a specific value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ * @note The values that are kept are moved as a single block, @p buffer
+ * and @p message may overlap to edit in place but the strings and values
+ * of @p edit must not point into @p buffer.
+ * @note The new address is NOT validated.
+ *
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small
+ *   or if @p message is truncated.
+ * - @ref COSC_ESIZEMAX if the message exceeds @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if the message typetag or the appended types are
+ *   invalid or if types are removed or appended to a typetag with
+ *   an array.
+ * - @ref COSC_EINVAL if more bytes are stripped than the address has or
+ *   more types removed than the typetag has.
+ * - @ref COSC_EPSIZE if @p psize > 0 and is invalid or too small.
+ */
+COSC_API cosc_int32 cosc_edit_message(
+    void *buffer,
+    cosc_int32 size,
+    const void *message,
+    cosc_int32 message_size,
+    const struct cosc_message_edit *edit,
+    cosc_int32 psize
+);
+
+/**
+ * Validate the structure of a bundle or message without decoding
+ * any values.
+ * @param buffer Read bytes from this buffer.
+ * @param size The size of the packet, read at most this many bytes
+ * from @p buffer.
+ * @param flags @ref COSC_PACKET_PSIZE and/or @ref COSC_PACKET_ADDRESS.
+ * @param[out] stats If non-NULL store what was found here, if the
+ * function fails it counts what was found before the error.
+ * @returns The size of the packet or a negative error code if the
+ * packet is invalid.
+ * @note Without @ref COSC_PACKET_PSIZE the packet must be exactly
+ * @p size bytes, with it the packet size must fit in @p size.
+ * @note Bundle element sizes, typetags and the bounds of strings and
+ * blobs are checked, the values of each message must exactly fill it.
+ * @note The nesting is walked without recursion and limited to
+ * @ref COSC_PACKET_DEPTH_MAX bundles.
+ *
+ * - @ref COSC_EOVERRUN if a bundle, message or value is truncated.
+ * - @ref COSC_ESIZEMAX if a size exceeds @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if a typetag is invalid or a bundle does not start
+ *   with "#bundle".
+ * - @ref COSC_EPSIZE if a packet size or bundle element size is invalid
+ *   or does not match the message.
+ * - @ref COSC_EINVAL if an address is invalid and
+ *   @ref COSC_PACKET_ADDRESS is set.
+ * - @ref COSC_ELEVELMAX if the bundles are nested too deep.
+ */
+COSC_API cosc_int32 cosc_packet_validate(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 flags,
+    struct cosc_packet_stats *stats
+);
+
 #if !defined(COSC_NOSTDLIB) && !defined(COSC_NODUMP)
 
 /**
@@ -1844,6 +3604,87 @@ COSC_API void cosc_writer_setup(
     cosc_uint32 flags
 );
 
+/**
+ * Setup a serial for measuring the size of a packet.
+ * @param[out] serial The serial.
+ * @param levels Provided levels, must point to an array
+ * of levels with at least one member.
+ * @param level_max The number of provided levels, must
+ * be at least 1.
+ * @param flags Serial flags, see COSC_SERIAL_* macros.
+ * @note The serial accepts the same cosc_writer_*() calls as a regular
+ * writer but nothing is stored, cosc_serial_get_size() returns the
+ * exact number of bytes the same calls write to a buffer.
+ * @note The typetag given to cosc_writer_start_message() is referenced
+ * and must stay valid until the message is ended.
+ * @see @ref COSC_SERIAL_PSIZE.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ */
+COSC_API void cosc_measure_setup(
+    struct cosc_serial *serial,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+);
+
+/**
+ * Setup a serial for writing scatter/gather segments.
+ * @param[out] serial The serial.
+ * @param buffer A writable scratch buffer for headers, scalars and
+ * padding, must not be NULL.
+ * @param buffer_size The size of the scratch buffer.
+ * @param levels Provided levels, must point to an array
+ * of levels with at least one member.
+ * @param level_max The number of provided levels, must
+ * be at least 1.
+ * @param flags Serial flags, see COSC_SERIAL_* macros.
+ * @param iov Provided segments, must not be NULL.
+ * @param iov_max The number of provided segments, each referenced
+ * payload uses two and the finishing segment one.
+ * @param iov_min Strings, blobs and blob bytes of at least this many
+ * bytes are referenced in place instead of copied into @p buffer.
+ * @note Referenced memory must stay valid and unchanged until the
+ * segments have been sent.
+ * @note When the segments run out payloads are copied to @p buffer
+ * like a regular writer does. Whole messages written with
+ * cosc_writer_message() are always copied.
+ * @see cosc_writer_finish_iovec().
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ */
+COSC_API void cosc_writer_setup_iovec(
+    struct cosc_serial *serial,
+    void *buffer,
+    cosc_int32 buffer_size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags,
+    struct cosc_iovec *iov,
+    cosc_int32 iov_max,
+    cosc_int32 iov_min
+);
+
+/**
+ * Finish the segments of an iovec writer.
+ * @param serial The serial.
+ * @returns The number of segments, which can be passed to `writev()`
+ * or `sendmsg()` by casting the array to `struct iovec *`, or a
+ * negative error code on failure.
+ * @note Empty segments are removed. Reset the serial before writing
+ * again, the buffer size is kept.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial is not an iovec writer.
+ * - @ref COSC_ELEVELTYPE if a level has not been ended.
+ */
+COSC_API cosc_int32 cosc_writer_finish_iovec(
+    struct cosc_serial *serial
+);
+
 /**
  * Start a new bundle level.
  * @param serial The serial.
@@ -2100,6 +3941,118 @@ COSC_API cosc_int32 cosc_writer_float64(
     cosc_float64 value
 );
 
+/**
+ * Write an array of signed 32-bit integers.
+ * @param serial The serial.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'i' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'i' are written with the bulk byte swap.
+ * @note On failure the values written before the failing run remain.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a reader.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to add the value to a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_writer_int32_array(
+    struct cosc_serial *serial,
+    const cosc_int32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of 32-bit floats.
+ * @param serial The serial.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'f' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'f' are written with the bulk byte swap.
+ * @note On failure the values written before the failing run remain.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a reader.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to add the value to a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_writer_float32_array(
+    struct cosc_serial *serial,
+    const cosc_float32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of signed 64-bit integers.
+ * @param serial The serial.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'h' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'h' are written with the bulk byte swap.
+ * @note On failure the values written before the failing run remain.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a reader.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to add the value to a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_writer_int64_array(
+    struct cosc_serial *serial,
+    const cosc_int64 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Write an array of 64-bit floats.
+ * @param serial The serial.
+ * @param values The values, if NULL zeros are written.
+ * @param values_n The number of values.
+ * @returns The number of written bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'd' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'd' are written with the bulk byte swap.
+ * @note On failure the values written before the failing run remain.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a reader.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to add the value to a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_writer_float64_array(
+    struct cosc_serial *serial,
+    const cosc_float64 *values,
+    cosc_int32 values_n
+);
+
 /**
  * Write a string.
  * @param serial The serial.
@@ -2240,15 +4193,49 @@ COSC_API cosc_int32 cosc_writer_value(
  * @remark This function is not available if COSC_NOWRITER
  * was defined when compiling.
  *
- * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
- * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
- * - @ref COSC_ETYPE if message typetag is invalid.
- * - @ref COSC_EPSIZE if @p size > 0 and is invalid or too small.
+ * - @ref COSC_EOVERRUN if @p buffer is non-NULL and @p size is too small.
+ * - @ref COSC_ESIZEMAX if @p size > @ref COSC_SIZE_MAX.
+ * - @ref COSC_ETYPE if message typetag is invalid.
+ * - @ref COSC_EPSIZE if @p size > 0 and is invalid or too small.
+ */
+COSC_API cosc_int32 cosc_writer_message(
+    struct cosc_serial *serial,
+    const struct cosc_message *message,
+    cosc_int32 *value_count
+);
+
+/**
+ * Write a batch of OSC messages to the current bundle.
+ * @param serial The serial.
+ * @param messages The messages.
+ * @param messages_n The number of messages.
+ * @param[out] message_count If non-NULL the number of completely written
+ * messages is stored here.
+ * @returns The number of written bytes or a negative error code if the
+ * operation fails.
+ * @note Same output as calling cosc_writer_message() for each message,
+ * but the serial is checked once, each message is written straight into
+ * the buffer with its size patched in afterwards and the typetag plan
+ * is only compiled again when the typetag differs from the previous
+ * message.
+ * @note If a message fails the messages before it are kept.
+ * @note The message addresses are NOT validated.
+ * @remark This function is not available if COSC_NOWRITER
+ * was defined when compiling.
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a reader or @p messages
+ *   is invalid.
+ * - @ref COSC_EPSIZEFLAG if more than one message is written at the top
+ *   level without the @ref COSC_SERIAL_PSIZE flag.
+ * - @ref COSC_ELEVELTYPE if the current level is not a bundle or blob.
+ * - @ref COSC_EOVERRUN if the buffer is too small.
+ * - @ref COSC_ETYPE if a message typetag is invalid.
  */
-COSC_API cosc_int32 cosc_writer_message(
+COSC_API cosc_int32 cosc_writer_messages(
     struct cosc_serial *serial,
-    const struct cosc_message *message,
-    cosc_int32 *value_count
+    const struct cosc_message *messages,
+    cosc_int32 messages_n,
+    cosc_int32 *message_count
 );
 
 /**
@@ -2646,6 +4633,122 @@ COSC_API cosc_int32 cosc_reader_float64(
     cosc_float64 *value
 );
 
+/**
+ * Read an array of signed 32-bit integers.
+ * @param serial The serial.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'i' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'i' are read with the bulk byte swap.
+ * @note On failure the values read before the failing run remain.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a writer.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to read the value from a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_reader_int32_array(
+    struct cosc_serial *serial,
+    cosc_int32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of 32-bit floats.
+ * @param serial The serial.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'f' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'f' are read with the bulk byte swap.
+ * @note On failure the values read before the failing run remain.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a writer.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to read the value from a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_reader_float32_array(
+    struct cosc_serial *serial,
+    cosc_float32 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of signed 64-bit integers.
+ * @param serial The serial.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'h' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'h' are read with the bulk byte swap.
+ * @note On failure the values read before the failing run remain.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a writer.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to read the value from a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_reader_int64_array(
+    struct cosc_serial *serial,
+    cosc_int64 *values,
+    cosc_int32 values_n
+);
+
+/**
+ * Read an array of 64-bit floats.
+ * @param serial The serial.
+ * @param[out] values If non-NULL and the function does not return a
+ * negative error code the values are stored here.
+ * @param values_n The number of values.
+ * @returns The number of read bytes or a negative error
+ * code on failure.
+ * @note In a message each value must match a 'd' in the typetag,
+ * array starts are skipped and array ends repeat the array. Runs of
+ * 'd' are read with the bulk byte swap.
+ * @note On failure the values read before the failing run remain.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the serial was setup as a writer.
+ * - @ref COSC_EOVERRUN if the operation will overrun the buffer.
+ * - @ref COSC_ELEVELTYPE if the current level does not accept the value.
+ * - @ref COSC_EMSGTYPE if trying to read the value from a message where
+ *   the value type does not match the typetag.
+ */
+COSC_API cosc_int32 cosc_reader_float64_array(
+    struct cosc_serial *serial,
+    cosc_float64 *values,
+    cosc_int32 values_n
+);
+
 /**
  * Write a string.
  * @param serial The serial.
@@ -2874,8 +4977,442 @@ COSC_API cosc_int32 cosc_reader_repeat(
     struct cosc_serial *serial
 );
 
+/**
+ * Setup a stream for reading packet size prefixed packets, i.e
+ * OSC 1.0 over TCP.
+ * @param[out] stream The stream.
+ * @param buffer A writable tail buffer, must be large enough to
+ * hold the largest message that is split between chunks.
+ * @param buffer_size The size of the tail buffer.
+ * @param levels Provided levels, one for each nested bundle.
+ * @param level_max The number of provided levels.
+ * @note The stream has no use after an error and must be setup again.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ */
+COSC_API void cosc_stream_setup(
+    struct cosc_stream *stream,
+    void *buffer,
+    cosc_int32 buffer_size,
+    struct cosc_level *levels,
+    cosc_int32 level_max
+);
+
+/**
+ * Feed the next chunk to a stream.
+ * @param stream The stream.
+ * @param chunk The chunk, must stay valid until cosc_stream_next()
+ * returns 0.
+ * @param chunk_size The size of the chunk.
+ * @returns 0 on success or a negative error code on failure.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if the previous chunk has not been consumed,
+ *   call cosc_stream_next() until it returns 0 first.
+ */
+COSC_API cosc_int32 cosc_stream_feed(
+    struct cosc_stream *stream,
+    const void *chunk,
+    cosc_int32 chunk_size
+);
+
+/**
+ * Get the next event of a stream.
+ * @param stream The stream.
+ * @param[out] event The event, must not be NULL.
+ * @returns The event type, 0 if the current chunk has been consumed
+ * and more data is required or a negative error code on failure.
+ * @note Messages that lie entirely within a chunk are not copied,
+ * only the start of a split element is copied to the tail buffer.
+ * @note Bundles are started as soon as their timetag is available,
+ * elements are emitted without waiting for the whole bundle.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EPSIZE if a packet size is invalid or exceeds the
+ *   bundle it is in.
+ * - @ref COSC_ETYPE if an element starting with '#' is not a bundle.
+ * - @ref COSC_ELEVELMAX if bundles are nested deeper than the
+ *   provided levels.
+ * - @ref COSC_EOVERRUN if a split element does not fit in the
+ *   tail buffer.
+ */
+COSC_API cosc_int32 cosc_stream_next(
+    struct cosc_stream *stream,
+    struct cosc_stream_event *event
+);
+
+/**
+ * Called by cosc_walk() for each event.
+ * @param event The event, the same as cosc_stream_next() would produce
+ * except that message data points into the walked buffer.
+ * @param context The context passed to cosc_walk().
+ * @returns Zero or positive to continue or a negative value to stop
+ * the walk.
+ */
+typedef cosc_int32 (*cosc_walk_callback)(
+    const struct cosc_stream_event *event,
+    void *context
+);
+
+/**
+ * Walk a whole packet in one loop and call a callback for each bundle
+ * start, message and bundle end.
+ * @param buffer Read bytes from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] levels Track the nested bundles here.
+ * @param level_max The number of @p levels, the maximum nesting.
+ * @param flags @ref COSC_SERIAL_PSIZE if the packet is prefixed
+ * with a packet size.
+ * @param callback The callback.
+ * @param context Passed to @p callback.
+ * @returns The number of walked bytes, the negative value returned by
+ * @p callback or a negative error code on failure.
+ * @note Without @ref COSC_SERIAL_PSIZE the packet is @p size bytes,
+ * with it the packet size must fit in @p size and the return value
+ * is where the next packet starts.
+ * @note Messages are not parsed, pass them to cosc_read_message() or
+ * cosc_message_view_setup() in the callback. Events that come before
+ * an error in the packet have already been delivered.
+ * @remark This function is not available if COSC_NOREADER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EOVERRUN if a bundle or element is truncated.
+ * - @ref COSC_EPSIZE if a packet size or element size is invalid or
+ *   exceeds the bundle it is in.
+ * - @ref COSC_ETYPE if an element starting with '#' is not a bundle.
+ * - @ref COSC_ELEVELMAX if bundles are nested deeper than
+ *   @p level_max.
+ */
+COSC_API cosc_int32 cosc_walk(
+    const void *buffer,
+    cosc_int32 size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_int32 flags,
+    cosc_walk_callback callback,
+    void *context
+);
+
+#endif /* !COSC_NOREADER */
+
+#ifndef COSC_NORING
+
+/**
+ * Setup a packet ring buffer.
+ * @param[out] ring The ring.
+ * @param buffer Caller provided storage aligned to 8 bytes, must not
+ * be NULL.
+ * @param size The storage size, must be a power of two and at least 16.
+ * @returns 0 on success or a negative error code on failure.
+ * @note Each packet uses an 8 byte header and is padded to 8 bytes.
+ * @note Any number of threads may reserve and commit, only one
+ * thread at a time may peek and release.
+ * @remark This function is not available if COSC_NORING
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p buffer is not aligned or @p size is invalid.
+ */
+COSC_API cosc_int32 cosc_ring_setup(
+    struct cosc_ring *ring,
+    void *buffer,
+    cosc_int32 size
+);
+
+/**
+ * Reserve space for a packet in a ring.
+ * @param ring The ring.
+ * @param size The maximum packet size.
+ * @param[out] data The reserved space is stored here, must not be NULL.
+ * @returns A slot to commit or a negative error code on failure.
+ * @note Lock-free, the reservation is retried if another thread
+ * reserved at the same time.
+ * @remark This function is not available if COSC_NORING
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p size is negative.
+ * - @ref COSC_ESIZEMAX if @p size exceeds half the storage size - 8.
+ * - @ref COSC_EOVERRUN if the ring is currently full.
+ */
+COSC_API cosc_int32 cosc_ring_reserve(
+    struct cosc_ring *ring,
+    cosc_int32 size,
+    void **data
+);
+
+/**
+ * Commit a reserved packet, making it available to the consumer.
+ * @param ring The ring.
+ * @param slot A slot returned by cosc_ring_reserve().
+ * @param size The packet size, at most the reserved size. If zero the
+ * reservation is cancelled and the consumer skips it.
+ * @returns 0 on success or a negative error code on failure.
+ * @note Wait-free.
+ * @remark This function is not available if COSC_NORING
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p size exceeds the reserved size.
+ */
+COSC_API cosc_int32 cosc_ring_commit(
+    struct cosc_ring *ring,
+    cosc_int32 slot,
+    cosc_int32 size
+);
+
+/**
+ * Get the oldest committed packet of a ring.
+ * @param ring The ring.
+ * @param[out] data If non-NULL the packet is stored here.
+ * @returns The packet size or 0 if the oldest packet has not been
+ * committed yet.
+ * @note Packets are consumed in reserve order, a packet that is
+ * reserved but not committed holds back the packets after it.
+ * @remark This function is not available if COSC_NORING
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_ring_peek(
+    struct cosc_ring *ring,
+    const void **data
+);
+
+/**
+ * Release the oldest committed packet of a ring.
+ * @param ring The ring.
+ * @returns The released packet size or 0 if there was no committed packet.
+ * @remark This function is not available if COSC_NORING
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_ring_release(
+    struct cosc_ring *ring
+);
+
+#ifndef COSC_NOWRITER
+
+/**
+ * Reserve a packet in a ring and setup a serial for writing to it.
+ * @param ring The ring.
+ * @param[out] serial The serial.
+ * @param size The maximum packet size.
+ * @param levels Provided levels, must point to an array
+ * of levels with at least one member.
+ * @param level_max The number of provided levels, must
+ * be at least 1.
+ * @param flags Serial flags, see COSC_SERIAL_* macros.
+ * @returns A slot to commit with cosc_ring_writer_commit() or a
+ * negative error code on failure, see cosc_ring_reserve().
+ * @remark This function is not available if COSC_NORING or
+ * COSC_NOWRITER was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_ring_writer_setup(
+    struct cosc_ring *ring,
+    struct cosc_serial *serial,
+    cosc_int32 size,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+);
+
+/**
+ * Commit the written size of a serial setup with cosc_ring_writer_setup().
+ * @param ring The ring.
+ * @param serial The serial.
+ * @param slot The slot returned by cosc_ring_writer_setup().
+ * @returns The committed size or a negative error code on failure.
+ * @remark This function is not available if COSC_NORING or
+ * COSC_NOWRITER was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_ELEVELTYPE if a level has not been ended, nothing is
+ *   committed.
+ */
+COSC_API cosc_int32 cosc_ring_writer_commit(
+    struct cosc_ring *ring,
+    const struct cosc_serial *serial,
+    cosc_int32 slot
+);
+
+#endif /* !COSC_NOWRITER */
+
+#ifndef COSC_NOREADER
+
+/**
+ * Setup a serial for reading the oldest committed packet of a ring.
+ * @param ring The ring.
+ * @param[out] serial The serial.
+ * @param levels Provided levels, must point to an array
+ * of levels with at least one member.
+ * @param level_max The number of provided levels, must
+ * be at least 1.
+ * @param flags Serial flags, see COSC_SERIAL_* macros.
+ * @returns The packet size or 0 if there is no committed packet,
+ * in which case @p serial is not setup.
+ * @note Call cosc_ring_release() when done reading.
+ * @remark This function is not available if COSC_NORING or
+ * COSC_NOREADER was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_ring_reader_setup(
+    struct cosc_ring *ring,
+    struct cosc_serial *serial,
+    struct cosc_level *levels,
+    cosc_int32 level_max,
+    cosc_uint32 flags
+);
+
 #endif /* !COSC_NOREADER */
 
+#endif /* !COSC_NORING */
+
+#ifndef COSC_NOSCHEDULER
+
+/**
+ * Setup a scheduler.
+ * @param[out] scheduler The scheduler.
+ * @param entries Caller provided storage, must not be NULL.
+ * @param entry_max The number of entries in @p entries, this is the
+ * maximum number of scheduled packets.
+ * @returns 0 on success or a negative error code on failure.
+ * @note Packets are referenced, not copied, and must stay valid until
+ * they are popped.
+ * @remark This function is not available if COSC_NOSCHEDULER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p entries is NULL or @p entry_max < 1.
+ */
+COSC_API cosc_int32 cosc_scheduler_setup(
+    struct cosc_scheduler *scheduler,
+    struct cosc_scheduled *entries,
+    cosc_int32 entry_max
+);
+
+/**
+ * Schedule a packet at a timetag.
+ * @param scheduler The scheduler.
+ * @param timetag The timetag, 1 means immediately and is due before
+ * any other timetag.
+ * @param packet The packet.
+ * @param size The packet size in bytes.
+ * @returns The number of scheduled packets or a negative error code
+ * on failure.
+ * @note O(log n).
+ * @remark This function is not available if COSC_NOSCHEDULER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p size is negative.
+ * - @ref COSC_EOVERRUN if the scheduler is full.
+ */
+COSC_API cosc_int32 cosc_scheduler_add(
+    struct cosc_scheduler *scheduler,
+    cosc_uint64 timetag,
+    const void *packet,
+    cosc_int32 size
+);
+
+/**
+ * Schedule a packet at its bundle timetag.
+ * @param scheduler The scheduler.
+ * @param packet The packet, a bundle or a message.
+ * @param size The packet size in bytes.
+ * @param flags @ref COSC_PACKET_PSIZE if the packet is prefixed with
+ * a packet size.
+ * @returns The number of scheduled packets or a negative error code
+ * on failure.
+ * @note Messages are scheduled immediately, just like a bundle with
+ * the timetag 1.
+ * @note O(log n).
+ * @remark This function is not available if COSC_NOSCHEDULER
+ * was defined when compiling.
+ *
+ * Error codes:
+ *
+ * - @ref COSC_EINVAL if @p size is negative.
+ * - @ref COSC_EOVERRUN if the scheduler is full or the bundle head
+ *   is truncated.
+ * - @ref COSC_EPSIZE if the packet size prefix of a bundle is invalid.
+ * - @ref COSC_ETYPE if a packet starting with '#' is not a bundle.
+ */
+COSC_API cosc_int32 cosc_scheduler_push(
+    struct cosc_scheduler *scheduler,
+    const void *packet,
+    cosc_int32 size,
+    cosc_uint32 flags
+);
+
+/**
+ * Get the next packet without removing it.
+ * @param scheduler The scheduler.
+ * @param[out] entry If non-NULL and a packet is scheduled it is
+ * stored here.
+ * @returns The number of scheduled packets.
+ * @remark This function is not available if COSC_NOSCHEDULER
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_scheduler_peek(
+    const struct cosc_scheduler *scheduler,
+    struct cosc_scheduled *entry
+);
+
+/**
+ * Remove the next packet if it is due.
+ * @param scheduler The scheduler.
+ * @param now The current time as a timetag, see cosc_time_to_timetag().
+ * @param[out] entry If non-NULL and a packet is due it is stored here.
+ * @returns 1 if a packet was due and removed, otherwise 0.
+ * @note A packet is due if its timetag is 1 or not after @p now.
+ * @note O(log n).
+ * @remark This function is not available if COSC_NOSCHEDULER
+ * was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_scheduler_pop(
+    struct cosc_scheduler *scheduler,
+    cosc_uint64 now,
+    struct cosc_scheduled *entry
+);
+
+#ifndef COSC_NOTIMETAG
+
+/**
+ * Get the time until the next packet is due.
+ * @param scheduler The scheduler.
+ * @param now The current time as a timetag, see cosc_time_to_timetag().
+ * @param[out] seconds If non-NULL the seconds are stored here, zero if
+ * the packet is already due.
+ * @param[out] nanos If non-NULL the nanoseconds are stored here, zero if
+ * the packet is already due.
+ * @returns 1 if a packet is scheduled, otherwise 0 and @p seconds and
+ * @p nanos are left untouched.
+ * @see cosc_timetag_to_time().
+ * @remark This function is not available if COSC_NOSCHEDULER or
+ * COSC_NOTIMETAG was defined when compiling.
+ */
+COSC_API cosc_int32 cosc_scheduler_wait(
+    const struct cosc_scheduler *scheduler,
+    cosc_uint64 now,
+    cosc_uint32 *seconds,
+    cosc_uint32 *nanos
+);
+
+#endif /* !COSC_NOTIMETAG */
+
+#endif /* !COSC_NOSCHEDULER */
+
 #ifdef __cplusplus
 }
 #endif
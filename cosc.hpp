@@ -0,0 +1,561 @@
+/**
+ * @file cosc.hpp
+ * @brief C++11 message codec with typetags derived at compile time.
+ * @copyright Copyright 2025 Peter Gebauer (MIT license)
+ *
+ * The typetag of a message is derived from the C++ types of its values:
+ *
+ * ```
+ * cosc_int32 n = cosc::encode(buffer, sizeof(buffer), "/synth/1/note", 60, 0.5f, "on");
+ *
+ * const char *address, *state;
+ * cosc_int32 key;
+ * cosc_float32 velocity;
+ * n = cosc::decode(buffer, n, &address, key, velocity, state);
+ * ```
+ *
+ * The typetag, its padded size and the size of the values (when none of
+ * them are strings or blobs) are constexpr members of cosc::message, and
+ * the values are written and read by a chain of inline calls to the
+ * cosc_inline.h primitives without looking at the typetag at run time.
+ *
+ * Types and their typetag:
+ *
+ * - @ref cosc_int32 'i'.
+ * - @ref cosc_float32 'f'.
+ * - @ref cosc_int64 'h'.
+ * - @ref cosc_float64 'd', unless both COSC_NOINT64 and COSC_NOFLOAT64
+ *   are defined in which case they are the same type and 'h' is used.
+ * - cosc::rgba 'r', cosc::character 'c', cosc::midi 'm' and
+ *   cosc::timetag 't'.
+ * - `const char *` and cosc::string 's'.
+ * - cosc::blob 'b'.
+ * - cosc::nil 'N' and cosc::infinitum 'I'.
+ * - `std::string_view` 's' for C++17 unless COSC_NOSTDLIB is defined.
+ *
+ * Arrays and 'T'/'F' are not supported, use the C API for those.
+ *
+ * @section license License
+ *
+ * ```unparsed
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+#ifndef COSC_HPP
+#define COSC_HPP
+
+#ifndef __cplusplus
+#error "cosc.hpp requires C++11 or later."
+#endif
+
+#include <type_traits>
+#if __cplusplus >= 201703L && !defined(COSC_NOSTDLIB)
+#include <string_view>
+#endif
+
+#include "cosc_inline.h"
+
+namespace cosc
+{
+
+/**
+ * An RGBA color, typetag 'r'.
+ */
+struct rgba
+{
+    cosc_uint32 value;
+};
+
+/**
+ * An ASCII character, typetag 'c'.
+ */
+struct character
+{
+    cosc_int32 value;
+};
+
+/**
+ * A MIDI message, typetag 'm'.
+ */
+struct midi
+{
+    unsigned char value[4];
+};
+
+/**
+ * A timetag, typetag 't'.
+ */
+struct timetag
+{
+    cosc_uint64 value;
+};
+
+/**
+ * A string with a maximum length, typetag 's'.
+ */
+struct string
+{
+    const char *data;
+    cosc_int32 length;
+};
+
+/**
+ * A blob, typetag 'b'.
+ */
+struct blob
+{
+    const void *data;
+    cosc_int32 size;
+};
+
+/**
+ * Nil, typetag 'N'.
+ */
+struct nil
+{
+};
+
+/**
+ * Infinitum, typetag 'I'.
+ */
+struct infinitum
+{
+};
+
+/**
+ * Maps a value type to its typetag, its size in bytes (-1 if variable)
+ * and functions to write and read it.
+ *
+ * Specialize it to add more types.
+ */
+template <typename T>
+struct traits;
+
+/// @cond COSC_HPP_TRAITS
+
+template <>
+struct traits<cosc_int32>
+{
+    static constexpr char type = 'i';
+    static constexpr cosc_int32 size = 4;
+    static cosc_int32 write(void *buffer, cosc_int32 n, cosc_int32 value) { return cosc_inline_write_int32(buffer, n, value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, cosc_int32 &value) { return cosc_inline_read_int32(buffer, n, &value); }
+};
+
+template <>
+struct traits<cosc_float32>
+{
+    static constexpr char type = 'f';
+    static constexpr cosc_int32 size = 4;
+    static cosc_int32 write(void *buffer, cosc_int32 n, cosc_float32 value) { return cosc_inline_write_float32(buffer, n, value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, cosc_float32 &value) { return cosc_inline_read_float32(buffer, n, &value); }
+};
+
+template <>
+struct traits<cosc_int64>
+{
+    static constexpr char type = 'h';
+    static constexpr cosc_int32 size = 8;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const cosc_int64 &value) { return cosc_inline_write_int64(buffer, n, value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, cosc_int64 &value) { return cosc_inline_read_int64(buffer, n, &value); }
+};
+
+#if !defined(COSC_NOINT64) || !defined(COSC_NOFLOAT64)
+template <>
+struct traits<cosc_float64>
+{
+    static constexpr char type = 'd';
+    static constexpr cosc_int32 size = 8;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const cosc_float64 &value) { return cosc_inline_write_float64(buffer, n, value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, cosc_float64 &value) { return cosc_inline_read_float64(buffer, n, &value); }
+};
+#endif
+
+template <>
+struct traits<rgba>
+{
+    static constexpr char type = 'r';
+    static constexpr cosc_int32 size = 4;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const rgba &value) { return cosc_inline_write_uint32(buffer, n, value.value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, rgba &value) { return cosc_inline_read_uint32(buffer, n, &value.value); }
+};
+
+template <>
+struct traits<character>
+{
+    static constexpr char type = 'c';
+    static constexpr cosc_int32 size = 4;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const character &value) { return cosc_inline_write_char(buffer, n, value.value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, character &value) { return cosc_inline_read_char(buffer, n, &value.value); }
+};
+
+template <>
+struct traits<midi>
+{
+    static constexpr char type = 'm';
+    static constexpr cosc_int32 size = 4;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const midi &value) { return cosc_write_midi(buffer, n, value.value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, midi &value) { return cosc_read_midi(buffer, n, value.value); }
+};
+
+template <>
+struct traits<timetag>
+{
+    static constexpr char type = 't';
+    static constexpr cosc_int32 size = 8;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const timetag &value) { return cosc_inline_write_uint64(buffer, n, value.value); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, timetag &value) { return cosc_inline_read_uint64(buffer, n, &value.value); }
+};
+
+template <>
+struct traits<const char *>
+{
+    static constexpr char type = 's';
+    static constexpr cosc_int32 size = -1;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const char *value) { return cosc_write_string(buffer, n, value, COSC_SIZE_MAX, 0); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, const char *&value)
+    {
+        value = (const char *)buffer;
+        return cosc_read_string(buffer, n, 0, 0, 0);
+    }
+};
+
+template <>
+struct traits<char *> : traits<const char *>
+{
+};
+
+template <>
+struct traits<string>
+{
+    static constexpr char type = 's';
+    static constexpr cosc_int32 size = -1;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const string &value) { return cosc_write_string(buffer, n, value.data, value.length, 0); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, string &value)
+    {
+        value.data = (const char *)buffer;
+        return cosc_read_string(buffer, n, 0, 0, &value.length);
+    }
+};
+
+#if __cplusplus >= 201703L && !defined(COSC_NOSTDLIB)
+template <>
+struct traits<std::string_view>
+{
+    static constexpr char type = 's';
+    static constexpr cosc_int32 size = -1;
+    static cosc_int32 write(void *buffer, cosc_int32 n, std::string_view value)
+    {
+        if (value.size() > (std::size_t)COSC_SIZE_MAX)
+            return COSC_ESIZEMAX;
+        return cosc_write_string(buffer, n, value.data(), (cosc_int32)value.size(), 0);
+    }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, std::string_view &value)
+    {
+        cosc_int32 length = 0, ret = cosc_read_string(buffer, n, 0, 0, &length);
+        if (ret >= 0)
+            value = std::string_view((const char *)buffer, length);
+        return ret;
+    }
+};
+#endif
+
+template <>
+struct traits<blob>
+{
+    static constexpr char type = 'b';
+    static constexpr cosc_int32 size = -1;
+    static cosc_int32 write(void *buffer, cosc_int32 n, const blob &value) { return cosc_write_blob(buffer, n, value.data, value.size); }
+    static cosc_int32 read(const void *buffer, cosc_int32 n, blob &value) { return cosc_read_blob(buffer, n, 0, 0, &value.data, &value.size); }
+};
+
+template <>
+struct traits<nil>
+{
+    static constexpr char type = 'N';
+    static constexpr cosc_int32 size = 0;
+    static cosc_int32 write(void *, cosc_int32, const nil &) { return 0; }
+    static cosc_int32 read(const void *, cosc_int32, nil &) { return 0; }
+};
+
+template <>
+struct traits<infinitum>
+{
+    static constexpr char type = 'I';
+    static constexpr cosc_int32 size = 0;
+    static cosc_int32 write(void *, cosc_int32, const infinitum &) { return 0; }
+    static cosc_int32 read(const void *, cosc_int32, infinitum &) { return 0; }
+};
+
+/// @endcond
+
+namespace detail
+{
+
+template <typename T>
+struct value_traits : traits<typename std::decay<T>::type>
+{
+};
+
+template <cosc_int32... Sizes>
+struct fixed_sum;
+
+template <>
+struct fixed_sum<>
+{
+    static constexpr cosc_int32 value = 0;
+};
+
+template <cosc_int32 Size, cosc_int32... Sizes>
+struct fixed_sum<Size, Sizes...>
+{
+    static constexpr cosc_int32 value = (Size < 0 || fixed_sum<Sizes...>::value < 0) ? -1 : Size + fixed_sum<Sizes...>::value;
+};
+
+inline void store_values(unsigned char *)
+{
+}
+
+template <typename T, typename... Ts>
+inline void store_values(unsigned char *buffer, const T &value, const Ts &...values)
+{
+    value_traits<T>::write(buffer, value_traits<T>::size, value);
+    store_values(buffer + value_traits<T>::size, values...);
+}
+
+inline void load_values(const unsigned char *)
+{
+}
+
+template <typename T, typename... Ts>
+inline void load_values(const unsigned char *buffer, T &value, Ts &...values)
+{
+    traits<T>::read(buffer, traits<T>::size, value);
+    load_values(buffer + traits<T>::size, values...);
+}
+
+inline cosc_int32 write_values(unsigned char *, cosc_int32, cosc_int32 req)
+{
+    return req;
+}
+
+template <typename T, typename... Ts>
+inline cosc_int32 write_values(unsigned char *buffer, cosc_int32 size, cosc_int32 req, const T &value, const Ts &...values)
+{
+    cosc_int32 sz = value_traits<T>::write(buffer ? buffer + req : 0, size - req, value);
+    if (sz < 0)
+        return sz;
+    if (sz > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    return write_values(buffer, size, req + sz, values...);
+}
+
+inline cosc_int32 read_values(const unsigned char *, cosc_int32, cosc_int32 req)
+{
+    return req;
+}
+
+template <typename T, typename... Ts>
+inline cosc_int32 read_values(const unsigned char *buffer, cosc_int32 size, cosc_int32 req, T &value, Ts &...values)
+{
+    cosc_int32 sz = traits<T>::read(buffer + req, size - req, value);
+    if (sz < 0)
+        return sz;
+    if (sz > COSC_SIZE_MAX - req)
+        return COSC_ESIZEMAX;
+    return read_values(buffer, size, req + sz, values...);
+}
+
+} // namespace detail
+
+/**
+ * A message signature known at compile time.
+ * @tparam Ts The value types, see cosc.hpp for the supported types.
+ */
+template <typename... Ts>
+struct message
+{
+
+    /**
+     * The length of the typetag, including the comma but excluding the
+     * zero terminator.
+     */
+    static constexpr cosc_int32 typetag_length = (cosc_int32)sizeof...(Ts) + 1;
+
+    /**
+     * The size of the typetag with zero padding.
+     */
+    static constexpr cosc_int32 typetag_size = (typetag_length + 4) & ~3;
+
+    /**
+     * The size of the values or -1 if any of them have variable size.
+     */
+    static constexpr cosc_int32 values_size = detail::fixed_sum<traits<Ts>::size...>::value;
+
+    /**
+     * The typetag with zero padding.
+     */
+    static constexpr char typetag[typetag_size] = {',', traits<Ts>::type...};
+
+    /**
+     * Write a message.
+     * @param[out] buffer If non-NULL store the OSC data here, if NULL
+     * then no bytes are stored.
+     * @param size Store at most this many bytes to @p buffer.
+     * @param address The address.
+     * @param values The values.
+     * @returns The number of written bytes if @p buffer is non-NULL,
+     * the required size if @p buffer is NULL or a negative error code
+     * if the operation fails, see cosc_write_message().
+     * @note The message address is NOT validated.
+     * @note The values are converted to @p Ts before they are written.
+     */
+    template <typename... Vs>
+    static cosc_int32 encode(
+        void *buffer,
+        cosc_int32 size,
+        const char *address,
+        const Vs &...values
+    )
+    {
+        static_assert(sizeof...(Vs) == sizeof...(Ts), "Wrong number of values.");
+        unsigned char *p = (unsigned char *)buffer;
+        cosc_int32 req = cosc_write_string(buffer, size, address, COSC_SIZE_MAX, 0);
+        if (req < 0)
+            return req;
+        if (req > COSC_SIZE_MAX - typetag_size)
+            return COSC_ESIZEMAX;
+        if (p)
+        {
+            if (typetag_size > size - req)
+                return COSC_EOVERRUN;
+            for (cosc_int32 i = 0; i < typetag_size; i++)
+                p[req + i] = (unsigned char)typetag[i];
+        }
+        req += typetag_size;
+        return encode_values(std::integral_constant<bool, (values_size >= 0)>(), p, size, req, values...);
+    }
+
+    /**
+     * Read a message.
+     * @param buffer Read bytes from this buffer.
+     * @param size Read at most this many bytes from @p buffer.
+     * @param[out] address If non-NULL store a pointer to the address here.
+     * @param[out] values Store the values here, strings and blobs point
+     * into @p buffer.
+     * @returns The number of read bytes or a negative error code if the
+     * operation fails, @ref COSC_EMSGTYPE if the typetag does not match.
+     * @note If the function fails @p values may be partially written.
+     */
+    static cosc_int32 decode(
+        const void *buffer,
+        cosc_int32 size,
+        const char **address,
+        Ts &...values
+    )
+    {
+        const unsigned char *p = (const unsigned char *)buffer;
+        const char *tt;
+        cosc_int32 tt_n, req = cosc_read_signature(buffer, size, address, 0, &tt, &tt_n, 0);
+        if (req < 0)
+            return req;
+        if (tt_n != typetag_length)
+            return COSC_EMSGTYPE;
+        for (cosc_int32 i = 0; i < typetag_length; i++)
+        {
+            if (tt[i] != typetag[i])
+                return COSC_EMSGTYPE;
+        }
+        return decode_values(std::integral_constant<bool, (values_size >= 0)>(), p, size, req, values...);
+    }
+
+private:
+
+    static cosc_int32 encode_values(std::true_type, unsigned char *p, cosc_int32 size, cosc_int32 req, const Ts &...values)
+    {
+        if (req > COSC_SIZE_MAX - values_size)
+            return COSC_ESIZEMAX;
+        if (p)
+        {
+            if (values_size > size - req)
+                return COSC_EOVERRUN;
+            detail::store_values(p + req, values...);
+        }
+        return req + values_size;
+    }
+
+    static cosc_int32 encode_values(std::false_type, unsigned char *p, cosc_int32 size, cosc_int32 req, const Ts &...values)
+    {
+        return detail::write_values(p, size, req, values...);
+    }
+
+    static cosc_int32 decode_values(std::true_type, const unsigned char *p, cosc_int32 size, cosc_int32 req, Ts &...values)
+    {
+        if (values_size > size - req)
+            return COSC_EOVERRUN;
+        detail::load_values(p + req, values...);
+        return req + values_size;
+    }
+
+    static cosc_int32 decode_values(std::false_type, const unsigned char *p, cosc_int32 size, cosc_int32 req, Ts &...values)
+    {
+        return detail::read_values(p, size, req, values...);
+    }
+
+};
+
+template <typename... Ts>
+constexpr char message<Ts...>::typetag[message<Ts...>::typetag_size];
+
+/**
+ * Write a message with the typetag derived from the value types.
+ * @see message::encode().
+ */
+template <typename... Ts>
+inline cosc_int32 encode(
+    void *buffer,
+    cosc_int32 size,
+    const char *address,
+    const Ts &...values
+)
+{
+    return message<typename std::decay<const Ts>::type...>::encode(buffer, size, address, values...);
+}
+
+/**
+ * Read a message with the typetag derived from the value types.
+ * @see message::decode().
+ */
+template <typename... Ts>
+inline cosc_int32 decode(
+    const void *buffer,
+    cosc_int32 size,
+    const char **address,
+    Ts &...values
+)
+{
+    return message<Ts...>::decode(buffer, size, address, values...);
+}
+
+} // namespace cosc
+
+#endif /* !COSC_HPP */
@@ -0,0 +1,696 @@
+/**
+ * @file cosc_inline.h
+ * @brief Inlinable primitives for cosc.
+ * @copyright Copyright 2025 Peter Gebauer (MIT license)
+ *
+ * Including this header after (or instead of) cosc.h exposes
+ * `static inline` versions of the byte order primitives and scalar
+ * codecs, so that a caller encoding many values does not pay for a call
+ * into another translation unit for each one. The functions behave
+ * exactly like their exported counterparts, cosc.c is implemented on
+ * top of them.
+ *
+ * Defining COSC_IMPLEMENTATION before including this header also
+ * includes cosc.c, for single translation unit builds. It must be
+ * defined in exactly one translation unit, unless COSC_API is also
+ * defined to give the functions internal linkage (for example
+ * `static inline`).
+ *
+ * The build options of cosc.h apply, they must be the same as when
+ * compiling cosc.c.
+ *
+ * - COSC_INLINE used to declare the inline functions, defaults to
+ *   `static inline`.
+ * - COSC_IMPLEMENTATION to include the implementation.
+ * - COSC_NOBUILTIN to not use compiler builtins for byte swapping and
+ *   unaligned copies.
+ *
+ * @section license License
+ *
+ * ```unparsed
+ * Copyright 2025 Peter Gebauer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ```
+ */
+#ifndef COSC_INLINE_H
+#define COSC_INLINE_H
+
+#include "cosc.h"
+
+/**
+ * Used to declare the inline functions.
+ * @def COSC_INLINE
+ */
+
+#ifndef COSC_INLINE
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define COSC_INLINE static __inline
+#else
+#define COSC_INLINE static inline
+#endif
+#endif
+
+/**
+ * Copy 4 bytes, unaligned.
+ * @def COSC_COPY32
+ * @param dst The destination.
+ * @param src The source.
+ */
+
+/**
+ * Copy 8 bytes, unaligned.
+ * @def COSC_COPY64
+ * @param dst The destination.
+ * @param src The source.
+ */
+
+/**
+ * Copy 8 bytes in reverse order, unaligned.
+ * @def COSC_COPY64SWAP
+ * @param dst The destination.
+ * @param src The source.
+ */
+
+/**
+ * Reinterpret the bits of a value as another type of the same width.
+ * @def COSC_PUN
+ * @param type_in_ The type of the value.
+ * @param type_out_ The type to return.
+ * @param value_ The value.
+ */
+
+/*
+ * Big endian OSC data is already in host order with COSC_NOSWAP or on
+ * a big endian host, then stores and loads are plain copies.
+ */
+#if defined(COSC_NOSWAP) || (defined(COSC_BIG_ENDIAN) && COSC_BIG_ENDIAN)
+#define COSC_NATIVE_ORDER
+#endif
+
+/*
+ * Host byte order, a constant when known at compile time.
+ */
+#ifdef COSC_BIG_ENDIAN
+#define COSC_HOST_BIG_ENDIAN() (COSC_BIG_ENDIAN)
+#else
+#define COSC_HOST_BIG_ENDIAN() cosc_big_endian()
+#endif
+
+/*
+ * Compiler builtins for unaligned copies and byte swaps. The swaps are
+ * only used when the target is known to be little endian at compile
+ * time, define COSC_NOBUILTIN to always use the portable byte by byte
+ * code.
+ */
+#ifndef COSC_NOBUILTIN
+#if defined(__GNUC__) || defined(__clang__)
+#define COSC_MEMCPY_BUILTIN(dst_, src_, n_) __builtin_memcpy((dst_), (src_), (n_))
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define COSC_BSWAP32(value_) __builtin_bswap32(value_)
+#define COSC_BSWAP64(value_) __builtin_bswap64(value_)
+#endif
+#elif defined(_MSC_VER) && !defined(COSC_NOSTDLIB)
+#include <stdlib.h>
+#include <string.h>
+#define COSC_MEMCPY_BUILTIN(dst_, src_, n_) memcpy((dst_), (src_), (n_))
+#define COSC_BSWAP32(value_) ((cosc_uint32)_byteswap_ulong(value_))
+#define COSC_BSWAP64(value_) ((cosc_uint64)_byteswap_uint64(value_))
+#endif
+#endif /* !COSC_NOBUILTIN */
+
+#ifdef COSC_MEMCPY_BUILTIN
+#define COSC_COPY32(dst, src) COSC_MEMCPY_BUILTIN((dst), (src), 4)
+#define COSC_COPY64(dst, src) COSC_MEMCPY_BUILTIN((dst), (src), 8)
+#else
+#define COSC_COPY32(dst, src) \
+    do { \
+        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[0]; \
+        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[1]; \
+        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[2]; \
+        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[3]; \
+    } while (0)
+#define COSC_COPY64(dst, src) \
+    do { \
+        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[0]; \
+        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[1]; \
+        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[2]; \
+        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[3]; \
+        ((unsigned char *)(dst))[4] = ((const unsigned char *)(src))[4]; \
+        ((unsigned char *)(dst))[5] = ((const unsigned char *)(src))[5]; \
+        ((unsigned char *)(dst))[6] = ((const unsigned char *)(src))[6]; \
+        ((unsigned char *)(dst))[7] = ((const unsigned char *)(src))[7]; \
+    } while (0)
+#endif
+
+#if defined(COSC_MEMCPY_BUILTIN) && defined(COSC_BSWAP32)
+#define COSC_COPY64SWAP(dst, src) \
+    do { \
+        cosc_uint32 hi_, lo_; \
+        COSC_MEMCPY_BUILTIN(&hi_, (src), 4); \
+        COSC_MEMCPY_BUILTIN(&lo_, (const unsigned char *)(src) + 4, 4); \
+        hi_ = COSC_BSWAP32(hi_); \
+        lo_ = COSC_BSWAP32(lo_); \
+        COSC_MEMCPY_BUILTIN((dst), &lo_, 4); \
+        COSC_MEMCPY_BUILTIN((unsigned char *)(dst) + 4, &hi_, 4); \
+    } while (0)
+#else
+#define COSC_COPY64SWAP(dst, src) \
+    do { \
+        ((unsigned char *)(dst))[0] = ((const unsigned char *)(src))[7]; \
+        ((unsigned char *)(dst))[1] = ((const unsigned char *)(src))[6]; \
+        ((unsigned char *)(dst))[2] = ((const unsigned char *)(src))[5]; \
+        ((unsigned char *)(dst))[3] = ((const unsigned char *)(src))[4]; \
+        ((unsigned char *)(dst))[4] = ((const unsigned char *)(src))[3]; \
+        ((unsigned char *)(dst))[5] = ((const unsigned char *)(src))[2]; \
+        ((unsigned char *)(dst))[6] = ((const unsigned char *)(src))[1]; \
+        ((unsigned char *)(dst))[7] = ((const unsigned char *)(src))[0]; \
+    } while (0)
+#endif
+
+#if __cplusplus >= 202002L && !defined(COSC_NOSTDLIB)
+#include <bit>
+#define COSC_PUN(type_in_, type_out_, value_) (std::bit_cast<type_out_>((type_in_)(value_)))
+#elif defined(__cplusplus)
+template <typename IN, typename OUT>
+inline OUT cosc_pun(IN in)
+{
+    OUT out;
+    for (unsigned i = 0; i < sizeof(out); i++)
+        ((unsigned char *)&out)[i] = ((const unsigned char *)&in)[i];
+    return out;
+}
+#define COSC_PUN(type_in_, type_out_, value_) cosc_pun<type_in_, type_out_>((type_in_)(value_))
+#else
+#define COSC_PUN(type_in_, type_out_, value_) (((union { type_in_ in; type_out_ out; }){.in=(value_)}).out)
+#endif
+
+/**
+ * Store a 32-bit unsigned integer as big endian.
+ * @param[out] buffer Store the 4 bytes here.
+ * @param value The value.
+ */
+COSC_INLINE void cosc_store_uint32(
+    void *buffer,
+    cosc_uint32 value
+)
+{
+#ifdef COSC_NATIVE_ORDER
+    COSC_COPY32(buffer, &value);
+#elif defined(COSC_BSWAP32) && defined(COSC_MEMCPY_BUILTIN)
+    cosc_uint32 tmp = COSC_BSWAP32(value);
+    COSC_MEMCPY_BUILTIN(buffer, &tmp, 4);
+#else
+    ((unsigned char *)(buffer))[0] = ((value) & 0xff000000) >> 24;
+    ((unsigned char *)(buffer))[1] = ((value) & 0xff0000) >> 16;
+    ((unsigned char *)(buffer))[2] = ((value) & 0xff00) >> 8;
+    ((unsigned char *)(buffer))[3] = (value) & 0xff;
+#endif
+}
+
+/**
+ * Load a big endian 32-bit unsigned integer.
+ * @param buffer Load the 4 bytes from here.
+ * @returns The value.
+ */
+COSC_INLINE cosc_uint32 cosc_load_uint32(
+    const void *buffer
+)
+{
+#ifdef COSC_NATIVE_ORDER
+    cosc_uint32 tmp;
+    COSC_COPY32(&tmp, buffer);
+    return tmp;
+#elif defined(COSC_BSWAP32) && defined(COSC_MEMCPY_BUILTIN)
+    cosc_uint32 tmp;
+    COSC_MEMCPY_BUILTIN(&tmp, buffer, 4);
+    return COSC_BSWAP32(tmp);
+#else
+    return (
+        ((cosc_uint32)((const unsigned char *)(buffer))[0] << 24)
+        | ((cosc_uint32)((const unsigned char *)(buffer))[1] << 16)
+        | ((cosc_uint32)((const unsigned char *)(buffer))[2] << 8)
+        | ((cosc_uint32)((const unsigned char *)(buffer))[3])
+    );
+#endif
+}
+
+/**
+ * Store a 32-bit signed integer as big endian.
+ * @param[out] buffer Store the 4 bytes here.
+ * @param value The value.
+ */
+COSC_INLINE void cosc_store_int32(
+    void *buffer,
+    cosc_int32 value
+)
+{
+    cosc_store_uint32(buffer, COSC_PUN(cosc_int32, cosc_uint32, value));
+}
+
+/**
+ * Load a big endian 32-bit signed integer.
+ * @param buffer Load the 4 bytes from here.
+ * @returns The value.
+ */
+COSC_INLINE cosc_int32 cosc_load_int32(
+    const void *buffer
+)
+{
+    return COSC_PUN(cosc_uint32, cosc_int32, cosc_load_uint32(buffer));
+}
+
+/**
+ * Store a 64-bit unsigned integer as big endian.
+ * @param[out] buffer Store the 8 bytes here.
+ * @param value The value.
+ */
+COSC_INLINE void cosc_store_uint64(
+    void *buffer,
+    cosc_uint64 value
+)
+{
+#ifdef COSC_NATIVE_ORDER
+    COSC_COPY64(buffer, &value);
+#else
+#if defined(COSC_NOINT64)
+    cosc_store_uint32(buffer, COSC_64BITS_HI(&value));
+    cosc_store_uint32((char *)buffer + 4, COSC_64BITS_LO(&value));
+#elif defined(COSC_BSWAP64) && defined(COSC_MEMCPY_BUILTIN)
+    cosc_uint64 tmp = COSC_BSWAP64(value);
+    COSC_MEMCPY_BUILTIN(buffer, &tmp, 8);
+#else
+    ((unsigned char *)buffer)[0] = (value & 0xff00000000000000ULL) >> 56;
+    ((unsigned char *)buffer)[1] = (value & 0xff000000000000ULL) >> 48;
+    ((unsigned char *)buffer)[2] = (value & 0xff0000000000ULL) >> 40;
+    ((unsigned char *)buffer)[3] = (value & 0xff00000000ULL) >> 32;
+    ((unsigned char *)buffer)[4] = (value & 0xff000000) >> 24;
+    ((unsigned char *)buffer)[5] = (value & 0xff0000) >> 16;
+    ((unsigned char *)buffer)[6] = (value & 0xff00) >> 8;
+    ((unsigned char *)buffer)[7] = value & 0xff;
+#endif
+#endif
+}
+
+/**
+ * Load a big endian 64-bit unsigned integer.
+ * @param buffer Load the 8 bytes from here.
+ * @returns The value.
+ */
+COSC_INLINE cosc_uint64 cosc_load_uint64(
+    const void *buffer
+)
+{
+#ifdef COSC_NATIVE_ORDER
+    cosc_uint64 tmp;
+    COSC_COPY64(&tmp, buffer);
+    return tmp;
+#else
+#if defined(COSC_NOINT64)
+    struct cosc_64bits tmp = COSC_64BITS_INIT(cosc_load_uint32(buffer), cosc_load_uint32((char *)buffer + 4));
+    return tmp;
+#elif defined(COSC_BSWAP64) && defined(COSC_MEMCPY_BUILTIN)
+    cosc_uint64 tmp;
+    COSC_MEMCPY_BUILTIN(&tmp, buffer, 8);
+    return COSC_BSWAP64(tmp);
+#else
+    return (
+        ((cosc_uint64)((const unsigned char *)buffer)[0] << 56)
+        | ((cosc_uint64)((const unsigned char *)buffer)[1] << 48)
+        | ((cosc_uint64)((const unsigned char *)buffer)[2] << 40)
+        | ((cosc_uint64)((const unsigned char *)buffer)[3] << 32)
+        | ((cosc_uint64)((const unsigned char *)buffer)[4] << 24)
+        | ((cosc_uint64)((const unsigned char *)buffer)[5] << 16)
+        | ((cosc_uint64)((const unsigned char *)buffer)[6] << 8)
+        | ((cosc_uint64)((const unsigned char *)buffer)[7])
+    );
+#endif
+#endif
+}
+
+/**
+ * Inline version of cosc_write_uint32().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_uint32(
+    void *buffer,
+    cosc_int32 size,
+    cosc_uint32 value
+)
+{
+    if (buffer)
+    {
+        if (size < 4) return COSC_EOVERRUN;
+        cosc_store_uint32(buffer, value);
+    }
+    return 4;
+}
+
+/**
+ * Inline version of cosc_read_uint32().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_uint32(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_uint32 *value
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    if (value) *value = cosc_load_uint32(buffer);
+    return 4;
+}
+
+/**
+ * Inline version of cosc_write_int32().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_int32(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int32 value
+)
+{
+    if (buffer)
+    {
+        if (size < 4) return COSC_EOVERRUN;
+        cosc_store_uint32(buffer, COSC_PUN(cosc_int32, cosc_uint32, value));
+    }
+    return 4;
+}
+
+/**
+ * Inline version of cosc_read_int32().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_int32(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 *value
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    if (value) *value = COSC_PUN(cosc_uint32, cosc_int32, cosc_load_uint32(buffer));
+    return 4;
+}
+
+/**
+ * Inline version of cosc_write_float32().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_float32(
+    void *buffer,
+    cosc_int32 size,
+    cosc_float32 value
+)
+{
+    if (buffer)
+    {
+        if (size < 4) return COSC_EOVERRUN;
+        cosc_store_uint32(buffer, COSC_PUN(cosc_float32, cosc_uint32, value));
+    }
+    return 4;
+}
+
+/**
+ * Inline version of cosc_read_float32().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_float32(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float32 *value
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    if (value) *value = COSC_PUN(cosc_uint32, cosc_float32, cosc_load_uint32(buffer));
+    return 4;
+}
+
+/**
+ * Inline version of cosc_write_uint64().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_uint64(
+    void *buffer,
+    cosc_int32 size,
+    cosc_uint64 value
+)
+{
+    if (buffer)
+    {
+        if (size < 8) return COSC_EOVERRUN;
+        cosc_store_uint64(buffer, value);
+    }
+    return 8;
+}
+
+/**
+ * Inline version of cosc_read_uint64().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_uint64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_uint64 *value
+)
+{
+    if (size < 8)
+        return COSC_EOVERRUN;
+    if (value) *value = cosc_load_uint64(buffer);
+    return 8;
+}
+
+/**
+ * Inline version of cosc_write_int64().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_int64(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int64 value
+)
+{
+    if (buffer)
+    {
+        if (size < 8) return COSC_EOVERRUN;
+        cosc_store_uint64(buffer, COSC_PUN(cosc_int64, cosc_uint64, value));
+    }
+    return 8;
+}
+
+/**
+ * Inline version of cosc_read_int64().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_int64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int64 *value
+)
+{
+    if (size < 8)
+        return COSC_EOVERRUN;
+    if (value) *value = COSC_PUN(cosc_uint64, cosc_int64, cosc_load_uint64(buffer));
+    return 8;
+}
+
+/**
+ * Inline version of cosc_write_float64().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_float64(
+    void *buffer,
+    cosc_int32 size,
+    cosc_float64 value
+)
+{
+    if (buffer)
+    {
+        if (size < 8)
+            return COSC_EOVERRUN;
+#ifdef COSC_NATIVE_ORDER
+        COSC_COPY64(buffer, &value);
+#elif defined(COSC_NOFLOAT64)
+        cosc_store_uint32(buffer, COSC_64BITS_HI(&value));
+        cosc_store_uint32((char *)buffer + 4, COSC_64BITS_LO(&value));
+#elif defined(COSC_NOINT64)
+        if (!COSC_HOST_BIG_ENDIAN())
+            COSC_COPY64SWAP(buffer, &value);
+        else
+            COSC_COPY64(buffer, &value);
+#else
+        cosc_store_uint64(buffer, COSC_PUN(cosc_float64, cosc_uint64, value));
+#endif
+    }
+    return 8;
+}
+
+/**
+ * Inline version of cosc_read_float64().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_float64(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_float64 *value
+)
+{
+    if (size < 8)
+        return COSC_EOVERRUN;
+#ifdef COSC_NATIVE_ORDER
+    cosc_float64 tmp;
+    COSC_COPY64(&tmp, buffer);
+    if (value) *value = tmp;
+#elif defined(COSC_NOFLOAT64)
+    cosc_float64 tmp;
+    COSC_64BITS_HI(&tmp) = cosc_load_uint32(buffer);
+    COSC_64BITS_LO(&tmp) = cosc_load_uint32((const char *)buffer + 4);
+    if (value) *value = tmp;
+#elif defined(COSC_NOINT64)
+    cosc_float64 tmp;
+    if (!COSC_HOST_BIG_ENDIAN())
+        COSC_COPY64SWAP(&tmp, buffer);
+    else
+        COSC_COPY64(&tmp, buffer);
+    if (value) *value = tmp;
+#else
+    if (value) *value = COSC_PUN(cosc_uint64, cosc_float64, cosc_load_uint64(buffer));
+#endif
+    return 8;
+}
+
+/**
+ * Inline version of cosc_write_char().
+ * @param[out] buffer If non-NULL store the OSC data here, if NULL
+ * then no bytes are stored.
+ * @param size Store at most this many bytes to @p buffer.
+ * @param value The value.
+ * @returns The number of written bytes if @p buffer is non-NULL,
+ * the required size if @p buffer is NULL or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_write_char(
+    void *buffer,
+    cosc_int32 size,
+    cosc_int32 value
+)
+{
+    if (buffer)
+    {
+        if (size < 4)
+            return COSC_EOVERRUN;
+        ((unsigned char *)buffer)[0] = value;
+        ((unsigned char *)buffer)[1] = 0;
+        ((unsigned char *)buffer)[2] = 0;
+        ((unsigned char *)buffer)[3] = 0;
+    }
+    return 4;
+}
+
+/**
+ * Inline version of cosc_read_char().
+ * @param buffer Read from this buffer.
+ * @param size Read at most this many bytes from @p buffer.
+ * @param[out] value If non-NULL store the value here.
+ * @returns The number of read bytes or a negative error code
+ * if the operation fails.
+ */
+COSC_INLINE cosc_int32 cosc_inline_read_char(
+    const void *buffer,
+    cosc_int32 size,
+    cosc_int32 *value
+)
+{
+    if (size < 4)
+        return COSC_EOVERRUN;
+    if (value)
+        *value = *(const char *)buffer;
+    return 4;
+}
+
+#ifdef COSC_IMPLEMENTATION
+#include "cosc.c"
+#endif
+
+#endif /* !COSC_INLINE_H */
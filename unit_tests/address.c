@@ -57,6 +57,121 @@ static void test_address_match_digit(void **state)
 {
     assert_true(cosc_pattern_match("/hello/0123456789/world", 1024, "/hello/##########/world", 1024));
 }
+
+static cosc_int32 compiled_match(const char *s, const char *pattern)
+{
+    struct cosc_pattern_op ops[32];
+    cosc_int32 ops_n = cosc_pattern_compile(ops, 32, pattern, 1024);
+    assert_true(ops_n >= 0);
+    assert_int_equal(cosc_pattern_compile(0, 0, pattern, 1024), ops_n);
+    return cosc_pattern_exec(ops, ops_n, s, 1024);
+}
+
+static void test_address_compiled(void **state)
+{
+    assert_true(compiled_match("/hello/world", "/hello/world"));
+    assert_true(compiled_match("/hello/world", "/hello/*"));
+    assert_true(compiled_match("/hello/world", "/hell?/wo?ld"));
+    assert_true(compiled_match("/hello/world", "/hell[xoy]/world"));
+    assert_true(compiled_match("/hello/world", "/hello/{abc,world,xyz}"));
+    assert_true(compiled_match("/hello/0123456789/world", "/hello/##########/world"));
+    assert_true(compiled_match("/Bob", "/Bob"));
+    assert_true(compiled_match("/foo", "/*o"));
+    assert_true(compiled_match("/abcbcd", "/a*bcd"));
+    assert_true(compiled_match("/abc/def", "/*/d*"));
+    assert_true(compiled_match("/abc", "/abc***"));
+    assert_true(compiled_match("", ""));
+
+    assert_false(compiled_match("/hello/world", "/hello"));
+    assert_false(compiled_match("/hello", "/hello/world"));
+    assert_false(compiled_match("/hello/world", "/hell[xy]/world"));
+    assert_false(compiled_match("/hello/world", "/hello/{abc,xyz}"));
+    assert_false(compiled_match("/hello/world", "/hello/?"));
+    assert_false(compiled_match("/hello/x", "/hello/#"));
+    assert_false(compiled_match("/abcbce", "/a*bcd"));
+}
+
+/*
+ * cosc_pattern_match() and a compiled pattern give the same result.
+ */
+static void test_address_match_compiled(void **state)
+{
+    static const struct
+    {
+        const char *s;
+        const char *pattern;
+        cosc_int32 match;
+    } table[] = {
+        {"/hello/world", "/hello/world", 1},
+        {"/hello/world", "/hello/*", 1},
+        {"/hello/world", "/*/world", 1},
+        {"/hello/world", "/*", 1},
+        {"/hello/world", "/hello", 0},
+        {"/hello", "/hello/world", 0},
+        {"/abab", "/a*b", 1},
+        {"/abac", "/a*b", 0},
+        {"/abcbcd", "/a*bcd", 1},
+        {"/abcbce", "/a*bcd", 0},
+        {"/foo", "/*o", 1},
+        {"/abc", "/abc***", 1},
+        {"/a?c", "/a*?c", 1},
+        {"/B", "/B", 1},
+        {"/Bob", "/Bob", 1},
+        {"/T", "/B", 0},
+        {"/hello/world", "/hell[xoy]/world", 1},
+        {"/hello/world", "/hell[xy]/world", 0},
+        {"/hello/world", "/*[d]", 1},
+        {"/a", "/a[b]", 0},
+        {"/hello/world", "/hello/{abc,world,xyz}", 1},
+        {"/hello/world", "/hello/{abc,xyz}", 0},
+        {"/hello/world", "/hello/{wor,world}", 0},
+        {"/hello/world", "/hello/{wor,world}ld", 1},
+        {"/a", "/a{b,}", 1},
+        {"/a0", "/a#", 1},
+        {"/ax", "/a#", 0},
+        {"/a[", "/a[", 0},
+        {",ifsb", "if*", 1},
+        {",ifsb", "*s*", 1},
+        {",ifsb", "i*i", 0},
+        {",ifsb", ",ifsb", 1},
+        {",ifsb", "####", 0},
+        {",ifTd", "##B#", 1},
+#ifndef COSC_NOARRAY
+        {",[iff]", "iff", 1},
+        {",[iff]", "i*f", 1},
+#endif
+        {",", "", 1},
+        {",", "i", 0},
+        {"", "", 1},
+        {"", "*", 1},
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    {
+        struct cosc_pattern_op ops[32];
+        cosc_int32 ops_n = cosc_pattern_compile(ops, 32, table[i].pattern, 1024);
+        cosc_int32 match = cosc_pattern_match(table[i].s, 1024, table[i].pattern, 1024);
+        assert_int_equal(match != 0, table[i].match);
+        assert_int_equal(ops_n >= 0 && cosc_pattern_exec(ops, ops_n, table[i].s, 1024), match != 0);
+    }
+}
+
+static void test_address_compile_errors(void **state)
+{
+    struct cosc_pattern_op ops[4];
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/hello/[abc", 1024), COSC_EINVAL);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/hello/{abc", 1024), COSC_EINVAL);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/a*b?c#d", 1024), COSC_EOVERRUN);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/a/{b,c,d}", 1024), COSC_EOVERRUN);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/a/{b,c}", 1024), 4);
+    assert_int_equal(ops[1].type, COSC_PATTERN_OP_STRINGSET);
+    assert_int_equal(ops[1].n, 2);
+    assert_int_equal(ops[3].type, COSC_PATTERN_OP_ALTERNATIVE);
+    assert_int_equal(ops[3].n, 1);
+    assert_int_equal(*ops[3].s, 'c');
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/a[", 3), COSC_EINVAL);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "/a[]", 3), COSC_EINVAL);
+    assert_int_equal(cosc_pattern_compile(ops, 4, "", 1024), 0);
+}
 #endif
 
 int main(void)
@@ -71,6 +186,9 @@ int main(void)
         cmocka_unit_test(test_address_match_charset),
         cmocka_unit_test(test_address_match_stringset),
         cmocka_unit_test(test_address_match_digit),
+        cmocka_unit_test(test_address_compiled),
+        cmocka_unit_test(test_address_match_compiled),
+        cmocka_unit_test(test_address_compile_errors),
 #endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
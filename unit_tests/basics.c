@@ -16,6 +16,21 @@ static int func_setup(void **state)
     return 0;
 }
 
+static void test_big_endian(void **state)
+{
+    const cosc_uint32 u = 1;
+    cosc_int32 big_endian = ((const unsigned char *)&u)[3];
+    assert_int_equal(cosc_big_endian() != 0, big_endian);
+#ifdef COSC_BIG_ENDIAN
+    assert_int_equal(COSC_BIG_ENDIAN != 0, big_endian);
+#endif
+#ifndef COSC_NOSWAP
+    // Stored big endian regardless of the host.
+    cosc_write_uint32(buffer, sizeof(buffer), 0x01020304);
+    assert_memory_equal(buffer, "\x01\x02\x03\x04", 4);
+#endif
+}
+
 //
 // 32 bit types.
 //
@@ -503,6 +518,30 @@ static void test_string_overrun(void **state)
     assert_int_equal(ret, COSC_EOVERRUN);
 }
 
+static void test_string_lengths(void **state)
+{
+    static const char chars[] = "\x01\x7f\x80\xff" "abcdefghijklmnopqrstuvwxyz0123456789";
+    char value[48];
+    cosc_int32 ret;
+    cosc_int32 len = -1;
+    for (cosc_int32 i = 0; i < 40; i++)
+    {
+        ret = cosc_write_string(buffer, sizeof(buffer), chars, i, 0);
+        assert_int_equal(ret, i + COSC_PADMUST(i));
+        ret = cosc_read_string(buffer, ret, value, sizeof(value), &len);
+        assert_int_equal(ret, i + COSC_PADMUST(i));
+        assert_int_equal(len, i);
+        assert_memory_equal(value, chars, i);
+        assert_int_equal(value[i], 0);
+        ret = cosc_read_string(buffer, sizeof(buffer), value, 3, &len);
+        assert_int_equal(ret, i + COSC_PADMUST(i));
+        assert_int_equal(len, i);
+        assert_int_equal(value[i < 3 ? i : 2], 0);
+        ret = cosc_read_string(buffer, i, 0, 0, &len);
+        assert_int_equal(ret, COSC_EOVERRUN);
+    }
+}
+
 static void test_blob(void **state)
 {
     cosc_int32 ret;
@@ -594,9 +633,108 @@ static void test_blob_psize(void **state)
     assert_int_equal(ret, COSC_ESIZEMAX);
 }
 
+//
+// Arrays, compared against the scalar functions for every length that
+// covers the vector widths and their tails.
+//
+
+#define ARRAY_MAX 37
+
+static void fill_array(void *values, cosc_int32 size)
+{
+    for (cosc_int32 i = 0; i < size; i++)
+        ((unsigned char *)values)[i] = (i * 7 + 1) & 0x3f;
+}
+
+static void test_int32_array(void **state)
+{
+    cosc_int32 values[ARRAY_MAX], output[ARRAY_MAX];
+    char expected[ARRAY_MAX * 4];
+    fill_array(values, sizeof(values));
+    for (cosc_int32 n = 0; n <= ARRAY_MAX; n++)
+    {
+        for (cosc_int32 i = 0; i < n; i++)
+            cosc_write_int32(expected + i * 4, 4, values[i]);
+        assert_int_equal(cosc_write_int32_array(NULL, 0, values, n), n * 4);
+        assert_int_equal(cosc_write_int32_array(buffer, sizeof(buffer), values, n), n * 4);
+        assert_memory_equal(buffer, expected, n * 4);
+        memset(output, 0, sizeof(output));
+        assert_int_equal(cosc_read_int32_array(buffer, sizeof(buffer), output, n), n * 4);
+        assert_memory_equal(output, values, n * sizeof(*values));
+    }
+}
+
+static void test_float32_array(void **state)
+{
+    cosc_float32 values[ARRAY_MAX], output[ARRAY_MAX];
+    char expected[ARRAY_MAX * 4];
+    fill_array(values, sizeof(values));
+    for (cosc_int32 n = 0; n <= ARRAY_MAX; n++)
+    {
+        for (cosc_int32 i = 0; i < n; i++)
+            cosc_write_float32(expected + i * 4, 4, values[i]);
+        assert_int_equal(cosc_write_float32_array(buffer, sizeof(buffer), values, n), n * 4);
+        assert_memory_equal(buffer, expected, n * 4);
+        memset(output, 0, sizeof(output));
+        assert_int_equal(cosc_read_float32_array(buffer, sizeof(buffer), output, n), n * 4);
+        assert_memory_equal(output, values, n * sizeof(*values));
+    }
+}
+
+static void test_int64_array(void **state)
+{
+    cosc_int64 values[ARRAY_MAX], output[ARRAY_MAX];
+    char expected[ARRAY_MAX * 8];
+    fill_array(values, sizeof(values));
+    for (cosc_int32 n = 0; n <= ARRAY_MAX; n++)
+    {
+        for (cosc_int32 i = 0; i < n; i++)
+            cosc_write_int64(expected + i * 8, 8, values[i]);
+        assert_int_equal(cosc_write_int64_array(buffer, sizeof(buffer), values, n), n * 8);
+        assert_memory_equal(buffer, expected, n * 8);
+        memset(output, 0, sizeof(output));
+        assert_int_equal(cosc_read_int64_array(buffer, sizeof(buffer), output, n), n * 8);
+        assert_memory_equal(output, values, n * sizeof(*values));
+    }
+}
+
+static void test_float64_array(void **state)
+{
+    cosc_float64 values[ARRAY_MAX], output[ARRAY_MAX];
+    char expected[ARRAY_MAX * 8];
+    fill_array(values, sizeof(values));
+    for (cosc_int32 n = 0; n <= ARRAY_MAX; n++)
+    {
+        for (cosc_int32 i = 0; i < n; i++)
+            cosc_write_float64(expected + i * 8, 8, values[i]);
+        assert_int_equal(cosc_write_float64_array(buffer, sizeof(buffer), values, n), n * 8);
+        assert_memory_equal(buffer, expected, n * 8);
+        memset(output, 0, sizeof(output));
+        assert_int_equal(cosc_read_float64_array(buffer, sizeof(buffer), output, n), n * 8);
+        assert_memory_equal(output, values, n * sizeof(*values));
+    }
+}
+
+static void test_array_null_overrun(void **state)
+{
+    cosc_float32 values[4];
+    char zeros[16] = {0};
+    fill_array(values, sizeof(values));
+    memset(buffer, 0xff, 16);
+    assert_int_equal(cosc_write_float32_array(buffer, sizeof(buffer), NULL, 4), 16);
+    assert_memory_equal(buffer, zeros, 16);
+    assert_int_equal(cosc_read_float32_array(buffer, sizeof(buffer), NULL, 4), 16);
+    assert_int_equal(cosc_write_float32_array(buffer, 15, values, 4), COSC_EOVERRUN);
+    assert_int_equal(cosc_read_float32_array(buffer, 15, values, 4), COSC_EOVERRUN);
+    assert_int_equal(cosc_write_float64_array(buffer, 31, NULL, 4), COSC_EOVERRUN);
+    assert_int_equal(cosc_write_float64_array(NULL, 0, NULL, COSC_SIZE_MAX / 4), COSC_ESIZEMAX);
+    assert_int_equal(cosc_read_int32_array(buffer, sizeof(buffer), NULL, -1), 0);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_big_endian, func_setup),
         cmocka_unit_test_setup(test_uint32, func_setup),
         cmocka_unit_test_setup(test_uint32_null, func_setup),
         cmocka_unit_test_setup(test_uint32_overrun, func_setup),
@@ -626,10 +764,16 @@ int main(void)
         cmocka_unit_test_setup(test_string, func_setup),
         cmocka_unit_test_setup(test_string_null, func_setup),
         cmocka_unit_test_setup(test_string_overrun, func_setup),
+        cmocka_unit_test_setup(test_string_lengths, func_setup),
         cmocka_unit_test_setup(test_blob, func_setup),
         cmocka_unit_test_setup(test_blob_null, func_setup),
         cmocka_unit_test_setup(test_blob_overrun, func_setup),
         cmocka_unit_test_setup(test_blob_psize, func_setup),
+        cmocka_unit_test_setup(test_int32_array, func_setup),
+        cmocka_unit_test_setup(test_float32_array, func_setup),
+        cmocka_unit_test_setup(test_int64_array, func_setup),
+        cmocka_unit_test_setup(test_float64_array, func_setup),
+        cmocka_unit_test_setup(test_array_null_overrun, func_setup),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
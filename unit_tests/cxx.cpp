@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc.hpp"
+
+static unsigned char buffer[256];
+static unsigned char expected[256];
+
+static int func_setup(void **state)
+{
+    memset(buffer, 0, sizeof(buffer));
+    memset(expected, 0, sizeof(expected));
+    return 0;
+}
+
+static cosc_int32 write_expected(const char *address, const char *typetag, union cosc_value *values, cosc_int32 values_n)
+{
+    struct cosc_message message;
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetag;
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = values_n;
+    return cosc_write_message(expected, sizeof(expected), &message, 0, 0);
+}
+
+static void test_typetag(void **state)
+{
+    typedef cosc::message<cosc_int32, cosc_float32, const char *> control;
+    assert_string_equal(control::typetag, ",ifs");
+    assert_int_equal(control::typetag_length, 4);
+    assert_int_equal(control::typetag_size, 8);
+    assert_int_equal(control::values_size, -1);
+    static_assert(cosc::message<cosc_int32, cosc_float32>::values_size == 8, "values_size");
+    static_assert(cosc::message<cosc_int32, cosc_float32>::typetag_size == 4, "typetag_size");
+    static_assert(cosc::message<cosc::nil, cosc::timetag>::values_size == 8, "values_size");
+    static_assert(cosc::message<>::typetag_size == 4, "typetag_size");
+    assert_string_equal((cosc::message<cosc::rgba, cosc::character, cosc::midi, cosc::blob>::typetag), ",rcmb");
+    assert_string_equal((cosc::message<cosc_int64, cosc::nil, cosc::infinitum>::typetag), ",hNI");
+}
+
+static void test_fixed(void **state)
+{
+    union cosc_value values[4];
+    cosc_int32 size, i = 0;
+    cosc_float32 f = 0;
+    cosc::rgba r = {0};
+    cosc::timetag t;
+    const char *address = 0;
+
+    values[0].i = 0x12345678;
+#ifdef COSC_NOFLOAT32
+    values[1].f = 1234;
+#else
+    values[1].f = 12.34f;
+#endif
+    values[2].r = 0x87654321;
+#ifdef COSC_NOINT64
+    values[3].t = COSC_64BITS_INIT(0x87654321, 0x12345678);
+#else
+    values[3].t = 0x8765432112345678;
+#endif
+    t.value = values[3].t;
+    size = write_expected("/fixed", ",ifrt", values, 4);
+    assert_int_equal(size, 8 + 8 + 20);
+
+    cosc::rgba rgba = {values[2].r};
+    assert_int_equal(cosc::encode(0, 0, "/fixed", values[0].i, values[1].f, rgba, t), size);
+    assert_int_equal(cosc::encode(buffer, size - 1, "/fixed", values[0].i, values[1].f, rgba, t), COSC_EOVERRUN);
+    assert_int_equal(cosc::encode(buffer, sizeof(buffer), "/fixed", values[0].i, values[1].f, rgba, t), size);
+    assert_memory_equal(buffer, expected, size);
+
+    t.value = COSC_INT64_INIT_ZERO;
+    assert_int_equal(cosc::decode(buffer, size - 1, &address, i, f, r, t), COSC_EOVERRUN);
+    assert_int_equal(cosc::decode(buffer, size, &address, i, f, r, t), size);
+    assert_string_equal(address, "/fixed");
+    assert_int_equal(i, values[0].i);
+    assert_memory_equal(&f, &values[1].f, sizeof(f));
+    assert_int_equal(r.value, values[2].r);
+    assert_memory_equal(&t.value, &values[3].t, sizeof(t.value));
+}
+
+static void test_variable(void **state)
+{
+    union cosc_value values[5];
+    cosc_int32 size, i = 0;
+    const char *address = 0, *s = 0;
+    cosc::string str = {0, 0};
+    cosc::blob b = {0, 0};
+    cosc::character c = {0};
+
+    values[0].i = 60;
+    values[1].s.s = "Hello World!";
+    values[1].s.length = COSC_SIZE_MAX;
+    values[2].s.s = "Hello World!";
+    values[2].s.length = 5;
+    values[3].b.b = "blob";
+    values[3].b.size = 3;
+    values[4].c = 'A';
+    size = write_expected("/variable", ",issbc", values, 5);
+    assert_true(size > 0);
+
+    cosc::string hello = {"Hello World!", 5};
+    cosc::blob blob = {"blob", 3};
+    cosc::character character = {'A'};
+    assert_int_equal(cosc::encode(0, 0, "/variable", 60, "Hello World!", hello, blob, character), size);
+    assert_int_equal(cosc::encode(buffer, size - 1, "/variable", 60, "Hello World!", hello, blob, character), COSC_EOVERRUN);
+    assert_int_equal(cosc::encode(buffer, sizeof(buffer), "/variable", 60, "Hello World!", hello, blob, character), size);
+    assert_memory_equal(buffer, expected, size);
+
+    assert_int_equal(cosc::decode(buffer, size - 1, &address, i, s, str, b, c), COSC_EOVERRUN);
+    assert_int_equal(cosc::decode(buffer, size, &address, i, s, str, b, c), size);
+    assert_string_equal(address, "/variable");
+    assert_int_equal(i, 60);
+    assert_string_equal(s, "Hello World!");
+    assert_int_equal(str.length, 5);
+    assert_memory_equal(str.data, "Hello", 5);
+    assert_int_equal(b.size, 3);
+    assert_memory_equal(b.data, "blo", 3);
+    assert_int_equal(c.value, 'A');
+}
+
+static void test_mismatch(void **state)
+{
+    cosc_int32 i = 0, size;
+    cosc_float32 f;
+    const char *s;
+
+    size = cosc::encode(buffer, sizeof(buffer), "/a", 1, "x");
+    assert_true(size > 0);
+    assert_int_equal(cosc::decode(buffer, size, 0, i, f), COSC_EMSGTYPE);
+    assert_int_equal(cosc::decode(buffer, size, 0, i), COSC_EMSGTYPE);
+    assert_int_equal(cosc::decode(buffer, size, 0, i, s, i), COSC_EMSGTYPE);
+    assert_int_equal(cosc::decode(buffer, size, 0, i, s), size);
+    assert_int_equal(i, 1);
+    assert_string_equal(s, "x");
+}
+
+static void test_convert(void **state)
+{
+    typedef cosc::message<cosc_float32> fixed;
+    typedef cosc::message<cosc_float32, const char *> variable;
+    cosc_float32 f = 0;
+    const char *s = 0;
+
+    // A double value is written as the declared float32, not 8 bytes.
+    memset(buffer, 0xff, sizeof(buffer));
+    assert_int_equal(fixed::encode(0, 0, "/a", 2.0), 12);
+    assert_int_equal(fixed::encode(buffer, 12, "/a", 2.0), 12);
+    assert_int_equal(buffer[12], 0xff);
+    assert_int_equal(fixed::decode(buffer, 12, 0, f), 12);
+    assert_true(f == (cosc_float32)2);
+
+    f = 0;
+    assert_int_equal(variable::encode(buffer, sizeof(buffer), "/a", 2.0, "x"), 16);
+    assert_int_equal(variable::decode(buffer, 16, 0, f, s), 16);
+    assert_true(f == (cosc_float32)2);
+    assert_string_equal(s, "x");
+}
+
+#if __cplusplus >= 201703L && !defined(COSC_NOSTDLIB)
+static void test_string_view(void **state)
+{
+    std::string_view sv("Hello World!", 5), out;
+    const char *s = 0;
+    cosc_int32 size = cosc::encode(buffer, sizeof(buffer), "/sv", sv);
+    assert_int_equal(size, 4 + 4 + 8);
+    assert_int_equal(cosc::decode(buffer, size, 0, s), size);
+    assert_string_equal(s, "Hello");
+    assert_int_equal(cosc::decode(buffer, size, 0, out), size);
+    assert_true(out == "Hello");
+}
+#endif
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_typetag, func_setup),
+        cmocka_unit_test_setup(test_fixed, func_setup),
+        cmocka_unit_test_setup(test_variable, func_setup),
+        cmocka_unit_test_setup(test_mismatch, func_setup),
+        cmocka_unit_test_setup(test_convert, func_setup),
+#if __cplusplus >= 201703L && !defined(COSC_NOSTDLIB)
+        cmocka_unit_test_setup(test_string_view, func_setup),
+#endif
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
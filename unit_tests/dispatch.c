@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc.h"
+
+#ifndef COSC_NOPATTERN
+
+static struct cosc_dispatch dispatch;
+static struct cosc_dispatch_node nodes[64];
+static cosc_int32 table[64];
+static struct cosc_pattern_op ops[64];
+
+static int setup(void **state)
+{
+    if (cosc_dispatch_setup(&dispatch, nodes, 64, table, 64, ops, 64) != 0)
+        return -1;
+    if (cosc_dispatch_add(&dispatch, "/synth/1/freq", 1024, 0, 0, 1)
+        || cosc_dispatch_add(&dispatch, "/synth/2/freq", 1024, 0, 0, 2)
+        || cosc_dispatch_add(&dispatch, "/synth/*/freq", 1024, 0, 0, 3)
+        || cosc_dispatch_add(&dispatch, "/synth/[12]/gain", 1024, 0, 0, 4)
+        || cosc_dispatch_add(&dispatch, "/synth/{1,3}/*", 1024, ",f", 1024, 5)
+        || cosc_dispatch_add(&dispatch, "/synth/1/freq", 1024, ",i", 1024, 6)
+        || cosc_dispatch_add(&dispatch, "/synth/#", 1024, 0, 0, 7)
+        || cosc_dispatch_add(&dispatch, "/", 1024, 0, 0, 8))
+        return -1;
+    return 0;
+}
+
+static void test_dispatch_match(void **state)
+{
+    cosc_int32 ids[8];
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq", 1024, ",f", 1024, ids, 8), 3);
+    assert_int_equal(ids[0], 1);
+    assert_int_equal(ids[1], 3);
+    assert_int_equal(ids[2], 5);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq", 1024, ",i", 1024, ids, 8), 3);
+    assert_int_equal(ids[0], 1);
+    assert_int_equal(ids[1], 6);
+    assert_int_equal(ids[2], 3);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq", 1024, 0, 0, ids, 8), 4);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/2/freq", 1024, ",f", 1024, ids, 8), 2);
+    assert_int_equal(ids[0], 2);
+    assert_int_equal(ids[1], 3);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/3/freq", 1024, ",f", 1024, ids, 8), 2);
+    assert_int_equal(ids[0], 3);
+    assert_int_equal(ids[1], 5);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/2/gain", 1024, ",f", 1024, ids, 8), 1);
+    assert_int_equal(ids[0], 4);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/3/gain", 1024, ",f", 1024, ids, 8), 1);
+    assert_int_equal(ids[0], 5);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/9", 1024, ",", 1024, ids, 8), 1);
+    assert_int_equal(ids[0], 7);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/", 1024, ",", 1024, ids, 8), 1);
+    assert_int_equal(ids[0], 8);
+}
+
+static void test_dispatch_nomatch(void **state)
+{
+    cosc_int32 ids[8];
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth", 1024, ",f", 1024, ids, 8), 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/12", 1024, ",f", 1024, ids, 8), 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq/x", 1024, ",f", 1024, ids, 8), 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/x", 1024, ",f", 1024, ids, 8), 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/other/1/freq", 1024, ",f", 1024, ids, 8), 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "", 1024, ",f", 1024, ids, 8), 0);
+}
+
+static void test_dispatch_ids_max(void **state)
+{
+    cosc_int32 ids[8] = {0};
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq", 1024, ",f", 1024, ids, 1), 3);
+    assert_int_equal(ids[0], 1);
+    assert_int_equal(ids[1], 0);
+    assert_int_equal(cosc_dispatch_match(&dispatch, "/synth/1/freq", 1024, ",f", 1024, 0, 0), 3);
+}
+
+static void test_dispatch_signature(void **state)
+{
+    unsigned char buffer[64];
+    cosc_int32 ids[8];
+    cosc_int32 size = cosc_write_signature(buffer, sizeof(buffer), "/synth/3/freq", 1024, ",f", 1024, 0);
+    assert_true(size > 0);
+    assert_int_equal(cosc_dispatch_signature_match(&dispatch, buffer, size, 0, ids, 8), 2);
+    assert_int_equal(ids[0], 3);
+    assert_int_equal(ids[1], 5);
+    assert_int_equal(cosc_dispatch_signature_match(&dispatch, buffer, 4, 0, ids, 8), COSC_EOVERRUN);
+}
+
+static void test_dispatch_errors(void **state)
+{
+    struct cosc_dispatch small;
+    struct cosc_dispatch_node small_nodes[4];
+    cosc_int32 small_table[2];
+    struct cosc_pattern_op small_ops[1];
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 3, small_table, 3, small_ops, 1), COSC_EINVAL);
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 0, small_table, 2, small_ops, 1), COSC_EINVAL);
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 3, small_table, 2, small_ops, 1), 0);
+    assert_int_equal(cosc_dispatch_add(&small, "/a[/]", 1024, 0, 0, 1), COSC_EINVAL);
+    assert_int_equal(cosc_dispatch_add(&small, "/a{b", 1024, 0, 0, 1), COSC_EINVAL);
+    assert_int_equal(cosc_dispatch_add(&small, "/a/b/c", 1024, 0, 0, 1), COSC_EOVERRUN);
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 3, small_table, 2, small_ops, 1), 0);
+    assert_int_equal(cosc_dispatch_add(&small, "/a*?", 1024, 0, 0, 1), COSC_EOVERRUN);
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 4, small_table, 2, small_ops, 1), 0);
+    assert_int_equal(cosc_dispatch_add(&small, "/a", 1024, 0, 0, 1), 0);
+    assert_int_equal(cosc_dispatch_add(&small, "/b", 1024, 0, 0, 2), COSC_EOVERRUN);
+}
+
+/*
+ * A failed add leaves the table as it was, both when running out of
+ * nodes and on a bad pattern after some segments were added.
+ */
+static void test_dispatch_rollback(void **state)
+{
+    struct cosc_dispatch small;
+    struct cosc_dispatch_node small_nodes[7];
+    cosc_int32 small_table[4];
+    struct cosc_pattern_op small_ops[4];
+    cosc_int32 ids[4];
+    assert_int_equal(cosc_dispatch_setup(&small, small_nodes, 7, small_table, 4, small_ops, 4), 0);
+    assert_int_equal(cosc_dispatch_add(&small, "/a/b", 1024, 0, 0, 1), 0);
+    cosc_int32 node_count = small.node_count;
+    assert_int_equal(node_count, 5);
+
+    assert_int_equal(cosc_dispatch_add(&small, "/c/d", 1024, 0, 0, 2), COSC_EOVERRUN);
+    assert_int_equal(small.node_count, node_count);
+    assert_int_equal(cosc_dispatch_add(&small, "/a/[b", 1024, 0, 0, 2), COSC_EINVAL);
+    assert_int_equal(small.node_count, node_count);
+    assert_int_equal(cosc_dispatch_add(&small, "/a/b*/c", 1024, 0, 0, 2), COSC_EOVERRUN);
+    assert_int_equal(small.node_count, node_count);
+    assert_int_equal(small.op_count, 0);
+    assert_int_equal(small_nodes[2].patterns, -1);
+    assert_int_equal(cosc_dispatch_add(&small, "/a/b", 1024, ",?*?*?", 1024, 2), COSC_EOVERRUN);
+    assert_int_equal(small.node_count, node_count);
+    assert_int_equal(small.op_count, 0);
+
+    assert_int_equal(cosc_dispatch_match(&small, "/a/b", 1024, ",", 1024, ids, 4), 1);
+    assert_int_equal(ids[0], 1);
+    assert_int_equal(cosc_dispatch_match(&small, "/c/d", 1024, ",", 1024, ids, 4), 0);
+    assert_int_equal(cosc_dispatch_match(&small, "/a/bx", 1024, ",", 1024, ids, 4), 0);
+
+    // The freed node is usable again.
+    assert_int_equal(cosc_dispatch_add(&small, "/a/c", 1024, 0, 0, 3), 0);
+    assert_int_equal(cosc_dispatch_match(&small, "/a/c", 1024, ",", 1024, ids, 4), 1);
+    assert_int_equal(ids[0], 3);
+    assert_int_equal(cosc_dispatch_match(&small, "/a/b", 1024, ",", 1024, ids, 4), 1);
+    assert_int_equal(ids[0], 1);
+}
+
+static void test_dispatch_literal_only(void **state)
+{
+    struct cosc_dispatch literal;
+    struct cosc_dispatch_node literal_nodes[8];
+    cosc_int32 literal_table[8];
+    cosc_int32 ids[4];
+    assert_int_equal(cosc_dispatch_setup(&literal, literal_nodes, 8, literal_table, 8, 0, 0), 0);
+    assert_int_equal(cosc_dispatch_add(&literal, "/a/b", 1024, 0, 0, 1), 0);
+    cosc_int32 node_count = literal.node_count;
+    assert_int_equal(cosc_dispatch_add(&literal, "/a/*", 1024, 0, 0, 2), COSC_EOVERRUN);
+    assert_int_equal(cosc_dispatch_add(&literal, "/a/b", 1024, ",f", 1024, 3), COSC_EOVERRUN);
+    assert_int_equal(literal.node_count, node_count);
+    assert_int_equal(cosc_dispatch_match(&literal, "/a/b", 1024, ",f", 1024, ids, 4), 1);
+    assert_int_equal(ids[0], 1);
+    assert_int_equal(cosc_dispatch_match(&literal, "/a/c", 1024, ",f", 1024, ids, 4), 0);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_dispatch_match, setup),
+        cmocka_unit_test_setup(test_dispatch_nomatch, setup),
+        cmocka_unit_test_setup(test_dispatch_ids_max, setup),
+        cmocka_unit_test_setup(test_dispatch_signature, setup),
+        cmocka_unit_test(test_dispatch_errors),
+        cmocka_unit_test(test_dispatch_rollback),
+        cmocka_unit_test(test_dispatch_literal_only),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#else /* !COSC_NOPATTERN */
+#include <stdio.h>
+int main(void)
+{
+    printf("Built without pattern support, skipping test.\n");
+    return 0;
+}
+#endif
@@ -157,6 +157,133 @@ static void test_float32_to_float64_range_small(void **state)
     }
 }
 
+static cosc_float64 to_float64(double value)
+{
+    cosc_float64 ret;
+    memcpy(&ret, &value, 8);
+#ifdef COSC_NOFLOAT64
+    if (!cosc_big_endian())
+    {
+        cosc_uint32 tmp = COSC_64BITS_HI(&ret);
+        COSC_64BITS_HI(&ret) = COSC_64BITS_LO(&ret);
+        COSC_64BITS_LO(&ret) = tmp;
+    }
+#endif
+    return ret;
+}
+
+static double from_float64(cosc_float64 value)
+{
+    double ret;
+#ifdef COSC_NOFLOAT64
+    if (!cosc_big_endian())
+    {
+        cosc_uint32 tmp = COSC_64BITS_HI(&value);
+        COSC_64BITS_HI(&value) = COSC_64BITS_LO(&value);
+        COSC_64BITS_LO(&value) = tmp;
+    }
+#endif
+    memcpy(&ret, &value, 8);
+    return ret;
+}
+
+static cosc_uint32 float_bits(float value)
+{
+    cosc_uint32 bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+/*
+ * Every float32 with a prime stride through the whole bit range and all
+ * subnormals widens to the same double as the hardware and narrows back
+ * to itself, NaNs come back quieted.
+ */
+static void test_float32_roundtrip(void **state)
+{
+    static cosc_float32 input[1024], output[1024];
+    static cosc_float64 wide[1024];
+    cosc_uint32 bits = 0, next = 0;
+    cosc_int32 pass = 0;
+    while (pass < 2)
+    {
+        cosc_int32 n = 0;
+        while (n < 1024 && pass < 2)
+        {
+            bits = next;
+            memcpy(input + n++, &bits, 4);
+            next = pass == 0 ? bits + 251 : bits + 1;
+            if (pass == 0 && next < bits)
+                next = 0x80000000, pass++;
+            else if (pass == 1 && next > 0x807fffff)
+                pass++;
+        }
+        cosc_float32_to_float64_n(wide, input, n);
+        cosc_float64_to_float32_n(output, wide, n);
+        for (cosc_int32 i = 0; i < n; i++)
+        {
+            float value;
+            memcpy(&value, input + i, 4);
+            double expected = value;
+            double got = from_float64(wide[i]);
+            assert_memory_equal(&got, &expected, 8);
+            cosc_uint32 in, out;
+            memcpy(&in, input + i, 4);
+            memcpy(&out, output + i, 4);
+            if ((in & 0x7f800000) == 0x7f800000 && (in & 0x7fffff))
+                in |= 0x400000;
+            assert_int_equal(out, in);
+        }
+    }
+}
+
+/*
+ * Doubles around the float32 rounding, overflow and subnormal boundaries
+ * and NaN payloads narrow to the same bits as the hardware.
+ */
+static void test_float64_to_float32_n(void **state)
+{
+    static cosc_float64 input[1024];
+    static cosc_float32 output[1024];
+    static double values[1024];
+    cosc_uint32 seed = 12345;
+    for (cosc_int32 round = 0; round < 64; round++)
+    {
+        for (cosc_int32 i = 0; i < 1024; i++)
+        {
+            cosc_uint32 hi, lo;
+            seed = seed * 1664525 + 1013904223;
+            hi = seed;
+            seed = seed * 1664525 + 1013904223;
+            lo = seed;
+            // Exponents near the float32 range, ties and NaNs.
+            switch (i & 7)
+            {
+            case 0: hi = (hi & 0x800fffff) | ((cosc_uint32)(0x380 - 30 + (lo & 63)) << 20); break;
+            case 1: hi = (hi & 0x800fffff) | ((cosc_uint32)(0x47f - 4 + (lo & 7)) << 20); break;
+            case 2: lo = (lo & 0xe0000000) | 0x10000000; break;
+            case 3: lo = (lo & 0xc0000000) | 0x20000000; hi = (hi & 0x800fffff) | 0x36a00000; break;
+            case 4: hi |= 0x7ff00000; break;
+            case 5: hi = (hi & 0x800fffff) | 0x38000000; lo = 0; break;
+            default: break;
+            }
+            cosc_uint32 words[2];
+            words[cosc_big_endian() ? 0 : 1] = hi;
+            words[cosc_big_endian() ? 1 : 0] = lo;
+            memcpy(values + i, words, 8);
+            input[i] = to_float64(values[i]);
+        }
+        cosc_float64_to_float32_n(output, input, 1024);
+        for (cosc_int32 i = 0; i < 1024; i++)
+        {
+            cosc_uint32 got;
+            memcpy(&got, output + i, 4);
+            assert_int_equal(got, float_bits((float)values[i]));
+        }
+    }
+    assert_int_equal(float_bits(from_float64(cosc_float32_to_float64(cosc_float64_to_float32(to_float64(1e-45))))), 1);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -166,6 +293,8 @@ int main(void)
         cmocka_unit_test(test_float32_to_float64_static),
         cmocka_unit_test(test_float32_to_float64_range_big),
         cmocka_unit_test(test_float32_to_float64_range_small),
+        cmocka_unit_test(test_float32_roundtrip),
+        cmocka_unit_test(test_float64_to_float32_n),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
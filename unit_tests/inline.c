@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc_inline.h"
+
+static const unsigned char bytes32[4] = {0x40, 0x49, 0x0f, 0xdb};
+static const unsigned char bytes64[8] = {0x40, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d, 0x18};
+static unsigned char buffer[16];
+
+static int func_setup(void **state)
+{
+    memset(buffer, 0, sizeof(buffer));
+    return 0;
+}
+
+static void test_store_load(void **state)
+{
+    cosc_store_uint32(buffer, cosc_load_uint32(bytes32));
+    assert_memory_equal(buffer, bytes32, 4);
+    cosc_store_int32(buffer, cosc_load_int32(bytes32));
+    assert_memory_equal(buffer, bytes32, 4);
+    cosc_store_uint64(buffer, cosc_load_uint64(bytes64));
+    assert_memory_equal(buffer, bytes64, 8);
+}
+
+static void test_uint32(void **state)
+{
+    cosc_uint32 a, b;
+    assert_int_equal(cosc_inline_read_uint32(bytes32, 4, &a), 4);
+    assert_int_equal(cosc_read_uint32(bytes32, 4, &b), 4);
+    assert_int_equal(a, b);
+    assert_int_equal(cosc_inline_write_uint32(buffer, 4, a), 4);
+    assert_memory_equal(buffer, bytes32, 4);
+    assert_int_equal(cosc_inline_write_uint32(NULL, 0, a), 4);
+    assert_int_equal(cosc_inline_write_uint32(buffer, 3, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_uint32(buffer, 3, NULL), COSC_EOVERRUN);
+}
+
+static void test_int32(void **state)
+{
+    cosc_int32 a, b;
+    assert_int_equal(cosc_inline_read_int32(bytes32, 4, &a), 4);
+    assert_int_equal(cosc_read_int32(bytes32, 4, &b), 4);
+    assert_int_equal(a, b);
+    assert_int_equal(cosc_inline_write_int32(buffer, 4, a), 4);
+    assert_memory_equal(buffer, bytes32, 4);
+    assert_int_equal(cosc_inline_write_int32(buffer, 3, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_int32(buffer, 3, NULL), COSC_EOVERRUN);
+}
+
+static void test_float32(void **state)
+{
+    cosc_float32 a, b;
+    assert_int_equal(cosc_inline_read_float32(bytes32, 4, &a), 4);
+    assert_int_equal(cosc_read_float32(bytes32, 4, &b), 4);
+    assert_memory_equal(&a, &b, 4);
+    assert_int_equal(cosc_inline_write_float32(buffer, 4, a), 4);
+    assert_memory_equal(buffer, bytes32, 4);
+    assert_int_equal(cosc_inline_write_float32(buffer, 3, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_float32(buffer, 3, NULL), COSC_EOVERRUN);
+}
+
+static void test_uint64(void **state)
+{
+    cosc_uint64 a, b;
+    assert_int_equal(cosc_inline_read_uint64(bytes64, 8, &a), 8);
+    assert_int_equal(cosc_read_uint64(bytes64, 8, &b), 8);
+    assert_memory_equal(&a, &b, 8);
+    assert_int_equal(cosc_inline_write_uint64(buffer, 8, a), 8);
+    assert_memory_equal(buffer, bytes64, 8);
+    assert_int_equal(cosc_inline_write_uint64(NULL, 0, a), 8);
+    assert_int_equal(cosc_inline_write_uint64(buffer, 7, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_uint64(buffer, 7, NULL), COSC_EOVERRUN);
+}
+
+static void test_int64(void **state)
+{
+    cosc_int64 a, b;
+    assert_int_equal(cosc_inline_read_int64(bytes64, 8, &a), 8);
+    assert_int_equal(cosc_read_int64(bytes64, 8, &b), 8);
+    assert_memory_equal(&a, &b, 8);
+    assert_int_equal(cosc_inline_write_int64(buffer, 8, a), 8);
+    assert_memory_equal(buffer, bytes64, 8);
+    assert_int_equal(cosc_inline_write_int64(buffer, 7, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_int64(buffer, 7, NULL), COSC_EOVERRUN);
+}
+
+static void test_float64(void **state)
+{
+    cosc_float64 a, b;
+    assert_int_equal(cosc_inline_read_float64(bytes64, 8, &a), 8);
+    assert_int_equal(cosc_read_float64(bytes64, 8, &b), 8);
+    assert_memory_equal(&a, &b, 8);
+    assert_int_equal(cosc_inline_write_float64(buffer, 8, a), 8);
+    assert_memory_equal(buffer, bytes64, 8);
+    assert_int_equal(cosc_inline_write_float64(buffer, 7, a), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_float64(buffer, 7, NULL), COSC_EOVERRUN);
+}
+
+static void test_char(void **state)
+{
+    cosc_int32 value = 0;
+    assert_int_equal(cosc_inline_write_char(buffer, 4, 'x'), 4);
+    assert_memory_equal(buffer, "x\0\0\0", 4);
+    assert_int_equal(cosc_inline_read_char(buffer, 4, &value), 4);
+    assert_int_equal(value, 'x');
+    assert_int_equal(cosc_inline_write_char(buffer, 3, 'x'), COSC_EOVERRUN);
+    assert_int_equal(cosc_inline_read_char(buffer, 3, &value), COSC_EOVERRUN);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_store_load, func_setup),
+        cmocka_unit_test_setup(test_uint32, func_setup),
+        cmocka_unit_test_setup(test_int32, func_setup),
+        cmocka_unit_test_setup(test_float32, func_setup),
+        cmocka_unit_test_setup(test_uint64, func_setup),
+        cmocka_unit_test_setup(test_int64, func_setup),
+        cmocka_unit_test_setup(test_float64, func_setup),
+        cmocka_unit_test_setup(test_char, func_setup),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -95,6 +95,7 @@ static void test_message_psize(void **state)
         &value_count
     );
     assert_int_equal(ret, 124);
+    assert_int_equal(cosc_write_message(0, 0, &WRITE_MESSAGE, -1, 0), 124);
     cosc_int32 psize = 0;
     ret = cosc_read_message(
         buffer, sizeof(buffer),
@@ -110,11 +111,326 @@ static void test_message_psize(void **state)
     assert_string_equal(read.typetag, ",ifrcmsSbhtdTFNI");
 }
 
+struct bound
+{
+    cosc_int32 i;
+    cosc_float32 f;
+    cosc_uint32 r;
+    cosc_int32 c;
+    unsigned char m[4];
+    const char *s;
+    const char *S;
+    cosc_int32 S_length;
+    const void *b;
+    cosc_int32 b_size;
+    cosc_int64 h;
+    cosc_uint64 t;
+    cosc_float64 d;
+};
+
+static const struct cosc_binding BINDINGS[15] =
+{
+    {'i', offsetof(struct bound, i), -1},
+    {'f', offsetof(struct bound, f), -1},
+    {'r', offsetof(struct bound, r), -1},
+    {'c', offsetof(struct bound, c), -1},
+    {'m', offsetof(struct bound, m), -1},
+    {'s', offsetof(struct bound, s), -1},
+    {'S', offsetof(struct bound, S), offsetof(struct bound, S_length)},
+    {'b', offsetof(struct bound, b), offsetof(struct bound, b_size)},
+    {'h', offsetof(struct bound, h), -1},
+    {'t', offsetof(struct bound, t), -1},
+    {'d', offsetof(struct bound, d), -1},
+    {'T', 0, -1},
+    {'F', 0, -1},
+    {'N', 0, -1},
+    {'I', 0, -1},
+};
+
+static void test_message_bindings(void **state)
+{
+    char expected[128];
+    struct bound in, out;
+    const char *address = NULL;
+    cosc_int32 ret, address_n = 0, psize = 0;
+    memset(&in, 0, sizeof(in));
+    memset(&out, 0, sizeof(out));
+    in.i = WRITE_VALUES[0].i;
+    in.f = WRITE_VALUES[1].f;
+    in.r = WRITE_VALUES[2].r;
+    in.c = WRITE_VALUES[3].c;
+    memcpy(in.m, WRITE_VALUES[4].m, 4);
+    in.s = "Hello World!";
+    in.S = "Hello World!?";
+    in.S_length = 12;
+    in.b = "Hello World!";
+    in.b_size = 12;
+    in.h = WRITE_VALUES[8].h;
+    in.t = WRITE_VALUES[9].t;
+    in.d = WRITE_VALUES[10].d;
+
+    assert_int_equal(cosc_write_message(expected, sizeof(expected), &WRITE_MESSAGE, -1, NULL), 124);
+    assert_int_equal(cosc_write_message_from(NULL, 0, "/hello", 6, BINDINGS, 15, &in, -1), 124);
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, BINDINGS, 15, &in, -1), 124);
+    assert_memory_equal(buffer, expected, 124);
+
+    ret = cosc_read_message_into(buffer, sizeof(buffer), &address, &address_n, BINDINGS, 15, &out, &psize);
+    assert_int_equal(ret, 124);
+    assert_int_equal(psize, 120);
+    assert_int_equal(address_n, 6);
+    assert_string_equal(address, "/hello");
+    assert_int_equal(out.i, in.i);
+    assert_memory_equal(&out.f, &in.f, sizeof(in.f));
+    assert_int_equal(out.r, in.r);
+    assert_int_equal(out.c, in.c);
+    assert_memory_equal(out.m, in.m, 4);
+    assert_string_equal(out.s, "Hello World!");
+    assert_string_equal(out.S, "Hello World!");
+    assert_int_equal(out.S_length, 12);
+    assert_memory_equal(out.b, "Hello World!", 12);
+    assert_int_equal(out.b_size, 12);
+    assert_memory_equal(&out.h, &in.h, 8);
+    assert_memory_equal(&out.t, &in.t, 8);
+    assert_memory_equal(&out.d, &in.d, 8);
+    assert_true(out.s >= buffer && out.s < buffer + 124);
+
+    // Zero/empty values without a struct.
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, BINDINGS, 3, NULL, 0), 28);
+    assert_int_equal(cosc_read_message_into(buffer, 28, NULL, NULL, BINDINGS, 3, &out, NULL), 28);
+    assert_int_equal(out.i, 0);
+    assert_int_equal(out.r, 0);
+}
+
+static void test_message_bindings_errors(void **state)
+{
+    static const struct cosc_binding bad_type[1] = {{'[', 0, -1}};
+    static const struct cosc_binding bad_blob[1] = {{'b', 0, -1}};
+    struct bound in;
+    memset(&in, 0, sizeof(in));
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, bad_type, 1, &in, 0), COSC_ETYPE);
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, bad_blob, 1, &in, 0), COSC_EINVAL);
+    assert_int_equal(cosc_write_message_from(buffer, 20, "/hello", 6, BINDINGS, 15, &in, 0), COSC_EOVERRUN);
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, BINDINGS, 1, &in, 12), COSC_EPSIZE);
+    assert_int_equal(cosc_write_message_from(buffer, sizeof(buffer), "/hello", 6, BINDINGS, 2, &in, 0), 20);
+    assert_int_equal(cosc_read_message_into(buffer, 20, NULL, NULL, BINDINGS, 1, &in, NULL), COSC_EMSGTYPE);
+    assert_int_equal(cosc_read_message_into(buffer, 20, NULL, NULL, BINDINGS + 1, 2, &in, NULL), COSC_EMSGTYPE);
+    assert_int_equal(cosc_read_message_into(buffer, 16, NULL, NULL, BINDINGS, 2, &in, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_read_message_into(buffer, 20, NULL, NULL, BINDINGS, 2, NULL, NULL), 20);
+}
+
+static void test_message_view(void **state)
+{
+    struct cosc_message_view view;
+    struct cosc_message_arg args[4];
+    union cosc_value expected[11], value;
+    struct cosc_message read;
+    cosc_int32 psize = 0, size = 0;
+    char type = 0;
+    memset(&read, 0, sizeof(read));
+    memset(expected, 0, sizeof(expected));
+    read.values.read = expected;
+    read.values_n = 11;
+    assert_int_equal(cosc_write_message(buffer, sizeof(buffer), &WRITE_MESSAGE, -1, NULL), 124);
+    assert_int_equal(cosc_read_message(buffer, sizeof(buffer), &read, &psize, NULL, false), 124);
+
+    assert_int_equal(cosc_message_view_setup(&view, buffer, sizeof(buffer), args, 4, &psize), 32);
+    assert_int_equal(psize, 120);
+    assert_string_equal(view.address, "/hello");
+    assert_string_equal(view.typetag, ",ifrcmsSbhtdTFNI");
+    assert_int_equal(view.count, 4);
+    for (cosc_int32 i = 10; i >= 0; i--)
+    {
+        memset(&value, 0, sizeof(value));
+        assert_true(cosc_message_view_get(&view, i, &type, &value) > 0);
+        assert_int_equal(type, ",ifrcmsSbhtd"[i + 1]);
+        assert_memory_equal(&value, expected + i, sizeof(value));
+    }
+    assert_int_equal(cosc_message_view_get(&view, 0, NULL, &value), 4);
+    assert_int_equal(value.i, 0x12345678);
+    assert_int_equal(cosc_message_view_get(&view, 11, NULL, NULL), COSC_EINVAL);
+    assert_int_equal(cosc_message_view_get(&view, -1, NULL, NULL), COSC_EINVAL);
+    assert_int_equal(cosc_message_view_count(&view, &size), 11);
+    assert_int_equal(size, 92);
+
+    assert_int_equal(cosc_message_view_setup(&view, buffer + 4, 120, NULL, 0, NULL), 28);
+    assert_int_equal(cosc_message_view_get(&view, 9, &type, NULL), 8);
+    assert_int_equal(type, 't');
+    assert_int_equal(cosc_message_view_get(&view, 5, &type, NULL), 16);
+    assert_int_equal(type, 's');
+
+    assert_int_equal(cosc_message_view_setup(&view, buffer + 4, 60, args, 4, NULL), 28);
+    assert_int_equal(cosc_message_view_get(&view, 3, NULL, NULL), 4);
+    assert_int_equal(cosc_message_view_get(&view, 9, NULL, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_message_view_count(&view, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_message_view_setup(&view, buffer + 4, 16, args, 4, NULL), COSC_EOVERRUN);
+}
+
+#ifndef COSC_NOARRAY
+
+static void test_message_view_array(void **state)
+{
+    static const char *typetags[2] = {",s[f]", ",s[fs]"};
+    union cosc_value values[9];
+    struct cosc_message message;
+    struct cosc_message_view view;
+    struct cosc_message_arg args[2];
+    union cosc_value value;
+    char type = 0;
+    cosc_int32 size;
+    memset(values, 0, sizeof(values));
+    values[0].s.s = "Hello World!";
+    values[0].s.length = COSC_SIZE_MAX;
+    for (cosc_int32 i = 1; i < 9; i++)
+        values[i].f = (cosc_float32)i;
+    memset(&message, 0, sizeof(message));
+    message.address = "/array";
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetags[0];
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = 9;
+    size = cosc_write_message(buffer, sizeof(buffer), &message, 0, NULL);
+    assert_int_equal(size, 8 + 8 + 16 + 32);
+    assert_int_equal(cosc_message_view_setup(&view, buffer, size, args, 2, NULL), 16);
+    assert_int_equal(cosc_message_view_get(&view, 7, &type, &value), 4);
+    assert_int_equal(type, 'f');
+    assert_memory_equal(&value.f, &values[7].f, sizeof(value.f));
+    assert_int_equal(cosc_message_view_get(&view, 2, &type, &value), 4);
+    assert_memory_equal(&value.f, &values[2].f, sizeof(value.f));
+    assert_int_equal(cosc_message_view_get(&view, 9, NULL, NULL), COSC_EINVAL);
+    assert_int_equal(cosc_message_view_count(&view, NULL), 9);
+
+    for (cosc_int32 i = 2; i < 9; i += 2)
+        values[i].s = values[0].s;
+    message.typetag = typetags[1];
+    size = cosc_write_message(buffer, sizeof(buffer), &message, 0, NULL);
+    assert_true(size > 0);
+    assert_int_equal(cosc_message_view_setup(&view, buffer, size, args, 2, NULL), 16);
+    assert_int_equal(cosc_message_view_count(&view, NULL), 9);
+    assert_int_equal(cosc_message_view_get(&view, 6, &type, &value), 16);
+    assert_int_equal(type, 's');
+    assert_string_equal(value.s.s, "Hello World!");
+    assert_int_equal(cosc_message_view_get(&view, 7, &type, &value), 4);
+    assert_int_equal(type, 'f');
+    assert_memory_equal(&value.f, &values[7].f, sizeof(value.f));
+}
+
+#endif /* !COSC_NOARRAY */
+
+static cosc_int32 write_edit_expected(void *dst, const char *address, const char *typetag, const union cosc_value *values, cosc_int32 values_n, cosc_int32 psize)
+{
+    struct cosc_message message;
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = typetag;
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = values;
+    message.values_n = values_n;
+    return cosc_write_message(dst, 512, &message, psize, NULL);
+}
+
+static void test_message_edit(void **state)
+{
+    static char expected[512];
+    union cosc_value values[3];
+    struct cosc_message_edit edit;
+    cosc_int32 size, ret;
+    memset(values, 0, sizeof(values));
+    values[0].i = 60;
+    values[1].s.s = "Hello World!";
+    values[1].s.length = COSC_SIZE_MAX;
+    values[2].i = 7;
+    size = write_edit_expected(buffer + 512, "/synth/1/note", ",isN", values, 2, 0);
+    assert_int_equal(size, 16 + 8 + 4 + 16);
+
+    // Copy as is.
+    assert_int_equal(cosc_edit_message(NULL, 0, buffer + 512, size, NULL, 0), size);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, NULL, 0), size);
+    assert_memory_equal(buffer, buffer + 512, size);
+
+    // Replace the address prefix.
+    memset(&edit, 0, sizeof(edit));
+    edit.address_strip = 6;
+    edit.address_prefix = "/proxy/synth";
+    edit.address_prefix_n = COSC_SIZE_MAX;
+    ret = write_edit_expected(expected, "/proxy/synth/1/note", ",isN", values, 2, 0);
+    assert_int_equal(cosc_edit_message(NULL, 0, buffer + 512, size, &edit, 0), ret);
+    assert_int_equal(cosc_edit_message(buffer, ret - 1, buffer + 512, size, &edit, 0), COSC_EOVERRUN);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), ret);
+    assert_memory_equal(buffer, expected, ret);
+
+    // Strip the prefix, remove the last two types and append one.
+    edit.address_prefix = NULL;
+    edit.remove = 2;
+    edit.types = "i";
+    edit.types_n = 1;
+    edit.values = values + 2;
+    edit.values_n = 1;
+    values[1] = values[2];
+    ret = write_edit_expected(expected, "/1/note", ",ii", values, 2, -1);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, -1), ret);
+    assert_memory_equal(buffer, expected, ret);
+
+    // The same edits in place, with and without a packet size.
+    memcpy(buffer + 4, buffer + 512, size);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 4, size, &edit, -1), ret);
+    assert_memory_equal(buffer, expected, ret);
+    memcpy(buffer, buffer + 512, size);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer, size, &edit, 0), ret - 4);
+    assert_memory_equal(buffer, expected + 4, ret - 4);
+    memcpy(buffer, buffer + 512, size);
+    edit.address_strip = 0;
+    edit.address_prefix = "/a/much/longer/prefix";
+    edit.remove = 0;
+    edit.types = "ss";
+    edit.types_n = COSC_SIZE_MAX;
+    edit.values = values;
+    edit.values_n = 0;
+    memset(values, 0, sizeof(values));
+    values[0].i = 60;
+    values[1].s.s = "Hello World!";
+    values[1].s.length = COSC_SIZE_MAX;
+    ret = write_edit_expected(expected, "/a/much/longer/prefix/synth/1/note", ",isNss", values, 2, -1);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer, size, &edit, 16), COSC_EPSIZE);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer, size, &edit, ret - 4), ret);
+    assert_memory_equal(buffer, expected, ret);
+}
+
+static void test_message_edit_errors(void **state)
+{
+    struct cosc_message_edit edit;
+    cosc_int32 size = write_edit_expected(buffer + 512, "/a", ",i", NULL, 0, 0);
+    assert_int_equal(size, 12);
+    memset(&edit, 0, sizeof(edit));
+    edit.address_strip = 3;
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), COSC_EINVAL);
+    edit.address_strip = 0;
+    edit.remove = 2;
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), COSC_EINVAL);
+    edit.remove = 1;
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), 8);
+    edit.types = "[i]";
+    edit.types_n = COSC_SIZE_MAX;
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), COSC_ETYPE);
+    edit.types = "x";
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, size, &edit, 0), COSC_ETYPE);
+    assert_int_equal(cosc_edit_message(buffer, sizeof(buffer), buffer + 512, 4, &edit, 0), COSC_EOVERRUN);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup(test_message_nopsize, func_setup),
         cmocka_unit_test_setup(test_message_psize, func_setup),
+        cmocka_unit_test_setup(test_message_bindings, func_setup),
+        cmocka_unit_test_setup(test_message_bindings_errors, func_setup),
+        cmocka_unit_test_setup(test_message_view, func_setup),
+        cmocka_unit_test_setup(test_message_edit, func_setup),
+        cmocka_unit_test_setup(test_message_edit_errors, func_setup),
+#ifndef COSC_NOARRAY
+        cmocka_unit_test_setup(test_message_view_array, func_setup),
+#endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
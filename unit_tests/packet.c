@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc.h"
+
+static unsigned char buffer[4096];
+
+static int func_setup(void **state)
+{
+    memset(buffer, 0, sizeof(buffer));
+    return 0;
+}
+
+static cosc_int32 write_message(unsigned char *p, const char *address, cosc_int32 psize)
+{
+    static const char *values[] = {"Hello World!"};
+    union cosc_value v[2];
+    struct cosc_message message;
+    memset(v, 0, sizeof(v));
+    v[0].i = 1;
+    v[1].s.s = values[0];
+    v[1].s.length = COSC_SIZE_MAX;
+    memset(&message, 0, sizeof(message));
+    message.address = address;
+    message.address_n = COSC_SIZE_MAX;
+    message.typetag = ",isN";
+    message.typetag_n = COSC_SIZE_MAX;
+    message.values.write = v;
+    message.values_n = 2;
+    return cosc_write_message(p, 1024, &message, psize, NULL);
+}
+
+/*
+ * Two elements per bundle, a message and a bundle nested one level
+ * deeper, with a message at the bottom.
+ */
+static cosc_int32 write_nested(unsigned char *p, cosc_int32 depth, cosc_int32 psize)
+{
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    cosc_int32 req;
+    if (depth == 0)
+        return write_message(p, "/bottom", psize);
+    req = cosc_write_bundle(p, 1024, timetag, psize);
+    req += write_message(p + req, "/element", -1);
+    req += write_nested(p + req, depth - 1, -1);
+    if (psize)
+        cosc_write_int32(p, 4, req - 4);
+    return req;
+}
+
+static void test_message(void **state)
+{
+    struct cosc_packet_stats stats;
+    cosc_int32 size = write_message(buffer, "/hello", 0);
+    assert_int_equal(size, 36);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, &stats), size);
+    assert_int_equal(stats.bundles, 0);
+    assert_int_equal(stats.messages, 1);
+    assert_int_equal(stats.values, 2);
+    assert_int_equal(stats.depth, 0);
+    assert_int_equal(stats.message_size_max, 36);
+    assert_int_equal(cosc_packet_validate(buffer, size, COSC_PACKET_ADDRESS, NULL), size);
+    assert_int_equal(cosc_packet_validate(buffer, size - 4, 0, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_packet_validate(buffer, size + 4, 0, NULL), COSC_EPSIZE);
+    assert_true(cosc_packet_validate(buffer, size, COSC_PACKET_PSIZE, NULL) < 0);
+
+    size = write_message(buffer, "/hello", -1);
+    assert_int_equal(cosc_packet_validate(buffer, size, COSC_PACKET_PSIZE, NULL), size);
+    assert_int_equal(cosc_packet_validate(buffer, sizeof(buffer), COSC_PACKET_PSIZE, NULL), size);
+    assert_int_equal(cosc_packet_validate(buffer, size - 4, COSC_PACKET_PSIZE, NULL), COSC_EOVERRUN);
+
+    size = write_message(buffer, "/hel*", 0);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), size);
+    assert_int_equal(cosc_packet_validate(buffer, size, COSC_PACKET_ADDRESS, NULL), COSC_EINVAL);
+    buffer[9] = '[';
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_ETYPE);
+}
+
+static void test_bundle(void **state)
+{
+    struct cosc_packet_stats stats;
+    cosc_int32 size = write_nested(buffer, 3, 0);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, &stats), size);
+    assert_int_equal(stats.bundles, 3);
+    assert_int_equal(stats.messages, 4);
+    assert_int_equal(stats.values, 8);
+    assert_int_equal(stats.depth, 3);
+    assert_int_equal(stats.message_size_max, 40);
+
+    size = write_nested(buffer, 2, -1);
+    assert_int_equal(cosc_packet_validate(buffer, size, COSC_PACKET_PSIZE, &stats), size);
+    assert_int_equal(stats.depth, 2);
+
+    // Empty bundles are fine.
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    assert_int_equal(cosc_write_bundle(buffer, sizeof(buffer), timetag, 0), 16);
+    assert_int_equal(cosc_packet_validate(buffer, 16, 0, &stats), 16);
+    assert_int_equal(stats.bundles, 1);
+    assert_int_equal(stats.messages, 0);
+}
+
+static void test_bundle_errors(void **state)
+{
+    struct cosc_packet_stats stats;
+    cosc_int32 size = write_nested(buffer, 1, 0);
+    assert_int_equal(size, 16 + 44 + 40);
+
+    // Element size too large, unaligned, negative and too small.
+    cosc_write_int32(buffer + 16, 4, 44);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_EPSIZE);
+    cosc_write_int32(buffer + 16, 4, 200);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_EOVERRUN);
+    cosc_write_int32(buffer + 16, 4, 38);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_EPSIZE);
+    cosc_write_int32(buffer + 16, 4, -4);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_EPSIZE);
+    cosc_write_int32(buffer + 16, 4, 36);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_EOVERRUN);
+    cosc_write_int32(buffer + 16, 4, 40);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), size);
+
+    // Truncated after the first element.
+    assert_int_equal(cosc_packet_validate(buffer, size - 2 * 4, 0, &stats), COSC_EOVERRUN);
+    assert_int_equal(stats.messages, 1);
+    assert_int_equal(cosc_packet_validate(buffer, 12, 0, NULL), COSC_EOVERRUN);
+
+    memcpy(buffer, "#bungle", 8);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, NULL), COSC_ETYPE);
+}
+
+static void test_depth(void **state)
+{
+    struct cosc_packet_stats stats;
+    cosc_int32 size = write_nested(buffer, COSC_PACKET_DEPTH_MAX, 0);
+    assert_true(size > 0 && size <= (cosc_int32)sizeof(buffer));
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, &stats), size);
+    assert_int_equal(stats.depth, COSC_PACKET_DEPTH_MAX);
+    size = write_nested(buffer, COSC_PACKET_DEPTH_MAX + 1, 0);
+    assert_int_equal(cosc_packet_validate(buffer, size, 0, &stats), COSC_ELEVELMAX);
+    assert_int_equal(stats.depth, COSC_PACKET_DEPTH_MAX);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_message, func_setup),
+        cmocka_unit_test_setup(test_bundle, func_setup),
+        cmocka_unit_test_setup(test_bundle_errors, func_setup),
+        cmocka_unit_test_setup(test_depth, func_setup),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
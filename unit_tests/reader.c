@@ -294,6 +294,28 @@ static void test_message_array(void **state)
 }
 #endif
 
+#ifndef COSC_NOARRAY
+static void test_message_array_bulk(void **state)
+{
+    cosc_int32 i = 0;
+    cosc_float32 values[30];
+    cosc_reader_setup(&reader, message_array, sizeof(message_array), levels, level_max, COSC_SERIAL_PSIZE);
+    assert_int_equal(cosc_reader_start_message(&reader, 0, 0, 0, 0), 16);
+    assert_int_equal(cosc_reader_float32_array(&reader, values, 1), COSC_EMSGTYPE);
+    assert_int_equal(cosc_reader_int32_array(&reader, &i, 1), 4);
+    assert_int_equal(i, 10);
+    assert_int_equal(cosc_reader_float32_array(&reader, values, 30), 120);
+    assert_int_equal(cosc_serial_get_size(&reader), 140);
+    cosc_float32 one;
+    cosc_read_float32(message_array + 20, 4, &one);
+    for (i = 0; i < 30; i++)
+        assert_memory_equal(values + i, &one, sizeof(one));
+    assert_int_equal(cosc_reader_float32_array(&reader, NULL, 3), 12);
+    assert_int_equal(cosc_reader_float32_array(&reader, values, 3), COSC_EOVERRUN);
+    assert_int_equal(cosc_serial_get_msgtype(&reader), ']');
+}
+#endif
+
 static void test_message_unfinished_noarray(void **state)
 {
     cosc_reader_setup(&reader, message_noarray, sizeof(message_noarray), levels, level_max, COSC_SERIAL_PSIZE);
@@ -313,6 +335,200 @@ static void test_message_unfinished_noarray(void **state)
 // }
 // #endif
 
+static const unsigned char stream_bytes[88] = {
+    0x00, 0x00, 0x00, 0x0c,  '/',  'a', 0x00, 0x00,
+     ',',  'i', 0x00, 0x00, 0x00, 0x00, 0x00,  '*',
+    0x00, 0x00, 0x00,  'D',  '#',  'b',  'u',  'n',
+     'd',  'l',  'e', 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0c,
+     '/',  'b', 0x00, 0x00,  ',',  'i', 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x20,
+     '#',  'b',  'u',  'n',  'd',  'l',  'e', 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x0c,  '/',  'c', 0x00, 0x00,
+     ',',  'i', 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+};
+
+static void test_stream_chunks(void **state)
+{
+    static const cosc_int32 types[7] = {
+        COSC_EVENT_MESSAGE, COSC_EVENT_BUNDLE_START, COSC_EVENT_MESSAGE,
+        COSC_EVENT_BUNDLE_START, COSC_EVENT_MESSAGE, COSC_EVENT_BUNDLE_END,
+        COSC_EVENT_BUNDLE_END,
+    };
+    static const cosc_int32 event_levels[7] = {0, 0, 1, 1, 2, 1, 0};
+    static const cosc_int32 offsets[7] = {4, 0, 40, 0, 76, 0, 0};
+    unsigned char tail[16];
+    struct cosc_stream stream;
+    struct cosc_stream_event event;
+    for (cosc_int32 chunk = 1; chunk <= (cosc_int32)sizeof(stream_bytes); chunk++)
+    {
+        cosc_int32 count = 0;
+        cosc_stream_setup(&stream, tail, sizeof(tail), levels, level_max);
+        for (cosc_int32 offset = 0; offset < (cosc_int32)sizeof(stream_bytes); offset += chunk)
+        {
+            cosc_int32 n = sizeof(stream_bytes) - offset;
+            assert_int_equal(cosc_stream_feed(&stream, stream_bytes + offset, n < chunk ? n : chunk), 0);
+            cosc_int32 ret;
+            while ((ret = cosc_stream_next(&stream, &event)) > 0)
+            {
+                assert_true(count < 7);
+                assert_int_equal(ret, types[count]);
+                assert_int_equal(event.level, event_levels[count]);
+                if (ret == COSC_EVENT_MESSAGE)
+                {
+                    assert_int_equal(event.size, 12);
+                    assert_memory_equal(event.data, stream_bytes + offsets[count], 12);
+                }
+                count++;
+            }
+            assert_int_equal(ret, 0);
+        }
+        assert_int_equal(count, 7);
+    }
+    cosc_stream_setup(&stream, tail, sizeof(tail), levels, level_max);
+    assert_int_equal(cosc_stream_feed(&stream, stream_bytes, sizeof(stream_bytes)), 0);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EVENT_MESSAGE);
+    assert_true(event.data == stream_bytes + 4);
+    assert_int_equal(cosc_stream_feed(&stream, stream_bytes, sizeof(stream_bytes)), COSC_EINVAL);
+}
+
+static void test_stream_errors(void **state)
+{
+    static const unsigned char bad_psize[8] = {0x00, 0x00, 0x00, 0x06, '/', 'a', 0x00, 0x00};
+    unsigned char tail[16];
+    struct cosc_stream stream;
+    struct cosc_stream_event event;
+    cosc_stream_setup(&stream, tail, sizeof(tail), levels, level_max);
+    assert_int_equal(cosc_stream_feed(&stream, bad_psize, sizeof(bad_psize)), 0);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EPSIZE);
+    cosc_stream_setup(&stream, tail, 8, levels, level_max);
+    assert_int_equal(cosc_stream_feed(&stream, stream_bytes, 10), 0);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EOVERRUN);
+    cosc_stream_setup(&stream, tail, sizeof(tail), levels, 1);
+    assert_int_equal(cosc_stream_feed(&stream, stream_bytes, sizeof(stream_bytes)), 0);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EVENT_MESSAGE);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EVENT_BUNDLE_START);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_EVENT_MESSAGE);
+    assert_int_equal(cosc_stream_next(&stream, &event), COSC_ELEVELMAX);
+}
+
+/*
+ * A size prefixed bundle with timetag 1 holding a message and a
+ * bundle with timetag 2 holding a message.
+ */
+static const unsigned char index_bytes[72] = {
+    0x00, 0x00, 0x00,  'D',  '#',  'b',  'u',  'n',
+     'd',  'l',  'e', 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0c,
+     '/',  'b', 0x00, 0x00,  ',',  'i', 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x20,
+     '#',  'b',  'u',  'n',  'd',  'l',  'e', 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x00, 0x00, 0x00, 0x0c,  '/',  'c', 0x00, 0x00,
+     ',',  'i', 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+};
+
+static void test_bundle_index(void **state)
+{
+    struct cosc_bundle_element elements[4];
+    cosc_uint64 timetag;
+    const unsigned char *bundle = index_bytes;
+    assert_int_equal(cosc_bundle_index(bundle, 72, 0, 0, 0, 1), 2);
+    assert_int_equal(cosc_bundle_index(bundle, 72, elements, 4, &timetag, 1), 2);
+#ifndef COSC_NOINT64
+    assert_true(timetag == 1);
+    assert_true(elements[0].timetag == 1);
+    assert_true(elements[1].timetag == 2);
+#endif
+    assert_int_equal(elements[0].offset, 24);
+    assert_int_equal(elements[0].size, 12);
+    assert_int_equal(elements[0].type, COSC_LEVEL_TYPE_MESSAGE);
+    assert_int_equal(elements[1].offset, 40);
+    assert_int_equal(elements[1].size, 32);
+    assert_int_equal(elements[1].type, COSC_LEVEL_TYPE_BUNDLE);
+    assert_int_equal(cosc_bundle_index(bundle + elements[1].offset, elements[1].size, elements, 1, 0, 0), 1);
+    assert_int_equal(elements[0].offset, 20);
+    assert_int_equal(elements[0].type, COSC_LEVEL_TYPE_MESSAGE);
+    assert_int_equal(cosc_bundle_index(bundle, 71, elements, 4, 0, 1), COSC_EOVERRUN);
+    assert_int_equal(cosc_bundle_index(bundle + 4, 60, elements, 4, 0, 0), COSC_EOVERRUN);
+    assert_int_equal(cosc_bundle_index(stream_bytes, 88, elements, 4, 0, 0), COSC_ETYPE);
+}
+
+struct walk_record
+{
+    cosc_int32 count;
+    cosc_int32 stop;
+    cosc_int32 types[8];
+    cosc_int32 levels[8];
+    const void *data[8];
+    cosc_int32 sizes[8];
+};
+
+static cosc_int32 walk_callback(const struct cosc_stream_event *event, void *context)
+{
+    struct walk_record *record = (struct walk_record *)context;
+    if (record->count < 8)
+    {
+        record->types[record->count] = event->type;
+        record->levels[record->count] = event->level;
+        record->data[record->count] = event->data;
+        record->sizes[record->count] = event->size;
+    }
+    record->count++;
+    return record->count == record->stop ? -100 : 0;
+}
+
+static void test_walk(void **state)
+{
+    static const cosc_int32 types[6] = {
+        COSC_EVENT_BUNDLE_START, COSC_EVENT_MESSAGE, COSC_EVENT_BUNDLE_START,
+        COSC_EVENT_MESSAGE, COSC_EVENT_BUNDLE_END, COSC_EVENT_BUNDLE_END,
+    };
+    static const cosc_int32 event_levels[6] = {0, 1, 1, 2, 1, 0};
+    const unsigned char *bundle = stream_bytes + 16;
+    struct walk_record record;
+
+    memset(&record, 0, sizeof(record));
+    assert_int_equal(cosc_walk(stream_bytes, sizeof(stream_bytes), levels, level_max, COSC_SERIAL_PSIZE, walk_callback, &record), 16);
+    assert_int_equal(record.count, 1);
+    assert_int_equal(record.types[0], COSC_EVENT_MESSAGE);
+    assert_int_equal(record.levels[0], 0);
+    assert_true(record.data[0] == stream_bytes + 4);
+    assert_int_equal(record.sizes[0], 12);
+
+    memset(&record, 0, sizeof(record));
+    assert_int_equal(cosc_walk(bundle, 72, levels, level_max, COSC_SERIAL_PSIZE, walk_callback, &record), 72);
+    assert_int_equal(record.count, 6);
+    for (cosc_int32 i = 0; i < 6; i++)
+    {
+        assert_int_equal(record.types[i], types[i]);
+        assert_int_equal(record.levels[i], event_levels[i]);
+    }
+    assert_true(record.data[1] == bundle + 24);
+    assert_int_equal(record.sizes[1], 12);
+    assert_true(record.data[3] == bundle + 60);
+    assert_int_equal(record.sizes[3], 12);
+
+    memset(&record, 0, sizeof(record));
+    assert_int_equal(cosc_walk(bundle + 4, 68, levels, level_max, 0, walk_callback, &record), 68);
+    assert_int_equal(record.count, 6);
+    assert_int_equal(cosc_walk(bundle + 4, 68, levels, level_max, 0, NULL, NULL), 68);
+
+    memset(&record, 0, sizeof(record));
+    record.stop = 3;
+    assert_int_equal(cosc_walk(bundle, 72, levels, level_max, COSC_SERIAL_PSIZE, walk_callback, &record), -100);
+    assert_int_equal(record.count, 3);
+
+    memset(&record, 0, sizeof(record));
+    assert_int_equal(cosc_walk(bundle, 72, levels, 1, COSC_SERIAL_PSIZE, walk_callback, &record), COSC_ELEVELMAX);
+    assert_int_equal(record.count, 2);
+    assert_int_equal(cosc_walk(bundle, 71, levels, level_max, COSC_SERIAL_PSIZE, NULL, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_walk(bundle + 4, 64, levels, level_max, 0, NULL, NULL), COSC_EPSIZE);
+    assert_int_equal(cosc_walk(bundle + 4, 4, levels, level_max, 0, NULL, NULL), COSC_EOVERRUN);
+    assert_int_equal(cosc_walk(stream_bytes + 1, 20, levels, level_max, COSC_SERIAL_PSIZE, NULL, NULL), COSC_EPSIZE);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -323,8 +539,13 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_bundle_empty_messages_noprefix, func_setup, func_teardown),
         cmocka_unit_test_setup_teardown(test_message_noarray, func_setup, func_teardown),
         cmocka_unit_test_setup_teardown(test_message_unfinished_noarray, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_stream_chunks, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_stream_errors, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_bundle_index, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_walk, func_setup, func_teardown),
 #ifndef COSC_NOARRAY
         cmocka_unit_test_setup_teardown(test_message_array, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_message_array_bulk, func_setup, func_teardown),
         // cmocka_unit_test_setup_teardown(test_message_unfinished_array, func_setup, func_teardown),
 #endif
     };
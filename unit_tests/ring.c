@@ -0,0 +1,251 @@
+#ifdef COSC_TEST_PTHREAD
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc.h"
+
+#ifdef COSC_TEST_PTHREAD
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef COSC_NORING
+
+static union
+{
+    double align;
+    unsigned char bytes[256];
+} storage;
+
+static struct cosc_ring ring;
+
+static int setup(void **state)
+{
+    return cosc_ring_setup(&ring, storage.bytes, sizeof(storage.bytes));
+}
+
+static void test_ring_order(void **state)
+{
+    void *data;
+    const void *out;
+    cosc_int32 a = cosc_ring_reserve(&ring, 10, &data);
+    assert_true(a >= 0);
+    memcpy(data, "aaaaaaaaaa", 10);
+    cosc_int32 b = cosc_ring_reserve(&ring, 4, &data);
+    assert_true(b >= 0);
+    memcpy(data, "bbbb", 4);
+    assert_int_equal(cosc_ring_peek(&ring, &out), 0);
+    assert_int_equal(cosc_ring_commit(&ring, b, 4), 0);
+    assert_int_equal(cosc_ring_peek(&ring, &out), 0);
+    assert_int_equal(cosc_ring_commit(&ring, a, 7), 0);
+    assert_int_equal(cosc_ring_peek(&ring, &out), 7);
+    assert_memory_equal(out, "aaaaaaa", 7);
+    assert_int_equal(cosc_ring_release(&ring), 7);
+    assert_int_equal(cosc_ring_peek(&ring, &out), 4);
+    assert_memory_equal(out, "bbbb", 4);
+    assert_int_equal(cosc_ring_release(&ring), 4);
+    assert_int_equal(cosc_ring_peek(&ring, &out), 0);
+    assert_int_equal(cosc_ring_release(&ring), 0);
+}
+
+static void test_ring_wrap(void **state)
+{
+    void *data;
+    const void *out;
+    for (int i = 0; i < 100; i++)
+    {
+        cosc_int32 size = 1 + (i * 37) % 100;
+        cosc_int32 slot = cosc_ring_reserve(&ring, size, &data);
+        assert_true(slot >= 0);
+        assert_true((unsigned char *)data + size <= storage.bytes + sizeof(storage.bytes));
+        memset(data, i, size);
+        assert_int_equal(cosc_ring_commit(&ring, slot, i % 7 ? size : 0), 0);
+        if (i % 7)
+        {
+            assert_int_equal(cosc_ring_peek(&ring, &out), size);
+            assert_int_equal(((const unsigned char *)out)[0], i);
+            assert_int_equal(((const unsigned char *)out)[size - 1], i);
+            assert_int_equal(cosc_ring_release(&ring), size);
+        }
+        assert_int_equal(cosc_ring_peek(&ring, &out), 0);
+    }
+}
+
+static void test_ring_full(void **state)
+{
+    void *data;
+    cosc_int32 slots[8];
+    for (int i = 0; i < 4; i++)
+    {
+        slots[i] = cosc_ring_reserve(&ring, 56, &data);
+        assert_true(slots[i] >= 0);
+    }
+    assert_int_equal(cosc_ring_reserve(&ring, 1, &data), COSC_EOVERRUN);
+    assert_int_equal(cosc_ring_commit(&ring, slots[0], 57), COSC_EINVAL);
+    assert_int_equal(cosc_ring_commit(&ring, slots[0], 56), 0);
+    assert_int_equal(cosc_ring_release(&ring), 56);
+    assert_true(cosc_ring_reserve(&ring, 56, &data) >= 0);
+    assert_int_equal(cosc_ring_reserve(&ring, 121, &data), COSC_ESIZEMAX);
+    assert_int_equal(cosc_ring_reserve(&ring, -1, &data), COSC_EINVAL);
+    assert_int_equal(cosc_ring_setup(&ring, storage.bytes, 100), COSC_EINVAL);
+}
+
+static void test_ring_align(void **state)
+{
+    assert_int_equal(cosc_ring_setup(&ring, storage.bytes + 1, 128), COSC_EINVAL);
+    assert_int_equal(cosc_ring_setup(&ring, storage.bytes + 4, 128), COSC_EINVAL);
+    assert_int_equal(cosc_ring_setup(&ring, storage.bytes + 8, 128), 0);
+    assert_int_equal(cosc_ring_setup(&ring, 0, 128), COSC_EINVAL);
+}
+
+#ifdef COSC_TEST_PTHREAD
+
+#define PRODUCERS 4
+#define PACKETS 5000
+
+static union
+{
+    double align;
+    unsigned char bytes[4096];
+} thread_storage;
+
+static struct cosc_ring thread_ring;
+
+static cosc_int32 packet_size(int id, int seq)
+{
+    return 8 + (id * 13 + seq * 7) % 120;
+}
+
+static unsigned char packet_byte(int id, int seq, int i)
+{
+    return (unsigned char)(id * 31 + seq + i);
+}
+
+static void *producer(void *arg)
+{
+    int id = (int)(size_t)arg;
+    int cancel = 0;
+    for (int seq = 0; seq < PACKETS; seq++)
+    {
+        cosc_int32 size = packet_size(id, seq);
+        unsigned char *data;
+        cosc_int32 slot;
+        while ((slot = cosc_ring_reserve(&thread_ring, size, (void **)&data)) == COSC_EOVERRUN)
+            sched_yield();
+        if (slot < 0)
+            return arg;
+        if (seq % 10 == 9 && !cancel)
+        {
+            /* Cancel and reserve again. */
+            cosc_ring_commit(&thread_ring, slot, 0);
+            cancel = 1;
+            seq--;
+            continue;
+        }
+        cancel = 0;
+        memcpy(data, &id, sizeof(int));
+        memcpy(data + sizeof(int), &seq, sizeof(int));
+        for (int i = 2 * sizeof(int); i < size; i++)
+            data[i] = packet_byte(id, seq, i);
+        cosc_ring_commit(&thread_ring, slot, size);
+    }
+    return 0;
+}
+
+static void test_ring_threads(void **state)
+{
+    pthread_t threads[PRODUCERS];
+    int next[PRODUCERS] = {0};
+    assert_int_equal(cosc_ring_setup(&thread_ring, thread_storage.bytes, sizeof(thread_storage.bytes)), 0);
+    for (int i = 0; i < PRODUCERS; i++)
+        assert_int_equal(pthread_create(threads + i, 0, producer, (void *)(size_t)i), 0);
+    for (int received = 0; received < PRODUCERS * PACKETS;)
+    {
+        const unsigned char *data;
+        cosc_int32 size = cosc_ring_peek(&thread_ring, (const void **)&data);
+        if (size == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        int id, seq;
+        memcpy(&id, data, sizeof(int));
+        memcpy(&seq, data + sizeof(int), sizeof(int));
+        assert_true(id >= 0 && id < PRODUCERS);
+        assert_int_equal(seq, next[id]);
+        assert_int_equal(size, packet_size(id, seq));
+        for (int i = 2 * sizeof(int); i < size; i++)
+            assert_int_equal(data[i], packet_byte(id, seq, i));
+        assert_int_equal(cosc_ring_release(&thread_ring), size);
+        next[id]++;
+        received++;
+    }
+    for (int i = 0; i < PRODUCERS; i++)
+    {
+        void *ret;
+        assert_int_equal(pthread_join(threads[i], &ret), 0);
+        assert_true(ret == 0);
+        assert_int_equal(next[i], PACKETS);
+    }
+    assert_int_equal(cosc_ring_peek(&thread_ring, 0), 0);
+}
+
+#endif /* COSC_TEST_PTHREAD */
+
+#if !defined(COSC_NOWRITER) && !defined(COSC_NOREADER)
+static void test_ring_serial(void **state)
+{
+    struct cosc_serial serial;
+    struct cosc_level levels[2];
+    const char *address, *typetag;
+    cosc_int32 address_n, typetag_n, value;
+    cosc_int32 slot = cosc_ring_writer_setup(&ring, &serial, 64, levels, 2, 0);
+    assert_true(slot >= 0);
+    assert_int_equal(cosc_writer_start_message(&serial, "/ring", 1024, ",i", 1024), 12);
+    assert_int_equal(cosc_ring_writer_commit(&ring, &serial, slot), COSC_ELEVELTYPE);
+    assert_int_equal(cosc_writer_int32(&serial, 42), 4);
+    assert_int_equal(cosc_writer_end_message(&serial), 0);
+    assert_int_equal(cosc_ring_writer_commit(&ring, &serial, slot), 16);
+    assert_int_equal(cosc_ring_reader_setup(&ring, &serial, levels, 2, 0), 16);
+    assert_int_equal(cosc_reader_start_message(&serial, &address, &address_n, &typetag, &typetag_n), 12);
+    assert_string_equal(address, "/ring");
+    assert_int_equal(cosc_reader_int32(&serial, &value), 4);
+    assert_int_equal(value, 42);
+    assert_int_equal(cosc_ring_release(&ring), 16);
+    assert_int_equal(cosc_ring_reader_setup(&ring, &serial, levels, 2, 0), 0);
+}
+#endif
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_ring_order, setup),
+        cmocka_unit_test_setup(test_ring_wrap, setup),
+        cmocka_unit_test_setup(test_ring_full, setup),
+        cmocka_unit_test(test_ring_align),
+#ifdef COSC_TEST_PTHREAD
+        cmocka_unit_test(test_ring_threads),
+#endif
+#if !defined(COSC_NOWRITER) && !defined(COSC_NOREADER)
+        cmocka_unit_test_setup(test_ring_serial, setup),
+#endif
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#else /* !COSC_NORING */
+#include <stdio.h>
+int main(void)
+{
+    printf("Built without ring support, skipping test.\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,180 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include "cosc.h"
+
+#ifndef COSC_NOSCHEDULER
+
+static struct cosc_scheduler scheduler;
+static struct cosc_scheduled entries[64];
+static unsigned char buffer[256];
+
+static cosc_uint64 make_timetag(cosc_uint32 seconds, cosc_uint32 fraction)
+{
+#ifdef COSC_NOINT64
+    cosc_uint64 timetag = COSC_64BITS_INIT(seconds, fraction);
+    return timetag;
+#else
+    return ((cosc_uint64)seconds << 32) | fraction;
+#endif
+}
+
+static cosc_uint32 timetag_seconds(cosc_uint64 timetag)
+{
+#ifdef COSC_NOINT64
+    return COSC_64BITS_HI(&timetag);
+#else
+    return (cosc_uint32)(timetag >> 32);
+#endif
+}
+
+static int func_setup(void **state)
+{
+    memset(buffer, 0, sizeof(buffer));
+    assert_int_equal(cosc_scheduler_setup(&scheduler, entries, 64), 0);
+    return 0;
+}
+
+static void test_setup(void **state)
+{
+    struct cosc_scheduler tmp;
+    assert_int_equal(cosc_scheduler_setup(&tmp, 0, 1), COSC_EINVAL);
+    assert_int_equal(cosc_scheduler_setup(&tmp, entries, 0), COSC_EINVAL);
+    assert_int_equal(cosc_scheduler_setup(&tmp, entries, 1), 0);
+    assert_int_equal(cosc_scheduler_peek(&tmp, 0), 0);
+    assert_int_equal(cosc_scheduler_pop(&tmp, make_timetag(0xffffffff, 0xffffffff), 0), 0);
+    assert_int_equal(cosc_scheduler_add(&tmp, make_timetag(1, 0), buffer, -1), COSC_EINVAL);
+    assert_int_equal(cosc_scheduler_add(&tmp, make_timetag(1, 0), buffer, 0), 1);
+    assert_int_equal(cosc_scheduler_add(&tmp, make_timetag(1, 0), buffer, 0), COSC_EOVERRUN);
+}
+
+static void test_order(void **state)
+{
+    struct cosc_scheduled entry;
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(20, 0), buffer + 0, 1), 1);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(10, 5), buffer + 1, 1), 2);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(10, 5), buffer + 2, 1), 3);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(0, 1), buffer + 3, 1), 4);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(0, 0), buffer + 4, 1), 5);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(0, 1), buffer + 5, 1), 6);
+
+    assert_int_equal(cosc_scheduler_peek(&scheduler, &entry), 6);
+    assert_true(entry.packet == buffer + 3);
+
+    // Immediately is due before anything else, even at time zero.
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(0, 0), &entry), 1);
+    assert_true(entry.packet == buffer + 3);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(0, 0), &entry), 1);
+    assert_true(entry.packet == buffer + 5);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(0, 0), &entry), 1);
+    assert_true(entry.packet == buffer + 4);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(10, 4), &entry), 0);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(10, 5), &entry), 1);
+    assert_true(entry.packet == buffer + 1);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(10, 5), &entry), 1);
+    assert_true(entry.packet == buffer + 2);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(19, 0xffffffff), &entry), 0);
+    assert_int_equal(cosc_scheduler_peek(&scheduler, 0), 1);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(30, 0), 0), 1);
+    assert_int_equal(cosc_scheduler_peek(&scheduler, &entry), 0);
+}
+
+static void test_heap(void **state)
+{
+    struct cosc_scheduled entry;
+    cosc_uint32 last_seconds = 0, last_seq = 0;
+    srand(1234);
+    for (cosc_int32 i = 0; i < 64; i++)
+        assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(2 + rand() % 16, 0), buffer, i), i + 1);
+    for (cosc_int32 i = 0; i < 64; i++)
+    {
+        assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(100, 0), &entry), 1);
+        cosc_uint32 seconds = timetag_seconds(entry.timetag);
+        assert_true(seconds >= last_seconds);
+        if (i > 0 && seconds == last_seconds)
+            assert_true(entry.seq > last_seq);
+        assert_int_equal(entry.size, (cosc_int32)entry.seq);
+        last_seconds = seconds;
+        last_seq = entry.seq;
+    }
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(100, 0), &entry), 0);
+}
+
+static void test_push(void **state)
+{
+    struct cosc_scheduled entry;
+    cosc_int32 bundle_size = cosc_write_bundle(buffer, sizeof(buffer), make_timetag(5, 0), 0);
+    cosc_int32 message_size = cosc_write_message(buffer + 64, 64, 0, 0, 0);
+    cosc_int32 psize_size = cosc_write_bundle(buffer + 128, 64, make_timetag(3, 0), -1);
+    assert_int_equal(bundle_size, 16);
+    assert_int_equal(message_size, 8);
+    assert_int_equal(psize_size, 20);
+
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer, bundle_size, 0), 1);
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer + 64, message_size, 0), 2);
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer + 128, psize_size, COSC_PACKET_PSIZE), 3);
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer, bundle_size - 4, 0), COSC_EOVERRUN);
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer, -1, 0), COSC_EINVAL);
+
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(0, 0), &entry), 1);
+    assert_true(entry.packet == buffer + 64);
+    assert_int_equal(entry.size, message_size);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(2, 0), &entry), 0);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(4, 0), &entry), 1);
+    assert_true(entry.packet == buffer + 128);
+    assert_int_equal(timetag_seconds(entry.timetag), 3);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(4, 0), &entry), 0);
+    assert_int_equal(cosc_scheduler_pop(&scheduler, make_timetag(5, 0), &entry), 1);
+    assert_true(entry.packet == buffer);
+
+    memcpy(buffer, "#bungle", 8);
+    assert_int_equal(cosc_scheduler_push(&scheduler, buffer, bundle_size, 0), COSC_ETYPE);
+}
+
+#ifndef COSC_NOTIMETAG
+static void test_wait(void **state)
+{
+    cosc_uint32 seconds = 1234, nanos = 1234;
+    assert_int_equal(cosc_scheduler_wait(&scheduler, make_timetag(0, 0), &seconds, &nanos), 0);
+    assert_int_equal(seconds, 1234);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(10, 0x80000000), buffer, 0), 1);
+    assert_int_equal(cosc_scheduler_wait(&scheduler, make_timetag(8, 0xc0000000), &seconds, &nanos), 1);
+    assert_int_equal(seconds, 1);
+    assert_int_equal(nanos, 750000000);
+    assert_int_equal(cosc_scheduler_wait(&scheduler, make_timetag(11, 0), &seconds, &nanos), 1);
+    assert_int_equal(seconds, 0);
+    assert_int_equal(nanos, 0);
+    assert_int_equal(cosc_scheduler_add(&scheduler, make_timetag(0, 1), buffer, 0), 2);
+    assert_int_equal(cosc_scheduler_wait(&scheduler, make_timetag(0, 0), &seconds, &nanos), 1);
+    assert_int_equal(seconds, 0);
+    assert_int_equal(nanos, 0);
+}
+#endif
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_setup, func_setup),
+        cmocka_unit_test_setup(test_order, func_setup),
+        cmocka_unit_test_setup(test_heap, func_setup),
+        cmocka_unit_test_setup(test_push, func_setup),
+#ifndef COSC_NOTIMETAG
+        cmocka_unit_test_setup(test_wait, func_setup),
+#endif
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
+
+#else
+#include <stdio.h>
+int main(void)
+{
+    printf("Built without scheduler support, skipping test.\n");
+    return 0;
+}
+#endif
@@ -121,11 +121,123 @@ static void test_time_to_timetag(void **state)
 #endif
 }
 
+static cosc_uint64 make_u64(cosc_uint32 hi, cosc_uint32 lo)
+{
+#ifdef COSC_NOINT64
+    cosc_uint64 value;
+    COSC_64BITS_SET(&value, hi, lo);
+    return value;
+#else
+    return ((cosc_uint64)hi << 32) | lo;
+#endif
+}
+
+static cosc_int64 make_i64(cosc_uint32 hi, cosc_uint32 lo)
+{
+#ifdef COSC_NOINT64
+    cosc_int64 value;
+    COSC_64BITS_SET(&value, hi, lo);
+    return value;
+#else
+    return (cosc_int64)(((cosc_uint64)hi << 32) | lo);
+#endif
+}
+
+static void assert_64(const void *value, cosc_uint32 hi, cosc_uint32 lo)
+{
+#ifdef COSC_NOINT64
+    const struct cosc_64bits *bits = (const struct cosc_64bits *)value;
+    assert_int_equal(COSC_64BITS_HI(bits), hi);
+    assert_int_equal(COSC_64BITS_LO(bits), lo);
+#else
+    cosc_uint64 bits;
+    memcpy(&bits, value, sizeof(bits));
+    assert_int_equal(bits >> 32, hi);
+    assert_int_equal(bits & 0xffffffff, lo);
+#endif
+}
+
+static void test_timetag_add(void **state)
+{
+    cosc_uint64 timetag;
+
+    timetag = cosc_timetag_add(make_u64(10, 0), make_i64(0, 500000000));
+    assert_64(&timetag, 10, 0x80000000);
+    timetag = cosc_timetag_add(make_u64(10, 0), make_i64(0xffffffff, (cosc_uint32)-1500000000));
+    assert_64(&timetag, 8, 0x80000000);
+    timetag = cosc_timetag_sub(make_u64(10, 0), make_i64(0, 1500000000));
+    assert_64(&timetag, 8, 0x80000000);
+    timetag = cosc_timetag_sub(make_u64(10, 0), make_i64(0xffffffff, (cosc_uint32)-250000000));
+    assert_64(&timetag, 10, 0x40000000);
+    timetag = cosc_timetag_add(make_u64(10, 0), make_i64(0, 1));
+    assert_64(&timetag, 10, 4);
+    timetag = cosc_timetag_add(make_u64(0, 0), make_i64(0, 0));
+    assert_64(&timetag, 0, 0);
+
+    // 2^32 seconds later is the same point in the next era.
+    timetag = cosc_timetag_add(make_u64(5, 7), make_i64(1000000000, 0));
+    assert_64(&timetag, 5, 7);
+
+    // Wrap around the era rollover in both directions.
+    timetag = cosc_timetag_sub(make_u64(0, 0), make_i64(0, 1000000000));
+    assert_64(&timetag, 0xffffffff, 0);
+    timetag = cosc_timetag_add(make_u64(0xffffffff, 0x80000000), make_i64(0, 1000000000));
+    assert_64(&timetag, 0, 0x80000000);
+}
+
+static void test_timetag_diff(void **state)
+{
+    cosc_int64 nanos;
+
+    nanos = cosc_timetag_diff(make_u64(11, 0x80000000), make_u64(10, 0));
+    assert_64(&nanos, 0, 1500000000);
+    nanos = cosc_timetag_diff(make_u64(10, 0), make_u64(11, 0x80000000));
+    assert_64(&nanos, 0xffffffff, (cosc_uint32)-1500000000);
+    nanos = cosc_timetag_diff(make_u64(10, 4), make_u64(10, 0));
+    assert_64(&nanos, 0, 1);
+    nanos = cosc_timetag_diff(make_u64(10, 0xffffffff), make_u64(10, 0));
+    assert_64(&nanos, 0, 1000000000);
+    nanos = cosc_timetag_diff(make_u64(0, 0x80000000), make_u64(0xffffffff, 0x80000000));
+    assert_64(&nanos, 0, 1000000000);
+    nanos = cosc_timetag_diff(make_u64(0xffffffff, 0x80000000), make_u64(0, 0x80000000));
+    assert_64(&nanos, 0xffffffff, (cosc_uint32)-1000000000);
+
+    // Add and diff round-trip to the nanosecond, timetag units are finer.
+    cosc_uint64 base = make_u64(0xfffffff0, 0x12345678);
+    for (cosc_uint32 i = 0; i < 4096; i++)
+    {
+        cosc_uint32 lo = i * 2654435761U;
+        cosc_uint32 hi = i & 1 ? 0xffffff00 | (i >> 4) : i >> 4;
+        cosc_uint64 timetag = cosc_timetag_add(base, make_i64(hi, lo));
+        nanos = cosc_timetag_diff(timetag, base);
+        assert_64(&nanos, hi, lo);
+        timetag = cosc_timetag_sub(timetag, make_i64(hi, lo));
+        nanos = cosc_timetag_diff(timetag, base);
+        assert_64(&nanos, 0, 0);
+    }
+}
+
+static void test_timetag_compare(void **state)
+{
+    assert_int_equal(cosc_timetag_compare(make_u64(1, 0), make_u64(1, 0)), 0);
+    assert_true(cosc_timetag_compare(make_u64(1, 0), make_u64(2, 0)) < 0);
+    assert_true(cosc_timetag_compare(make_u64(2, 0), make_u64(1, 0)) > 0);
+    assert_true(cosc_timetag_compare(make_u64(1, 1), make_u64(1, 0)) > 0);
+    assert_true(cosc_timetag_compare(make_u64(1, 0), make_u64(0, 0xffffffff)) > 0);
+
+    // Early next era is after late this era.
+    assert_true(cosc_timetag_compare(make_u64(0, 0), make_u64(0xffffffff, 0)) > 0);
+    assert_true(cosc_timetag_compare(make_u64(0xffffffff, 0), make_u64(0, 0)) < 0);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_timetag_to_time),
         cmocka_unit_test(test_time_to_timetag),
+        cmocka_unit_test(test_timetag_add),
+        cmocka_unit_test(test_timetag_diff),
+        cmocka_unit_test(test_timetag_compare),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -148,6 +148,46 @@ static void test_typetag_match_scalar(void **state)
     assert_false(cosc_pattern_match(",I", 1024, "#", 1024));
 }
 
+
+static void test_typetag_compiled(void **state)
+{
+    static const struct { const char *s; const char *pattern; cosc_int32 match; } cases[] = {
+        {",ifsb", "ifsb", 1},
+        {",", "", 1},
+        {",ifsb", ",ifsb", 1},
+        {",", ",", 1},
+        {",ifsb", "ifsx", 0},
+        {",", "i", 0},
+        {",ifsb", ",ifsx", 0},
+#ifndef COSC_NOARRAY
+        {",ifsb[fff]", "ifsbfff", 1},
+        {",[iff]", ",iff", 1},
+        {",ifsb[fff]", "ifsb*", 1},
+        {",[iff]", "iif", 0},
+#endif
+        {",ifsb", "*i*f*s*b*", 1},
+        {",ifsb", "i*fsb", 1},
+        {",ifsb", "ifsb*i", 0},
+        {",ifsb", "if?b", 1},
+        {",ifsb", "?ifsb", 0},
+        {",ifsb", "ifs[htb]", 1},
+        {",ifsb", "ifs[hts]", 0},
+        {",ifsb", "{abcd,ifsb,abcd}", 1},
+        {",", "{abcd,,abcd}", 1},
+        {",ifsb", "i{xx,fs,xx}b", 1},
+        {",irfhtds", "######s", 1},
+        {",iTFs", "#BBs", 1},
+        {",iTFs", "#B#s", 0},
+    };
+    struct cosc_pattern_op ops[32];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        cosc_int32 ops_n = cosc_pattern_compile(ops, 32, cases[i].pattern, 1024);
+        assert_true(ops_n >= 0);
+        assert_int_equal(cosc_pattern_exec(ops, ops_n, cases[i].s, 1024), cases[i].match);
+    }
+}
+
 #endif
 
 int main(void)
@@ -161,6 +201,7 @@ int main(void)
         cmocka_unit_test(test_typetag_match_charset),
         cmocka_unit_test(test_typetag_match_stringset),
         cmocka_unit_test(test_typetag_match_scalar),
+        cmocka_unit_test(test_typetag_compiled),
 #endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
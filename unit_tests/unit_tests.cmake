@@ -34,7 +34,12 @@ set(unit_test_names
     signature
     values
     message
+    packet
+    inline
     )
+if(NOT COSC_NOPATTERN)
+    set(unit_test_names ${unit_test_names} dispatch)
+endif()
 if(NOT COSC_NOTIMETAG)
     set(unit_test_names ${unit_test_names} timetag)
 endif()
@@ -47,6 +52,17 @@ endif()
 if(NOT COSC_NOREADER)
     set(unit_test_names ${unit_test_names} reader)
 endif()
+if(NOT COSC_NORING)
+    set(unit_test_names ${unit_test_names} ring)
+endif()
+if(NOT COSC_NOSCHEDULER)
+    set(unit_test_names ${unit_test_names} scheduler)
+endif()
+if(COSC_ENABLE_CXX)
+    set(unit_test_names ${unit_test_names} cxx)
+endif()
+
+find_package(Threads)
 
 ExternalProject_Add(
     cmocka
@@ -69,7 +85,11 @@ ExternalProject_Get_Property(cmocka install_dir)
 
 function(add_unit_test unit_test_name suffix flags)
     set(executable_name unit_test_${unit_test_name}${suffix})
-    add_executable(${executable_name} ${CMAKE_CURRENT_SOURCE_DIR}/unit_tests/${unit_test_name}.c ${CMAKE_CURRENT_SOURCE_DIR}/cosc.c)
+    set(unit_test_source ${CMAKE_CURRENT_SOURCE_DIR}/unit_tests/${unit_test_name}.c)
+    if(EXISTS ${CMAKE_CURRENT_SOURCE_DIR}/unit_tests/${unit_test_name}.cpp)
+        set(unit_test_source ${CMAKE_CURRENT_SOURCE_DIR}/unit_tests/${unit_test_name}.cpp)
+    endif()
+    add_executable(${executable_name} ${unit_test_source} ${CMAKE_CURRENT_SOURCE_DIR}/cosc.c)
     set_target_properties(
         ${executable_name} PROPERTIES
         EXCLUDE_FROM_ALL TRUE
@@ -77,6 +97,10 @@ function(add_unit_test unit_test_name suffix flags)
     target_include_directories(${executable_name} PUBLIC ${install_dir}/include)
     target_compile_options(${executable_name} PUBLIC ${flags})
     target_link_libraries(${executable_name} PUBLIC ${install_dir}/lib/${CMAKE_STATIC_LIBRARY_PREFIX}cmocka-static${CMAKE_STATIC_LIBRARY_SUFFIX})
+    if(unit_test_name STREQUAL "ring" AND CMAKE_USE_PTHREADS_INIT)
+        target_compile_definitions(${executable_name} PUBLIC COSC_TEST_PTHREAD)
+        target_link_libraries(${executable_name} PUBLIC Threads::Threads)
+    endif()
     add_dependencies(${executable_name} cmocka)
     add_dependencies(unit_tests ${executable_name})
     add_test(test_${unit_test_name}${suffix} ${executable_name})
@@ -85,12 +109,16 @@ endfunction()
 foreach(unit_test_name ${unit_test_names})
     add_unit_test("${unit_test_name}" "" "")
     add_unit_test("${unit_test_name}" "_noswap" "-DCOSC_NOSWAP")
+    add_unit_test("${unit_test_name}" "_nobuiltin" "-DCOSC_NOBUILTIN")
+    add_unit_test("${unit_test_name}" "_noswar" "-DCOSC_NOSWAR")
+    add_unit_test("${unit_test_name}" "_nosimd" "-DCOSC_NOSIMD")
     add_unit_test("${unit_test_name}" "_nostdlib" "-DCOSC_NOSTDLIB")
     add_unit_test("${unit_test_name}" "_nofloat32" "-DCOSC_NOFLOAT32")
     add_unit_test("${unit_test_name}" "_nofloat64" "-DCOSC_NOFLOAT64")
     add_unit_test("${unit_test_name}" "_nofloat" "-DCOSC_NOFLOAT32 -DCOSC_NOFLOAT64")
     add_unit_test("${unit_test_name}" "_noint64" "-DCOSC_NOINT64")
     add_unit_test("${unit_test_name}" "_no64" "-DCOSC_NOINT64 -DCOSC_NOFLOAT64")
+    add_unit_test("${unit_test_name}" "_no64_nobuiltin" "-DCOSC_NOINT64 -DCOSC_NOFLOAT64 -DCOSC_NOBUILTIN")
     add_unit_test("${unit_test_name}" "_noarray" "-DCOSC_NOARRAY")
 endforeach()
 
@@ -165,16 +165,209 @@ static void test_with_array_early_exit(void **state)
     assert_int_equal(read_values[0].i, 10);
 }
 
+static void test_with_array_run(void **state)
+{
+    cosc_int32 ret;
+    cosc_int32 value_count = 0;
+    char expected[4 + 8 * 10];
+    union cosc_value read_values[11] = {0};
+    union cosc_value write_values[11];
+    write_values[0].i = 10;
+    cosc_write_int32(expected, 4, 10);
+    for (int i = 1; i < 11; i++)
+    {
+#ifdef COSC_NOFLOAT64
+        write_values[i].d = (cosc_float64)COSC_64BITS_INIT(i, i * 3);
+#else
+        write_values[i].d = i * 1.5;
 #endif
+        cosc_write_float64(expected + 4 + (i - 1) * 8, 8, write_values[i].d);
+    }
+    ret = cosc_write_values(
+        buffer, sizeof(buffer),
+        ",i[dd]", 1024,
+        write_values, 11,
+        &value_count
+    );
+    assert_int_equal(ret, sizeof(expected));
+    assert_int_equal(value_count, 11);
+    assert_memory_equal(buffer, expected, sizeof(expected));
+    ret = cosc_read_values(
+        buffer, sizeof(expected),
+        ",i[dd]", 1024,
+        read_values, 11,
+        &value_count,
+        false
+    );
+    assert_int_equal(ret, sizeof(expected));
+    assert_int_equal(value_count, 11);
+    assert_int_equal(read_values[0].i, 10);
+    for (int i = 1; i < 11; i++)
+        assert_memory_equal(&read_values[i].d, &write_values[i].d, sizeof(cosc_float64));
+}
+
+static void test_with_array_run_overrun(void **state)
+{
+    cosc_int32 ret;
+    cosc_int32 value_count = 0;
+    union cosc_value values[31] = {0};
+    ret = cosc_write_values(
+        buffer, 4 + 12 * 5,
+        ",i[fff]", 1024,
+        values, 31,
+        &value_count
+    );
+    assert_int_equal(ret, COSC_EOVERRUN);
+    assert_int_equal(value_count, 16);
+    ret = cosc_read_values(
+        buffer, 4 + 12 * 3 + 8,
+        ",i[fff]", 1024,
+        values, 31,
+        &value_count,
+        false
+    );
+    assert_int_equal(ret, COSC_EOVERRUN);
+    assert_int_equal(value_count, 12);
+}
+
+#endif
+
+static void fill_values(const char *types, union cosc_value *values, int values_n)
+{
+    int t = 0, i = 0, array_start = -1;
+    memset(values, 0, sizeof(*values) * values_n);
+    for (int steps = 0; i < values_n && types[t] && steps < 1000; steps++, t++)
+    {
+        union cosc_value *value = values + i;
+        switch (types[t])
+        {
+        case '[': array_start = t + 1; continue;
+        case ']': t = array_start - 1; continue;
+        case 'i': value->i = i * 3 - 7; break;
+        case 'r': value->r = 0x80000000 + i; break;
+#ifdef COSC_NOFLOAT32
+        case 'f': value->f = i; break;
+#else
+        case 'f': value->f = i * 0.5f; break;
+#endif
+        case 'c': value->c = 'a' + i; break;
+        case 'm': value->m[0] = i; value->m[3] = 1; break;
+#ifdef COSC_NOINT64
+        case 'h': value->h = (cosc_int64)COSC_64BITS_INIT(i, 1); break;
+        case 't': value->t = (cosc_uint64)COSC_64BITS_INIT(1, i); break;
+#else
+        case 'h': value->h = -i; break;
+        case 't': value->t = 0x100000000ULL * i; break;
+#endif
+#ifdef COSC_NOFLOAT64
+        case 'd': value->d = (cosc_float64)COSC_64BITS_INIT(i, i); break;
+#else
+        case 'd': value->d = i * 0.25; break;
+#endif
+        case 's':
+        case 'S': value->s.s = "plan"; value->s.length = 1 + i % 4; break;
+        case 'b': value->b.b = "blob"; value->b.size = i % 5; break;
+        default: continue;
+        }
+        i++;
+    }
+}
+
+static void test_typetag_plan(void **state)
+{
+    static const char *typetags[] = {
+        ",", ",i", ",ifsbhtdScrmTFNI", "fff",
+#ifndef COSC_NOARRAY
+        ",iT[bT]", ",[TF]", ",i[fff]", ",s[if]", ",[sd]", ",[hhhh]", ",ff[i]", ",[Ni]",
+#endif
+    };
+    static const cosc_int32 counts[] = {0, 1, 5, 11, 30};
+    static const cosc_int32 sizes[] = {1024, 0, 7, 40, 63};
+    static char expected[1024];
+    struct cosc_plan_field fields[32];
+    struct cosc_typetag_plan plan;
+    union cosc_value values[30], read_expected[30], read_values[30];
+    for (size_t t = 0; t < sizeof(typetags) / sizeof(*typetags); t++)
+    {
+        const char *typetag = typetags[t];
+        cosc_int32 types_n = strlen(typetag) + 1;
+        cosc_int32 n = cosc_typetag_plan_compile(0, 0, 0, typetag, types_n);
+        assert_true(n >= 0);
+        assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 32, typetag, types_n), n);
+        for (size_t c = 0; c < sizeof(counts) / sizeof(*counts); c++)
+        {
+            fill_values(typetag, values, 30);
+            cosc_int32 exp_count = -1, count = -1;
+            cosc_int32 exp_ret = cosc_write_values(0, 0, typetag, types_n, values, counts[c], &exp_count);
+            assert_int_equal(cosc_write_values_plan(0, 0, &plan, values, counts[c], &count), exp_ret);
+            assert_int_equal(count, exp_count);
+            if (plan.fixed_size >= 0 && plan.array_size >= 0)
+                assert_int_equal(cosc_typetag_plan_size(&plan, counts[c]), exp_ret);
+            for (size_t z = 0; z < sizeof(sizes) / sizeof(*sizes); z++)
+            {
+                memset(expected, 0xaa, sizeof(expected));
+                memset(buffer, 0xaa, sizeof(buffer));
+                exp_ret = cosc_write_values(expected, sizes[z], typetag, types_n, values, counts[c], &exp_count);
+                assert_int_equal(cosc_write_values_plan(buffer, sizes[z], &plan, values, counts[c], &count), exp_ret);
+                assert_int_equal(count, exp_count);
+                if (exp_ret > 0)
+                    assert_memory_equal(buffer, expected, exp_ret);
+                for (int early = 0; early < 2; early++)
+                {
+                    memset(read_expected, 0, sizeof(read_expected));
+                    memset(read_values, 0, sizeof(read_values));
+                    exp_ret = cosc_read_values(expected, sizes[z], typetag, types_n, read_expected, counts[c], &exp_count, early);
+                    assert_int_equal(cosc_read_values_plan(expected, sizes[z], &plan, read_values, counts[c], &count, early), exp_ret);
+                    assert_int_equal(count, exp_count);
+                    assert_memory_equal(read_values, read_expected, sizeof(read_values));
+                }
+            }
+        }
+    }
+}
+
+static void test_typetag_plan_compile(void **state)
+{
+    struct cosc_plan_field fields[8];
+    struct cosc_typetag_plan plan;
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",ifs", 5), 3);
+    assert_int_equal(plan.fixed_size, -1);
+    assert_int_equal(fields[0].run, 8);
+    assert_int_equal(fields[1].offset, 4);
+    assert_int_equal(fields[2].size, -1);
+    assert_int_equal(cosc_typetag_plan_size(&plan, 3), COSC_ETYPE);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",ihdT", 6), 4);
+    assert_int_equal(plan.fixed_size, 20);
+    assert_int_equal(plan.value_count, 3);
+    assert_int_equal(cosc_typetag_plan_size(&plan, 0), 20);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 2, ",ihdT", 6), COSC_EOVERRUN);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",ix", 4), COSC_ETYPE);
+#ifndef COSC_NOARRAY
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",i[ff]", 7), 3);
+    assert_int_equal(plan.array_start, 1);
+    assert_int_equal(plan.array_end, 3);
+    assert_int_equal(plan.array_size, 8);
+    assert_int_equal(cosc_typetag_plan_size(&plan, 6), 4 + 8 * 3);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",i[ff", 6), COSC_ETYPE);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",i[f[f]]", 9), COSC_ETYPE);
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",i]", 4), COSC_ETYPE);
+#else
+    assert_int_equal(cosc_typetag_plan_compile(&plan, fields, 8, ",i[ff]", 7), COSC_ETYPE);
+#endif
+}
 
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup(test_without_array, func_setup),
+        cmocka_unit_test_setup(test_typetag_plan, func_setup),
+        cmocka_unit_test_setup(test_typetag_plan_compile, func_setup),
 #ifndef COSC_NOARRAY
         cmocka_unit_test_setup(test_with_array, func_setup),
         cmocka_unit_test_setup(test_with_array_unfinished, func_setup),
         cmocka_unit_test_setup(test_with_array_early_exit, func_setup),
+        cmocka_unit_test_setup(test_with_array_run, func_setup),
+        cmocka_unit_test_setup(test_with_array_run_overrun, func_setup),
 #endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -1,3 +1,7 @@
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
@@ -8,6 +12,11 @@
 #include <stdio.h>
 #include "cosc.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 #ifndef COSC_NOWRITER
 
 static struct cosc_serial writer;
@@ -232,6 +241,73 @@ static void test_message_noarray(void **state)
     assert_int_equal(cosc_writer_end_message(&writer), COSC_ELEVELTYPE);
 }
 
+static void test_messages_batch(void **state)
+{
+    static unsigned char expected[1024];
+    static struct cosc_serial expected_writer;
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    union cosc_value values[3][2];
+    struct cosc_message messages[4];
+    cosc_int32 count = -1;
+    memset(values, 0, sizeof(values));
+    memset(messages, 0, sizeof(messages));
+    for (int i = 0; i < 3; i++)
+    {
+        values[i][0].i = i;
+        values[i][1].s.s = "abc";
+        values[i][1].s.length = COSC_SIZE_MAX;
+        messages[i].address = "/batch";
+        messages[i].address_n = COSC_SIZE_MAX;
+        messages[i].typetag = ",is";
+        messages[i].typetag_n = COSC_SIZE_MAX;
+        messages[i].values.write = values[i];
+        messages[i].values_n = 2;
+    }
+    messages[1].values_n = 1;
+    messages[2].typetag = ",isT";
+    messages[3].address = "/empty";
+    messages[3].address_n = COSC_SIZE_MAX;
+
+    cosc_writer_setup(&expected_writer, expected, sizeof(expected), levels, level_max, 0);
+    assert_int_equal(cosc_writer_start_bundle(&expected_writer, timetag), 16);
+    for (int i = 0; i < 4; i++)
+        assert_true(cosc_writer_message(&expected_writer, messages + i, 0) > 0);
+    assert_int_equal(cosc_writer_end_bundle(&expected_writer), 0);
+    cosc_int32 size = cosc_serial_get_size(&expected_writer);
+
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, 0);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 4, &count), COSC_EPSIZEFLAG);
+    assert_int_equal(count, 0);
+    assert_int_equal(cosc_writer_start_bundle(&writer, timetag), 16);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 0, &count), 0);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 4, &count), size - 16);
+    assert_int_equal(count, 4);
+    assert_int_equal(cosc_writer_end_bundle(&writer), 0);
+    assert_int_equal(cosc_serial_get_size(&writer), size);
+    assert_memory_equal(buffer, expected, size);
+
+    // A message that does not fit keeps the ones before it.
+    cosc_writer_setup(&writer, buffer, size - 4, levels, level_max, 0);
+    assert_int_equal(cosc_writer_start_bundle(&writer, timetag), 16);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 4, &count), COSC_EOVERRUN);
+    assert_int_equal(count, 3);
+    assert_int_equal(cosc_serial_get_size(&writer), size - 16);
+
+    // A single message at the top level without psize.
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, 0);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 1, &count), 20);
+    assert_int_equal(count, 1);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 1, &count), COSC_EPSIZEFLAG);
+
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, COSC_SERIAL_PSIZE);
+    messages[1].typetag = ",ix";
+    assert_int_equal(cosc_writer_messages(&writer, messages, 2, &count), COSC_ETYPE);
+    assert_int_equal(count, 1);
+    assert_int_equal(cosc_serial_get_size(&writer), 24);
+    assert_int_equal(cosc_writer_start_message(&writer, "/a", 3, ",i", 3), 12);
+    assert_int_equal(cosc_writer_messages(&writer, messages, 1, &count), COSC_ELEVELTYPE);
+}
+
 #ifndef COSC_NOARRAY
 static void test_message_array(void **state)
 {
@@ -260,6 +336,39 @@ static void test_message_array(void **state)
 }
 #endif
 
+#ifndef COSC_NOARRAY
+static void test_message_array_bulk(void **state)
+{
+    cosc_float32 values[30], output[30];
+    for (int i = 0; i < 30; i++)
+        values[i] = i;
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, COSC_SERIAL_PSIZE);
+    assert_int_equal(cosc_writer_start_message(&writer, "abc", 4, ",i[fff]", 1024), 16);
+    assert_int_equal(cosc_writer_int32(&writer, 10), 4);
+    assert_int_equal(cosc_writer_float32_array(&writer, values, 30), 120);
+    assert_int_equal(cosc_serial_get_size(&writer), 140);
+    assert_int_equal(cosc_serial_get_msgtype(&writer), ']');
+    assert_int_equal(cosc_read_float32_array(buffer + 20, 120, output, 30), 120);
+    assert_memory_equal(output, values, sizeof(values));
+    assert_int_equal(cosc_writer_float32_array(&writer, NULL, 3), 12);
+    assert_int_equal(cosc_writer_int32_array(&writer, NULL, 1), COSC_EMSGTYPE);
+    assert_int_equal(cosc_writer_end_message(&writer), 0);
+    assert_int_equal(cosc_serial_get_size(&writer), 152);
+}
+#endif
+
+static void test_message_bulk_mismatch(void **state)
+{
+    const cosc_int32 values[3] = {1, 2, 3};
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, COSC_SERIAL_PSIZE);
+    assert_int_equal(cosc_writer_start_message(&writer, "abc", 4, ",iif", 1024), 16);
+    assert_int_equal(cosc_writer_int32_array(&writer, values, 3), COSC_EMSGTYPE);
+    assert_int_equal(cosc_serial_get_size(&writer), 24);
+    assert_int_equal(cosc_serial_get_msgtype(&writer), 'f');
+    assert_int_equal(cosc_writer_float32_array(&writer, NULL, 1), 4);
+    assert_int_equal(cosc_writer_end_message(&writer), 0);
+}
+
 static void test_message_unfinished_noarray(void **state)
 {
     cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, COSC_SERIAL_PSIZE);
@@ -296,6 +405,224 @@ static void test_blob_unfinished(void **state)
     assert_int_equal(cosc_serial_get_size(&writer), 20);
 }
 
+static cosc_int32 write_iovec_packet(
+    struct cosc_serial *serial,
+    const char *text,
+    const unsigned char *data
+)
+{
+#ifndef COSC_NOINT64
+    cosc_uint64 timetag = 0x12345678;
+#else
+    cosc_uint64 timetag = COSC_64BITS_INIT(0, 0x12345678);
+#endif
+    assert_int_equal(cosc_writer_start_bundle(serial, timetag), 20);
+    assert_int_equal(cosc_writer_start_message(serial, "/a", 3, ",sibb", 6), 16);
+    assert_int_equal(cosc_writer_string(serial, text, 1024, 0), 304);
+    assert_int_equal(cosc_writer_int32(serial, 7), 4);
+    assert_int_equal(cosc_writer_blob(serial, data, 201), 208);
+    assert_int_equal(cosc_writer_start_blob(serial), 4);
+    assert_int_equal(cosc_writer_bytes(serial, "abc", 3), 3);
+    assert_int_equal(cosc_writer_bytes(serial, data, 150), 150);
+    assert_int_equal(cosc_writer_end_blob(serial), 3);
+    assert_int_equal(cosc_writer_end_message(serial), 0);
+    assert_int_equal(cosc_writer_end_bundle(serial), 0);
+    return cosc_serial_get_size(serial);
+}
+
+static void test_iovec(void **state)
+{
+    static unsigned char expected[1024], scratch[128], gathered[1024];
+    static unsigned char data[201];
+    static char text[301];
+    struct cosc_iovec iov[16];
+    for (int i = 0; i < 300; i++)
+        text[i] = 'a' + i % 26;
+    for (int i = 0; i < 201; i++)
+        data[i] = i;
+    cosc_writer_setup(&writer, expected, sizeof(expected), levels, level_max, COSC_SERIAL_PSIZE);
+    cosc_int32 size = write_iovec_packet(&writer, text, data);
+    assert_int_equal(size, 712);
+
+    cosc_writer_setup_iovec(&writer, scratch, sizeof(scratch), levels, level_max, COSC_SERIAL_PSIZE, iov, 16, 64);
+    assert_int_equal(write_iovec_packet(&writer, text, data), size);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), 7);
+    assert_true(iov[1].base == text);
+    assert_int_equal(iov[1].len, 300);
+    assert_true(iov[3].base == data);
+    assert_int_equal(iov[5].len, 150);
+    cosc_int32 offset = 0;
+    for (int i = 0; i < 7; i++)
+    {
+        memcpy(gathered + offset, iov[i].base, iov[i].len);
+        offset += iov[i].len;
+    }
+    assert_int_equal(offset, size);
+    assert_memory_equal(gathered, expected, size);
+    assert_int_equal(cosc_serial_get_buffer_size(&writer), sizeof(scratch));
+
+    cosc_serial_reset(&writer);
+    assert_int_equal(cosc_serial_get_buffer_size(&writer), sizeof(scratch));
+    assert_int_equal(write_iovec_packet(&writer, text, data), size);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), 7);
+    assert_int_equal(cosc_serial_get_buffer_size(&writer), sizeof(scratch));
+
+#if defined(__unix__) || defined(__APPLE__)
+    assert_int_equal(sizeof(struct cosc_iovec), sizeof(struct iovec));
+    assert_int_equal(offsetof(struct cosc_iovec, base), offsetof(struct iovec, iov_base));
+    assert_int_equal(offsetof(struct cosc_iovec, len), offsetof(struct iovec, iov_len));
+    int fds[2];
+    assert_int_equal(pipe(fds), 0);
+    assert_int_equal(writev(fds[1], (const struct iovec *)iov, 7), size);
+    memset(gathered, 0, sizeof(gathered));
+    assert_int_equal(read(fds[0], gathered, sizeof(gathered)), size);
+    assert_memory_equal(gathered, expected, size);
+    close(fds[0]);
+    close(fds[1]);
+#endif
+
+    cosc_serial_reset(&writer);
+    assert_int_equal(cosc_writer_start_message(&writer, "/a", 3, ",s", 3), 12);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), COSC_ELEVELTYPE);
+}
+
+static void test_iovec_copy(void **state)
+{
+    static unsigned char expected[1024], gathered[1024];
+    static unsigned char data[201];
+    static char text[301];
+    struct cosc_iovec iov[4];
+    for (int i = 0; i < 300; i++)
+        text[i] = 'A' + i % 26;
+    for (int i = 0; i < 201; i++)
+        data[i] = 255 - i;
+    cosc_writer_setup(&writer, expected, sizeof(expected), levels, level_max, COSC_SERIAL_PSIZE);
+    cosc_int32 size = write_iovec_packet(&writer, text, data);
+
+    cosc_writer_setup_iovec(&writer, buffer, sizeof(buffer), levels, level_max, COSC_SERIAL_PSIZE, iov, 4, 64);
+    assert_int_equal(write_iovec_packet(&writer, text, data), size);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), 3);
+    assert_true(iov[1].base == text);
+    memcpy(gathered, iov[0].base, iov[0].len);
+    memcpy(gathered + iov[0].len, iov[1].base, iov[1].len);
+    memcpy(gathered + iov[0].len + iov[1].len, iov[2].base, iov[2].len);
+    assert_int_equal(iov[0].len + iov[1].len + iov[2].len, size);
+    assert_memory_equal(gathered, expected, size);
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, 0);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), COSC_EINVAL);
+}
+
+static cosc_int32 write_measure_packet(
+    struct cosc_serial *serial
+)
+{
+    static const cosc_int32 ints[5] = {1, 2, 3, 4, 5};
+    cosc_uint64 timetag = COSC_INT64_INIT_ZERO;
+    union cosc_value values[2];
+    struct cosc_message messages[2];
+    memset(values, 0, sizeof(values));
+    memset(messages, 0, sizeof(messages));
+    values[0].i = 1;
+    values[1].s.s = "Hello World!";
+    values[1].s.length = COSC_SIZE_MAX;
+    messages[0].address = "/message";
+    messages[0].address_n = COSC_SIZE_MAX;
+    messages[0].typetag = ",is";
+    messages[0].typetag_n = COSC_SIZE_MAX;
+    messages[0].values.write = values;
+    messages[0].values_n = 2;
+    messages[1] = messages[0];
+    messages[1].values_n = 1;
+    assert_true(cosc_writer_start_bundle(serial, timetag) > 0);
+    // The typetag is cut short by typetag_n.
+    assert_true(cosc_writer_start_message(serial, "/values", COSC_SIZE_MAX, ",iiisbT", 6) > 0);
+    assert_int_equal(cosc_serial_get_msgtype(serial), 'i');
+    assert_int_equal(cosc_writer_int32_array(serial, ints, 2), 8);
+    assert_int_equal(cosc_serial_get_msgtype(serial), 'i');
+    assert_int_equal(cosc_writer_float32(serial, 1), COSC_EMSGTYPE);
+    assert_int_equal(cosc_writer_int32(serial, 3), 4);
+    assert_int_equal(cosc_writer_string(serial, "abcde", COSC_SIZE_MAX, 0), 8);
+    assert_int_equal(cosc_serial_get_msgtype(serial), 'b');
+    assert_int_equal(cosc_writer_start_blob(serial), 4);
+    assert_int_equal(cosc_writer_bytes(serial, "abcde", 5), 5);
+    assert_int_equal(cosc_writer_end_blob(serial), 3);
+    assert_int_equal(cosc_serial_get_msgtype(serial), 0);
+    assert_int_equal(cosc_writer_end_message(serial), 0);
+    assert_true(cosc_writer_message(serial, messages, 0) > 0);
+#ifndef COSC_NOARRAY
+    assert_true(cosc_writer_start_message(serial, "/array", COSC_SIZE_MAX, ",s[i]", COSC_SIZE_MAX) > 0);
+    assert_int_equal(cosc_writer_string(serial, "", COSC_SIZE_MAX, 0), 4);
+    assert_int_equal(cosc_writer_int32_array(serial, ints, 5), 20);
+    assert_int_equal(cosc_writer_end_message(serial), 0);
+#endif
+    assert_true(cosc_writer_start_message(serial, "/skipped", COSC_SIZE_MAX, ",ihs", COSC_SIZE_MAX) > 0);
+    assert_int_equal(cosc_writer_end_message(serial), 16);
+    assert_true(cosc_writer_messages(serial, messages, 2, 0) > 0);
+    assert_int_equal(cosc_writer_end_bundle(serial), 0);
+    return cosc_serial_get_size(serial);
+}
+
+static void test_measure(void **state)
+{
+    static unsigned char data[201];
+    static char text[301];
+    for (int i = 0; i < 300; i++)
+        text[i] = 'a' + i % 26;
+    cosc_measure_setup(&writer, levels, level_max, COSC_SERIAL_PSIZE);
+    assert_true(COSC_SERIAL_ISWRITER(&writer));
+    assert_false(COSC_SERIAL_ISREADER(&writer));
+    assert_int_equal(write_iovec_packet(&writer, text, data), 712);
+
+    memset(buffer, 0, sizeof(buffer));
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, 0);
+    cosc_int32 size = write_measure_packet(&writer);
+    assert_true(size > 0);
+    cosc_measure_setup(&writer, levels, level_max, 0);
+    assert_int_equal(write_measure_packet(&writer), size);
+    assert_int_equal(cosc_serial_get_size(&writer), size);
+
+    // An exactly sized buffer is enough.
+    cosc_writer_setup(&writer, buffer, size, levels, level_max, 0);
+    assert_int_equal(write_measure_packet(&writer), size);
+
+    cosc_measure_setup(&writer, levels, level_max, 0);
+    assert_true(cosc_writer_start_message(&writer, "/a", COSC_SIZE_MAX, ",i", COSC_SIZE_MAX) > 0);
+    assert_int_equal(cosc_writer_end_message(&writer), 4);
+    assert_int_equal(cosc_serial_get_size(&writer), 12);
+    assert_int_equal(cosc_writer_start_message(&writer, "/a", COSC_SIZE_MAX, ",i", COSC_SIZE_MAX), COSC_EPSIZEFLAG);
+    assert_int_equal(cosc_writer_finish_iovec(&writer), COSC_EINVAL);
+}
+
+static cosc_int32 write_nested_packet(
+    struct cosc_serial *serial
+)
+{
+    assert_true(cosc_writer_start_message(serial, "/outer", COSC_SIZE_MAX, ",bi", COSC_SIZE_MAX) > 0);
+    assert_int_equal(cosc_writer_start_blob(serial), 4);
+    assert_true(cosc_writer_start_message(serial, "/inner", COSC_SIZE_MAX, ",s", COSC_SIZE_MAX) > 0);
+    assert_int_equal(cosc_writer_string(serial, "abc", COSC_SIZE_MAX, 0), 4);
+    assert_int_equal(cosc_writer_end_message(serial), 0);
+    assert_int_equal(cosc_writer_end_blob(serial), 0);
+    assert_int_equal(cosc_serial_get_msgtype(serial), 'i');
+    assert_int_equal(cosc_writer_int32(serial, 1), 4);
+    assert_int_equal(cosc_writer_end_message(serial), 0);
+    return cosc_serial_get_size(serial);
+}
+
+/*
+ * A message in a blob has its own typetag, the outer message must
+ * continue with its own when the blob ends.
+ */
+static void test_measure_nested(void **state)
+{
+    cosc_writer_setup(&writer, buffer, sizeof(buffer), levels, level_max, 0);
+    cosc_int32 size = write_nested_packet(&writer);
+    assert_int_equal(size, 40);
+    cosc_measure_setup(&writer, levels, level_max, 0);
+    assert_int_equal(write_nested_packet(&writer), size);
+}
+
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -308,9 +635,16 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_message_noarray, func_setup, func_teardown),
         cmocka_unit_test_setup_teardown(test_message_unfinished_noarray, func_setup, func_teardown),
         cmocka_unit_test_setup_teardown(test_blob_unfinished, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_message_bulk_mismatch, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_messages_batch, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_iovec, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_iovec_copy, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_measure, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_measure_nested, func_setup, func_teardown),
 #ifndef COSC_NOARRAY
         cmocka_unit_test_setup_teardown(test_message_array, func_setup, func_teardown),
         cmocka_unit_test_setup_teardown(test_message_unfinished_array, func_setup, func_teardown),
+        cmocka_unit_test_setup_teardown(test_message_array_bulk, func_setup, func_teardown),
 #endif
     };
     return cmocka_run_group_tests(tests, NULL, NULL);